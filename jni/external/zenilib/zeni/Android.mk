@@ -14,7 +14,10 @@ LOCAL_SRC_FILES := \
   Colors.cpp \
   Coordinate.cpp \
   File_Ops.cpp \
+  Frustum.cpp \
   Matrix4f.cpp \
+  Pool.cpp \
+  Profiler.cpp \
   Quaternion.cpp \
   Quit_Event.cpp \
   Random.cpp \
@@ -19,6 +19,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <vector>
 
 #include <Zeni/Define.h>
 
@@ -253,6 +257,147 @@ namespace Zeni {
     /* End Helpers and Templates
      */
 
+    Statistics::Counter Statistics::get_total() const {
+      Counter total;
+
+      for(int lhs = 0; lhs != ZENI_PRIMITIVE_COUNT; ++lhs)
+        for(int rhs = 0; rhs != ZENI_PRIMITIVE_COUNT; ++rhs)
+          for(int query = 0; query != ZENI_QUERY_COUNT; ++query) {
+            total.calls += m_counters[lhs][rhs][query].calls;
+            total.seconds += m_counters[lhs][rhs][query].seconds;
+          }
+
+      return total;
+    }
+
+    void Statistics::record(const PRIMITIVE &lhs, const PRIMITIVE &rhs, const QUERY &query, const double &seconds) {
+      Counter &counter = m_counters[lhs][rhs][query];
+      ++counter.calls;
+      counter.seconds += seconds;
+    }
+
+    void Statistics::clear() {
+      *this = Statistics();
+    }
+
+    struct Statistics_Entry {
+      PRIMITIVE lhs;
+      PRIMITIVE rhs;
+      Statistics::QUERY query;
+      Statistics::Counter counter;
+
+      bool operator<(const Statistics_Entry &rhs_) const {
+        return counter.seconds > rhs_.counter.seconds;
+      }
+    };
+
+    static std::vector<Statistics_Entry> nonzero_entries(const Statistics &statistics) {
+      std::vector<Statistics_Entry> entries;
+
+      for(int lhs = 0; lhs != ZENI_PRIMITIVE_COUNT; ++lhs)
+        for(int rhs = 0; rhs != ZENI_PRIMITIVE_COUNT; ++rhs)
+          for(int query = 0; query != Statistics::ZENI_QUERY_COUNT; ++query) {
+            Statistics_Entry entry;
+            entry.lhs = PRIMITIVE(lhs);
+            entry.rhs = PRIMITIVE(rhs);
+            entry.query = Statistics::QUERY(query);
+            entry.counter = statistics.get(entry.lhs, entry.rhs, entry.query);
+
+            if(entry.counter.calls)
+              entries.push_back(entry);
+          }
+
+      return entries;
+    }
+
+    String Statistics::to_string() const {
+      std::vector<Statistics_Entry> entries = nonzero_entries(*this);
+      std::stable_sort(entries.begin(), entries.end());
+
+      const Counter total = get_total();
+
+      std::ostringstream oss;
+      oss << std::fixed << std::setprecision(3)
+          << "Collision: " << total.calls << " queries, " << 1000.0 * total.seconds << " ms";
+
+      for(std::vector<Statistics_Entry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+        oss << '\n' << get_name(it->lhs) << " x " << get_name(it->rhs) << ' ' << get_name(it->query)
+            << ": " << it->counter.calls << " calls, " << 1000.0 * it->counter.seconds << " ms";
+
+      return oss.str().c_str();
+    }
+
+    void Statistics::write_csv(std::ostream &os, const bool &header) const {
+      const std::vector<Statistics_Entry> entries = nonzero_entries(*this);
+
+      if(header)
+        os << "lhs,rhs,query,calls,seconds\n";
+
+      const std::streamsize precision = os.precision(9);
+
+      for(std::vector<Statistics_Entry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+        os << get_name(it->lhs) << ',' << get_name(it->rhs) << ',' << get_name(it->query) << ','
+           << it->counter.calls << ',' << it->counter.seconds << '\n';
+
+      os.precision(precision);
+    }
+
+    const char * Statistics::get_name(const PRIMITIVE &primitive) {
+      static const char * const names[ZENI_PRIMITIVE_COUNT] = {
+        "Point3f", "Sphere", "Plane", "Line", "Ray", "Line_Segment",
+        "Infinite_Cylinder", "Capsule", "Parallelepiped"};
+
+      return names[primitive];
+    }
+
+    const char * Statistics::get_name(const QUERY &query) {
+      static const char * const names[ZENI_QUERY_COUNT] = {
+        "shortest_distance", "nearest_point", "intersects"};
+
+      return names[query];
+    }
+
+    static Statistics & get_last_frame_Statistics() {
+      static Statistics statistics;
+      return statistics;
+    }
+
+    Statistics & Statistics::get_current() {
+      static Statistics statistics;
+      return statistics;
+    }
+
+    const Statistics & Statistics::get_last_frame() {
+      return get_last_frame_Statistics();
+    }
+
+    void Statistics::end_frame() {
+      Statistics &current = get_current();
+      get_last_frame_Statistics() = current;
+      current.clear();
+    }
+
+#ifdef ENABLE_COLLISION_STATISTICS
+    static int g_collision_query_depth = 0;
+
+    Query_Timer::Query_Timer(const PRIMITIVE &lhs, const PRIMITIVE &rhs, const Statistics::QUERY &query)
+      : m_lhs(lhs),
+      m_rhs(rhs),
+      m_query(query),
+      m_outermost(!g_collision_query_depth++),
+      m_start(HQ_Tick_Type(), HQ_Tick_Type(1))
+    {
+      if(m_outermost)
+        m_start = Time_HQ();
+    }
+
+    Query_Timer::~Query_Timer() {
+      if(m_outermost)
+        Statistics::get_current().record(m_lhs, m_rhs, m_query, double(m_start.get_seconds_passed()));
+      --g_collision_query_depth;
+    }
+#endif
+
     Sphere::Sphere(const Point3f &center_, const float &radius_)
       : center(center_),
       radius(radius_)
@@ -260,9 +405,11 @@ namespace Zeni {
     }
 
     float Sphere::shortest_distance(const Sphere &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_SPHERE, ZENI_SPHERE, ZENI_SHORTEST_DISTANCE);
       return unpoof((center - rhs.center).magnitude(), radius + rhs.radius);
     }
     float Sphere::shortest_distance(const Point3f &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_SPHERE, ZENI_POINT, ZENI_SHORTEST_DISTANCE);
       return unpoof((center - rhs).magnitude(), radius);
     }
 
@@ -273,6 +420,7 @@ namespace Zeni {
     }
 
     float Plane::shortest_distance(const Plane &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_PLANE, ZENI_PLANE, ZENI_SHORTEST_DISTANCE);
       const Vector3f line_normal = normal % rhs.normal;
       if(line_normal.magnitude() < ZENI_COLLISION_EPSILON)
         return shortest_distance(rhs.point);
@@ -281,10 +429,12 @@ namespace Zeni {
     }
 
     float Plane::shortest_distance(const Point3f &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_PLANE, ZENI_POINT, ZENI_SHORTEST_DISTANCE);
       return float(fabs((point - rhs) * normal));
     }
 
     float Plane::shortest_distance(const Sphere &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_PLANE, ZENI_SPHERE, ZENI_SHORTEST_DISTANCE);
       return unpoof(shortest_distance(rhs.get_center()), rhs.get_radius());
     }
 
@@ -305,21 +455,27 @@ namespace Zeni {
     }
 
     float Line::shortest_distance(const Point3f &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE, ZENI_POINT, ZENI_SHORTEST_DISTANCE);
       return Collision::nearest_point(*this, rhs).first;
     }
     float Line::shortest_distance(const Sphere &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE, ZENI_SPHERE, ZENI_SHORTEST_DISTANCE);
       return unpoof(shortest_distance(rhs.get_center()), rhs.get_radius());
     }
     float Line::shortest_distance(const Plane &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE, ZENI_PLANE, ZENI_SHORTEST_DISTANCE);
       return Collision::nearest_point(*this, rhs).first;
     }
     float Line::shortest_distance(const Line &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE, ZENI_LINE, ZENI_SHORTEST_DISTANCE);
       return Collision::nearest_point(*this, rhs).first;
     }
     float Line::shortest_distance(const Line_Segment &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE, ZENI_LINE_SEGMENT, ZENI_SHORTEST_DISTANCE);
       return Collision::nearest_point(*this, rhs).first;
     }
     float Line::shortest_distance(const Parallelepiped &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE, ZENI_PARALLELEPIPED, ZENI_SHORTEST_DISTANCE);
       return Collision::nearest_point(*this, rhs).first;
     }
 
@@ -340,24 +496,31 @@ namespace Zeni {
     }
 
     std::pair<float, float> Ray::nearest_point(const Point3f &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_RAY, ZENI_POINT, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
     std::pair<float, float> Ray::nearest_point(const Sphere &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_RAY, ZENI_SPHERE, ZENI_NEAREST_POINT);
       return unpoof(nearest_point(rhs.get_center()), rhs.get_radius());
     }
     std::pair<float, float> Ray::nearest_point(const Plane &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_RAY, ZENI_PLANE, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
     std::pair<float, float> Ray::nearest_point(const Line &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_RAY, ZENI_LINE, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
     std::pair<float, float> Ray::nearest_point(const Ray &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_RAY, ZENI_RAY, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
     std::pair<float, float> Ray::nearest_point(const Line_Segment &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_RAY, ZENI_LINE_SEGMENT, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
     std::pair<float, float> Ray::nearest_point(const Parallelepiped &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_RAY, ZENI_PARALLELEPIPED, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
 
@@ -370,24 +533,31 @@ namespace Zeni {
     }
 
     std::pair<float, float> Line_Segment::nearest_point(const Point3f &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE_SEGMENT, ZENI_POINT, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
     std::pair<float, float> Line_Segment::nearest_point(const Sphere &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE_SEGMENT, ZENI_SPHERE, ZENI_NEAREST_POINT);
       return unpoof(nearest_point(rhs.get_center()), rhs.get_radius());
     }
     std::pair<float, float> Line_Segment::nearest_point(const Plane &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE_SEGMENT, ZENI_PLANE, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
     std::pair<float, float> Line_Segment::nearest_point(const Line &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE_SEGMENT, ZENI_LINE, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
     std::pair<float, float> Line_Segment::nearest_point(const Ray &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE_SEGMENT, ZENI_RAY, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
     std::pair<float, float> Line_Segment::nearest_point(const Line_Segment &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE_SEGMENT, ZENI_LINE_SEGMENT, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
     std::pair<float, float> Line_Segment::nearest_point(const Parallelepiped &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE_SEGMENT, ZENI_PARALLELEPIPED, ZENI_NEAREST_POINT);
       return Collision::nearest_point(*this, rhs);
     }
 
@@ -406,24 +576,31 @@ namespace Zeni {
     }
 
     float Infinite_Cylinder::shortest_distance(const Point3f &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_INFINITE_CYLINDER, ZENI_POINT, ZENI_SHORTEST_DISTANCE);
       return unpoof(line.shortest_distance(rhs), radius);
     }
     float Infinite_Cylinder::shortest_distance(const Sphere &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_INFINITE_CYLINDER, ZENI_SPHERE, ZENI_SHORTEST_DISTANCE);
       return unpoof(line.shortest_distance(rhs), radius);
     }
     float Infinite_Cylinder::shortest_distance(const Plane &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_INFINITE_CYLINDER, ZENI_PLANE, ZENI_SHORTEST_DISTANCE);
       return unpoof(line.shortest_distance(rhs), radius);
     }
     float Infinite_Cylinder::shortest_distance(const Infinite_Cylinder &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_INFINITE_CYLINDER, ZENI_INFINITE_CYLINDER, ZENI_SHORTEST_DISTANCE);
       return unpoof(line.shortest_distance(rhs.line), radius + rhs.radius);
     }
     float Infinite_Cylinder::shortest_distance(const Line &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_INFINITE_CYLINDER, ZENI_LINE, ZENI_SHORTEST_DISTANCE);
       return unpoof(line.shortest_distance(rhs), radius);
     }
     float Infinite_Cylinder::shortest_distance(const Ray &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_INFINITE_CYLINDER, ZENI_RAY, ZENI_SHORTEST_DISTANCE);
       return unpoof(line.shortest_distance(rhs), radius);
     }
     float Infinite_Cylinder::shortest_distance(const Line_Segment &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_INFINITE_CYLINDER, ZENI_LINE_SEGMENT, ZENI_SHORTEST_DISTANCE);
       return unpoof(line.shortest_distance(rhs), radius);
     }
 
@@ -435,30 +612,39 @@ namespace Zeni {
     }
 
     std::pair<float, float> Capsule::nearest_point(const Point3f &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_CAPSULE, ZENI_POINT, ZENI_NEAREST_POINT);
       return unpoof(line_segment.nearest_point(rhs), radius);
     }
     std::pair<float, float> Capsule::nearest_point(const Sphere &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_CAPSULE, ZENI_SPHERE, ZENI_NEAREST_POINT);
       return unpoof(line_segment.nearest_point(rhs), radius);
     }
     std::pair<float, float> Capsule::nearest_point(const Plane &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_CAPSULE, ZENI_PLANE, ZENI_NEAREST_POINT);
       return unpoof(line_segment.nearest_point(rhs), radius);
     }
     std::pair<float, float> Capsule::nearest_point(const Line &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_CAPSULE, ZENI_LINE, ZENI_NEAREST_POINT);
       return unpoof(line_segment.nearest_point(rhs), radius);
     }
     std::pair<float, float> Capsule::nearest_point(const Ray &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_CAPSULE, ZENI_RAY, ZENI_NEAREST_POINT);
       return unpoof(line_segment.nearest_point(rhs), radius);
     }
     std::pair<float, float> Capsule::nearest_point(const Line_Segment &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_CAPSULE, ZENI_LINE_SEGMENT, ZENI_NEAREST_POINT);
       return unpoof(line_segment.nearest_point(rhs), radius);
     }
     std::pair<float, float> Capsule::nearest_point(const Infinite_Cylinder &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_CAPSULE, ZENI_INFINITE_CYLINDER, ZENI_NEAREST_POINT);
       return unpoof(line_segment.nearest_point(reinterpret_cast<const Line_Segment &>(rhs)), radius + rhs.get_radius());
     }
     std::pair<float, float> Capsule::nearest_point(const Capsule &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_CAPSULE, ZENI_CAPSULE, ZENI_NEAREST_POINT);
       return unpoof(line_segment.nearest_point(rhs.line_segment), radius + rhs.radius);
     }
     std::pair<float, float> Capsule::nearest_point(const Parallelepiped &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_CAPSULE, ZENI_PARALLELEPIPED, ZENI_NEAREST_POINT);
       return unpoof(line_segment.nearest_point(rhs), radius);
     }
     
@@ -493,6 +679,7 @@ namespace Zeni {
     }
 
     float Parallelepiped::shortest_distance(const Parallelepiped &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_PARALLELEPIPED, ZENI_PARALLELEPIPED, ZENI_SHORTEST_DISTANCE);
       const Vector3f &a = extents;
       const Point3f &Pa = center;
       const Vector3f * const A = &normal_a;
@@ -575,6 +762,7 @@ namespace Zeni {
     }
     
     float Parallelepiped::some_distance(const Parallelepiped &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_PARALLELEPIPED, ZENI_PARALLELEPIPED, ZENI_INTERSECTS);
       const Vector3f &a = extents;
       const Point3f &Pa = center;
       const Vector3f * const A = &normal_a;
@@ -655,6 +843,7 @@ namespace Zeni {
     }
 
     float Parallelepiped::shortest_distance(const Point3f &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_PARALLELEPIPED, ZENI_POINT, ZENI_SHORTEST_DISTANCE);
       const Point3f converted_point = convert_to * (rhs - point);
 
       Point3f nearest_point = converted_point;
@@ -668,6 +857,7 @@ namespace Zeni {
     }
 
     float Parallelepiped::shortest_distance(const Plane &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_PARALLELEPIPED, ZENI_PLANE, ZENI_SHORTEST_DISTANCE);
       const Point3f &p = rhs.get_point();
       const Vector3f &n = rhs.get_normal();
 
@@ -707,9 +897,11 @@ namespace Zeni {
     }
 
     float Parallelepiped::shortest_distance(const Sphere &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_PARALLELEPIPED, ZENI_SPHERE, ZENI_SHORTEST_DISTANCE);
       return unpoof(shortest_distance(rhs.get_center()), rhs.get_radius());
     }
     float Parallelepiped::shortest_distance(const Infinite_Cylinder &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_PARALLELEPIPED, ZENI_INFINITE_CYLINDER, ZENI_SHORTEST_DISTANCE);
       return unpoof(shortest_distance(reinterpret_cast<const Line &>(rhs)), rhs.get_radius());
     }
 
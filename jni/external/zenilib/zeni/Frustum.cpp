@@ -0,0 +1,129 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni.h>
+
+#include <cmath>
+
+namespace Zeni {
+
+  Bounding_Box Bounding_Box::transformed(const Matrix4f &transformation) const {
+    Bounding_Box box;
+
+    if(!empty())
+      for(int i = 0; i < 8; ++i)
+        box.include(Point3f(transformation * Vector3f(i & 1 ? upper_bound.x : lower_bound.x,
+                                                      i & 2 ? upper_bound.y : lower_bound.y,
+                                                      i & 4 ? upper_bound.z : lower_bound.z)));
+
+    return box;
+  }
+
+  Frustum::Frustum()
+    : m_num_culled(0lu),
+    m_num_drawn(0lu)
+  {
+    for(int i = 0; i < 6; ++i) {
+      m_normal[i] = Vector3f();
+      m_distance[i] = 1.0f;
+    }
+  }
+
+  Frustum::Frustum(const Matrix4f &clip_matrix)
+    : m_num_culled(0lu),
+    m_num_drawn(0lu)
+  {
+    /* Gribb & Hartmann, "Fast Extraction of Viewing Frustum Planes from the
+     * World-View-Projection Matrix": each plane is the sum or difference of
+     * the last row and one of the first three rows.
+     */
+    const Matrix4f &m = clip_matrix;
+
+    for(int i = 0; i < 6; ++i) {
+      const int row = i >> 1;
+      const float sign = i & 1 ? -1.0f : 1.0f;
+
+      Vector3f normal(m[3][0] + sign * m[row][0],
+                      m[3][1] + sign * m[row][1],
+                      m[3][2] + sign * m[row][2]);
+      float distance = m[3][3] + sign * m[row][3];
+
+      const float magnitude = normal.magnitude();
+      if(magnitude > 0.0f) {
+        normal /= magnitude;
+        distance /= magnitude;
+      }
+
+      m_normal[i] = normal;
+      m_distance[i] = distance;
+    }
+  }
+
+  Frustum::CONTAINMENT Frustum::classify(const Point3f &point) const {
+    const Vector3f position(point);
+
+    for(int i = 0; i < 6; ++i)
+      if(m_normal[i] * position + m_distance[i] < 0.0f)
+        return ZENI_OUTSIDE;
+
+    return ZENI_INSIDE;
+  }
+
+  Frustum::CONTAINMENT Frustum::classify(const Collision::Sphere &sphere) const {
+    const Vector3f center(sphere.get_center());
+    const float &radius = sphere.get_radius();
+    CONTAINMENT result = ZENI_INSIDE;
+
+    for(int i = 0; i < 6; ++i) {
+      const float distance = m_normal[i] * center + m_distance[i];
+
+      if(distance < -radius)
+        return ZENI_OUTSIDE;
+      else if(distance < radius)
+        result = ZENI_INTERSECTING;
+    }
+
+    return result;
+  }
+
+  Frustum::CONTAINMENT Frustum::classify(const Bounding_Box &box) const {
+    if(box.empty())
+      return ZENI_OUTSIDE;
+
+    CONTAINMENT result = ZENI_INSIDE;
+
+    for(int i = 0; i < 6; ++i) {
+      const Vector3f &n = m_normal[i];
+
+      // The corners farthest along and farthest against the plane normal
+      const Vector3f positive(n.i < 0.0f ? box.lower_bound.x : box.upper_bound.x,
+                              n.j < 0.0f ? box.lower_bound.y : box.upper_bound.y,
+                              n.k < 0.0f ? box.lower_bound.z : box.upper_bound.z);
+      const Vector3f negative(n.i < 0.0f ? box.upper_bound.x : box.lower_bound.x,
+                              n.j < 0.0f ? box.upper_bound.y : box.lower_bound.y,
+                              n.k < 0.0f ? box.upper_bound.z : box.lower_bound.z);
+
+      if(n * positive + m_distance[i] < 0.0f)
+        return ZENI_OUTSIDE;
+      else if(n * negative + m_distance[i] < 0.0f)
+        result = ZENI_INTERSECTING;
+    }
+
+    return result;
+  }
+
+}
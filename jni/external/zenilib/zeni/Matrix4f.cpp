@@ -17,11 +17,48 @@
 
 #include <zeni.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
+#include <Zeni/Define.h>
+
+#if defined(ZENI_SIMD_SSE)
+#include <xmmintrin.h>
+#elif defined(ZENI_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace Zeni {
 
+  /// row *= scalar
+  static inline void matrix4f_scale_row(float * const row, const float &scalar) {
+#if defined(ZENI_SIMD_SSE)
+    _mm_storeu_ps(row, _mm_mul_ps(_mm_loadu_ps(row), _mm_set1_ps(scalar)));
+#elif defined(ZENI_SIMD_NEON)
+    vst1q_f32(row, vmulq_n_f32(vld1q_f32(row), scalar));
+#else
+    row[0] *= scalar;
+    row[1] *= scalar;
+    row[2] *= scalar;
+    row[3] *= scalar;
+#endif
+  }
+
+  /// row -= scalar * src
+  static inline void matrix4f_subtract_row(float * const row, const float * const src, const float &scalar) {
+#if defined(ZENI_SIMD_SSE)
+    _mm_storeu_ps(row, _mm_sub_ps(_mm_loadu_ps(row), _mm_mul_ps(_mm_loadu_ps(src), _mm_set1_ps(scalar))));
+#elif defined(ZENI_SIMD_NEON)
+    vst1q_f32(row, vmlsq_n_f32(vld1q_f32(row), vld1q_f32(src), scalar));
+#else
+    row[0] -= scalar * src[0];
+    row[1] -= scalar * src[1];
+    row[2] -= scalar * src[2];
+    row[3] -= scalar * src[3];
+#endif
+  }
+
   Matrix4f::Matrix4f()
   {
     memset(&m_matrix, 0, sizeof(m_matrix));
@@ -97,38 +134,48 @@ namespace Zeni {
 
   Matrix4f Matrix4f::inverted() const
   {
-    const float det_M = determinant();
-
-#define m(i,j) (m_matrix[j][i])
-
-    const float m00 = (m(1,2)*m(2,3)*m(3,1) - m(1,3)*m(2,2)*m(3,1) + m(1,3)*m(2,1)*m(3,2) - m(1,1)*m(2,3)*m(3,2) - m(1,2)*m(2,1)*m(3,3) + m(1,1)*m(2,2)*m(3,3)) / det_M;
-    const float m01 = (m(0,3)*m(2,2)*m(3,1) - m(0,2)*m(2,3)*m(3,1) - m(0,3)*m(2,1)*m(3,2) + m(0,1)*m(2,3)*m(3,2) + m(0,2)*m(2,1)*m(3,3) - m(0,1)*m(2,2)*m(3,3)) / det_M;
-    const float m02 = (m(0,2)*m(1,3)*m(3,1) - m(0,3)*m(1,2)*m(3,1) + m(0,3)*m(1,1)*m(3,2) - m(0,1)*m(1,3)*m(3,2) - m(0,2)*m(1,1)*m(3,3) + m(0,1)*m(1,2)*m(3,3)) / det_M;
-    const float m03 = (m(0,3)*m(1,2)*m(2,1) - m(0,2)*m(1,3)*m(2,1) - m(0,3)*m(1,1)*m(2,2) + m(0,1)*m(1,3)*m(2,2) + m(0,2)*m(1,1)*m(2,3) - m(0,1)*m(1,2)*m(2,3)) / det_M;
-    const float m10 = (m(1,3)*m(2,2)*m(3,0) - m(1,2)*m(2,3)*m(3,0) - m(1,3)*m(2,0)*m(3,2) + m(1,0)*m(2,3)*m(3,2) + m(1,2)*m(2,0)*m(3,3) - m(1,0)*m(2,2)*m(3,3)) / det_M;
-    const float m11 = (m(0,2)*m(2,3)*m(3,0) - m(0,3)*m(2,2)*m(3,0) + m(0,3)*m(2,0)*m(3,2) - m(0,0)*m(2,3)*m(3,2) - m(0,2)*m(2,0)*m(3,3) + m(0,0)*m(2,2)*m(3,3)) / det_M;
-    const float m12 = (m(0,3)*m(1,2)*m(3,0) - m(0,2)*m(1,3)*m(3,0) - m(0,3)*m(1,0)*m(3,2) + m(0,0)*m(1,3)*m(3,2) + m(0,2)*m(1,0)*m(3,3) - m(0,0)*m(1,2)*m(3,3)) / det_M;
-    const float m13 = (m(0,2)*m(1,3)*m(2,0) - m(0,3)*m(1,2)*m(2,0) + m(0,3)*m(1,0)*m(2,2) - m(0,0)*m(1,3)*m(2,2) - m(0,2)*m(1,0)*m(2,3) + m(0,0)*m(1,2)*m(2,3)) / det_M;
-    const float m20 = (m(1,1)*m(2,3)*m(3,0) - m(1,3)*m(2,1)*m(3,0) + m(1,3)*m(2,0)*m(3,1) - m(1,0)*m(2,3)*m(3,1) - m(1,1)*m(2,0)*m(3,3) + m(1,0)*m(2,1)*m(3,3)) / det_M;
-    const float m21 = (m(0,3)*m(2,1)*m(3,0) - m(0,1)*m(2,3)*m(3,0) - m(0,3)*m(2,0)*m(3,1) + m(0,0)*m(2,3)*m(3,1) + m(0,1)*m(2,0)*m(3,3) - m(0,0)*m(2,1)*m(3,3)) / det_M;
-    const float m22 = (m(0,1)*m(1,3)*m(3,0) - m(0,3)*m(1,1)*m(3,0) + m(0,3)*m(1,0)*m(3,1) - m(0,0)*m(1,3)*m(3,1) - m(0,1)*m(1,0)*m(3,3) + m(0,0)*m(1,1)*m(3,3)) / det_M;
-    const float m23 = (m(0,3)*m(1,1)*m(2,0) - m(0,1)*m(1,3)*m(2,0) - m(0,3)*m(1,0)*m(2,1) + m(0,0)*m(1,3)*m(2,1) + m(0,1)*m(1,0)*m(2,3) - m(0,0)*m(1,1)*m(2,3)) / det_M;
-    const float m30 = (m(1,2)*m(2,1)*m(3,0) - m(1,1)*m(2,2)*m(3,0) - m(1,2)*m(2,0)*m(3,1) + m(1,0)*m(2,2)*m(3,1) + m(1,1)*m(2,0)*m(3,2) - m(1,0)*m(2,1)*m(3,2)) / det_M;
-    const float m31 = (m(0,1)*m(2,2)*m(3,0) - m(0,2)*m(2,1)*m(3,0) + m(0,2)*m(2,0)*m(3,1) - m(0,0)*m(2,2)*m(3,1) - m(0,1)*m(2,0)*m(3,2) + m(0,0)*m(2,1)*m(3,2)) / det_M;
-    const float m32 = (m(0,2)*m(1,1)*m(3,0) - m(0,1)*m(1,2)*m(3,0) - m(0,2)*m(1,0)*m(3,1) + m(0,0)*m(1,2)*m(3,1) + m(0,1)*m(1,0)*m(3,2) - m(0,0)*m(1,1)*m(3,2)) / det_M;
-    const float m33 = (m(0,1)*m(1,2)*m(2,0) - m(0,2)*m(1,1)*m(2,0) + m(0,2)*m(1,0)*m(2,1) - m(0,0)*m(1,2)*m(2,1) - m(0,1)*m(1,0)*m(2,2) + m(0,0)*m(1,1)*m(2,2)) / det_M;
+    /* Gauss-Jordan elimination with partial pivoting, run on the columns.
+     * Column operations on M are row operations on M^T, and since
+     * (M^T)^-1 == (M^-1)^T, the identity is left holding M^-1.
+     */
+    Matrix4f lhs(*this);
+    Matrix4f rhs(Identity());
 
-#undef m
+    for(int c = 0; c < 4; ++c) {
+      int pivot = c;
+      for(int r = c + 1; r < 4; ++r)
+        if(fabs(lhs.m_matrix[r][c]) > fabs(lhs.m_matrix[pivot][c]))
+          pivot = r;
+
+      if(pivot != c) {
+        for(int i = 0; i < 4; ++i) {
+          std::swap(lhs.m_matrix[pivot][i], lhs.m_matrix[c][i]);
+          std::swap(rhs.m_matrix[pivot][i], rhs.m_matrix[c][i]);
+        }
+      }
+
+      const float reciprocal = 1.0f / lhs.m_matrix[c][c];
+      matrix4f_scale_row(lhs.m_matrix[c], reciprocal);
+      matrix4f_scale_row(rhs.m_matrix[c], reciprocal);
+
+      for(int r = 0; r < 4; ++r) {
+        if(r == c)
+          continue;
 
-    return Matrix4f(
-      m00, m01, m02, m03,
-      m10, m11, m12, m13,
-      m20, m21, m22, m23,
-      m30, m31, m32, m33);
+        const float factor = lhs.m_matrix[r][c];
+        matrix4f_subtract_row(lhs.m_matrix[r], lhs.m_matrix[c], factor);
+        matrix4f_subtract_row(rhs.m_matrix[r], rhs.m_matrix[c], factor);
+      }
+    }
+
+    return rhs;
   }
 
   Matrix4f & Matrix4f::transpose()
   {
+#if defined(ZENI_SIMD_SSE) || defined(ZENI_SIMD_NEON)
+    return *this = transposed();
+#else
     for(int i = 1; i < 4; ++i)
       for(int j = 0; j < i; ++j) {
         float temp = m_matrix[i][j];
@@ -137,15 +184,37 @@ namespace Zeni {
       }
 
     return *this;
+#endif
   }
 
   Matrix4f Matrix4f::transposed() const
   {
     Matrix4f matrix;
 
+#if defined(ZENI_SIMD_SSE)
+    __m128 c0 = _mm_loadu_ps(m_matrix[0]);
+    __m128 c1 = _mm_loadu_ps(m_matrix[1]);
+    __m128 c2 = _mm_loadu_ps(m_matrix[2]);
+    __m128 c3 = _mm_loadu_ps(m_matrix[3]);
+
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    _mm_storeu_ps(matrix.m_matrix[0], c0);
+    _mm_storeu_ps(matrix.m_matrix[1], c1);
+    _mm_storeu_ps(matrix.m_matrix[2], c2);
+    _mm_storeu_ps(matrix.m_matrix[3], c3);
+#elif defined(ZENI_SIMD_NEON)
+    const float32x4x4_t rows = vld4q_f32(&m_matrix[0][0]);
+
+    vst1q_f32(matrix.m_matrix[0], rows.val[0]);
+    vst1q_f32(matrix.m_matrix[1], rows.val[1]);
+    vst1q_f32(matrix.m_matrix[2], rows.val[2]);
+    vst1q_f32(matrix.m_matrix[3], rows.val[3]);
+#else
     for(int i = 0; i < 4; ++i)
       for(int j = 0; j < 4; ++j)
         matrix.m_matrix[i][j] = m_matrix[j][i];
+#endif
 
     return matrix;
   }
@@ -158,7 +227,7 @@ namespace Zeni {
     return
       + term(0,1,2,3) - term(0,1,3,2)
       - term(0,2,1,3) + term(0,2,3,1)
-      + term(0,3,1,2) + term(0,3,2,1)
+      + term(0,3,1,2) - term(0,3,2,1)
 
       - term(1,0,2,3) + term(1,0,3,2)
       + term(1,2,0,3) - term(1,2,3,0)
@@ -176,12 +245,135 @@ namespace Zeni {
 #undef m
   }
   
+  Matrix4f Matrix4f::operator*(const Matrix4f &rhs) const {
+    Matrix4f matrix;
+
+#if defined(ZENI_SIMD_SSE)
+    const __m128 c0 = _mm_loadu_ps(m_matrix[0]);
+    const __m128 c1 = _mm_loadu_ps(m_matrix[1]);
+    const __m128 c2 = _mm_loadu_ps(m_matrix[2]);
+    const __m128 c3 = _mm_loadu_ps(m_matrix[3]);
+
+    for(int j = 0; j < 4; ++j) {
+      const float * const rc = rhs.m_matrix[j];
+      _mm_storeu_ps(matrix.m_matrix[j],
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(rc[0])),
+                                          _mm_mul_ps(c1, _mm_set1_ps(rc[1]))),
+                               _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(rc[2])),
+                                          _mm_mul_ps(c3, _mm_set1_ps(rc[3])))));
+    }
+#elif defined(ZENI_SIMD_NEON)
+    const float32x4_t c0 = vld1q_f32(m_matrix[0]);
+    const float32x4_t c1 = vld1q_f32(m_matrix[1]);
+    const float32x4_t c2 = vld1q_f32(m_matrix[2]);
+    const float32x4_t c3 = vld1q_f32(m_matrix[3]);
+
+    for(int j = 0; j < 4; ++j) {
+      const float * const rc = rhs.m_matrix[j];
+      float32x4_t column = vmulq_n_f32(c0, rc[0]);
+      column = vmlaq_n_f32(column, c1, rc[1]);
+      column = vmlaq_n_f32(column, c2, rc[2]);
+      column = vmlaq_n_f32(column, c3, rc[3]);
+      vst1q_f32(matrix.m_matrix[j], column);
+    }
+#else
+    for(int i = 0; i < 4; ++i)
+      for(int j = 0; j < 4; ++j)
+        matrix.m_matrix[j][i] =
+        m_matrix[0][i] * rhs.m_matrix[j][0] +
+        m_matrix[1][i] * rhs.m_matrix[j][1] +
+        m_matrix[2][i] * rhs.m_matrix[j][2] +
+        m_matrix[3][i] * rhs.m_matrix[j][3];
+#endif
+
+    return matrix;
+  }
+
   Vector3f Matrix4f::operator*(const Vector3f &vector) const {
     return Vector3f(m_matrix[0][0] * vector.i + m_matrix[1][0] * vector.j + m_matrix[2][0] * vector.k + m_matrix[3][0],
                     m_matrix[0][1] * vector.i + m_matrix[1][1] * vector.j + m_matrix[2][1] * vector.k + m_matrix[3][1],
                     m_matrix[0][2] * vector.i + m_matrix[1][2] * vector.j + m_matrix[2][2] * vector.k + m_matrix[3][2]);
   }
 
+  void Matrix4f::transform_points(Point3f * const &dst, const Point3f * const &src, const size_t &count) const {
+#if defined(ZENI_SIMD_SSE)
+    const __m128 c0 = _mm_loadu_ps(m_matrix[0]);
+    const __m128 c1 = _mm_loadu_ps(m_matrix[1]);
+    const __m128 c2 = _mm_loadu_ps(m_matrix[2]);
+    const __m128 c3 = _mm_loadu_ps(m_matrix[3]);
+
+    for(size_t n = 0; n != count; ++n) {
+      const __m128 point = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(src[n].x)),
+                                                 _mm_mul_ps(c1, _mm_set1_ps(src[n].y))),
+                                      _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(src[n].z)), c3));
+      _mm_storel_pi(reinterpret_cast<__m64 *>(&dst[n].x), point);
+      _mm_store_ss(&dst[n].z, _mm_movehl_ps(point, point));
+    }
+#elif defined(ZENI_SIMD_NEON)
+    const float32x4_t c0 = vld1q_f32(m_matrix[0]);
+    const float32x4_t c1 = vld1q_f32(m_matrix[1]);
+    const float32x4_t c2 = vld1q_f32(m_matrix[2]);
+    const float32x4_t c3 = vld1q_f32(m_matrix[3]);
+
+    for(size_t n = 0; n != count; ++n) {
+      float32x4_t point = vmlaq_n_f32(c3, c0, src[n].x);
+      point = vmlaq_n_f32(point, c1, src[n].y);
+      point = vmlaq_n_f32(point, c2, src[n].z);
+      vst1_f32(&dst[n].x, vget_low_f32(point));
+      vst1q_lane_f32(&dst[n].z, point, 2);
+    }
+#else
+    for(size_t n = 0; n != count; ++n) {
+      const float x = src[n].x;
+      const float y = src[n].y;
+      const float z = src[n].z;
+      dst[n].x = m_matrix[0][0] * x + m_matrix[1][0] * y + m_matrix[2][0] * z + m_matrix[3][0];
+      dst[n].y = m_matrix[0][1] * x + m_matrix[1][1] * y + m_matrix[2][1] * z + m_matrix[3][1];
+      dst[n].z = m_matrix[0][2] * x + m_matrix[1][2] * y + m_matrix[2][2] * z + m_matrix[3][2];
+    }
+#endif
+  }
+
+  void Matrix4f::transform_vectors(Vector3f * const &dst, const Vector3f * const &src, const size_t &count) const {
+#if defined(ZENI_SIMD_SSE)
+    const __m128 c0 = _mm_loadu_ps(m_matrix[0]);
+    const __m128 c1 = _mm_loadu_ps(m_matrix[1]);
+    const __m128 c2 = _mm_loadu_ps(m_matrix[2]);
+
+    for(size_t n = 0; n != count; ++n) {
+      const __m128 vector = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(src[n].i)),
+                                                  _mm_mul_ps(c1, _mm_set1_ps(src[n].j))),
+                                       _mm_mul_ps(c2, _mm_set1_ps(src[n].k)));
+      dst[n].degenerate = src[n].degenerate;
+      _mm_storel_pi(reinterpret_cast<__m64 *>(&dst[n].i), vector);
+      _mm_store_ss(&dst[n].k, _mm_movehl_ps(vector, vector));
+    }
+#elif defined(ZENI_SIMD_NEON)
+    const float32x4_t c0 = vld1q_f32(m_matrix[0]);
+    const float32x4_t c1 = vld1q_f32(m_matrix[1]);
+    const float32x4_t c2 = vld1q_f32(m_matrix[2]);
+
+    for(size_t n = 0; n != count; ++n) {
+      float32x4_t vector = vmulq_n_f32(c0, src[n].i);
+      vector = vmlaq_n_f32(vector, c1, src[n].j);
+      vector = vmlaq_n_f32(vector, c2, src[n].k);
+      dst[n].degenerate = src[n].degenerate;
+      vst1_f32(&dst[n].i, vget_low_f32(vector));
+      vst1q_lane_f32(&dst[n].k, vector, 2);
+    }
+#else
+    for(size_t n = 0; n != count; ++n) {
+      const float i = src[n].i;
+      const float j = src[n].j;
+      const float k = src[n].k;
+      dst[n].degenerate = src[n].degenerate;
+      dst[n].i = m_matrix[0][0] * i + m_matrix[1][0] * j + m_matrix[2][0] * k;
+      dst[n].j = m_matrix[0][1] * i + m_matrix[1][1] * j + m_matrix[2][1] * k;
+      dst[n].k = m_matrix[0][2] * i + m_matrix[1][2] * j + m_matrix[2][2] * k;
+    }
+#endif
+  }
+
   std::ostream & serialize(std::ostream &os, const Matrix4f &value) {
     return os.write(reinterpret_cast<const char * const>(&value), 16u * sizeof(float));
   }
@@ -191,3 +383,5 @@ namespace Zeni {
   }
 
 }
+
+#include <Zeni/Undefine.h>
@@ -0,0 +1,176 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni.h>
+
+#include <cassert>
+#include <sstream>
+
+namespace Zeni {
+
+  // Everything handed out is aligned as strictly as the heap would align it
+  static size_t round_up(const size_t &size, const size_t &alignment) {
+    return (size + alignment - 1u) / alignment * alignment;
+  }
+
+  static const size_t g_pool_alignment = 2u * sizeof(void *);
+
+  static SDL_SpinLock g_statistics_lock = 0; ///< Guards the current and last frame Allocation_Statistics, which every Pool shares
+
+  Allocation_Statistics::Allocation_Statistics()
+    : allocations(0lu),
+    heap_allocations(0lu),
+    bytes(0lu)
+  {
+  }
+
+  String Allocation_Statistics::to_string() const {
+    std::ostringstream oss;
+    oss << "Allocation: " << allocations << " allocations, "
+        << heap_allocations << " from the heap, "
+        << bytes << " bytes";
+    return oss.str().c_str();
+  }
+
+  static Allocation_Statistics & get_last_frame_Allocation_Statistics() {
+    static Allocation_Statistics statistics;
+    return statistics;
+  }
+
+  static Allocation_Statistics & get_current_Allocation_Statistics() {
+    static Allocation_Statistics statistics;
+    return statistics;
+  }
+
+  static void count_allocation(const size_t &bytes, const unsigned long &heap_allocations) {
+    SDL_AtomicLock(&g_statistics_lock);
+    Allocation_Statistics &statistics = get_current_Allocation_Statistics();
+    ++statistics.allocations;
+    statistics.heap_allocations += heap_allocations;
+    statistics.bytes += bytes;
+    SDL_AtomicUnlock(&g_statistics_lock);
+  }
+
+  Allocation_Statistics Allocation_Statistics::get_current() {
+    SDL_AtomicLock(&g_statistics_lock);
+    const Allocation_Statistics statistics = get_current_Allocation_Statistics();
+    SDL_AtomicUnlock(&g_statistics_lock);
+    return statistics;
+  }
+
+  const Allocation_Statistics & Allocation_Statistics::get_last_frame() {
+    return get_last_frame_Allocation_Statistics();
+  }
+
+  void Allocation_Statistics::end_frame() {
+    SDL_AtomicLock(&g_statistics_lock);
+    Allocation_Statistics &current = get_current_Allocation_Statistics();
+    get_last_frame_Allocation_Statistics() = current;
+    current = Allocation_Statistics();
+    SDL_AtomicUnlock(&g_statistics_lock);
+  }
+
+  Pool::Pool(const size_t &object_size, const size_t &objects_per_block)
+    : m_object_size(round_up(object_size > sizeof(Free_Node) ? object_size : sizeof(Free_Node), g_pool_alignment)),
+    m_requested_size(object_size),
+    m_objects_per_block(objects_per_block ? objects_per_block : 1u),
+    m_num_allocated(0u),
+    m_free(0),
+    m_lock(0)
+  {
+  }
+
+  Pool::~Pool() {
+    assert(!m_num_allocated);
+
+    for(std::vector<char *>::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+      ::operator delete(*it);
+  }
+
+  void * Pool::allocate() {
+    SDL_AtomicLock(&m_lock);
+
+    const bool grew = !m_free;
+    if(grew)
+      grow();
+
+    Free_Node * const node = m_free;
+    m_free = node->next;
+    ++m_num_allocated;
+
+    SDL_AtomicUnlock(&m_lock);
+
+    count_allocation(m_object_size, grew ? 1lu : 0lu);
+
+    return node;
+  }
+
+  void Pool::deallocate(void * const &ptr) {
+    if(!ptr)
+      return;
+
+    Free_Node * const node = reinterpret_cast<Free_Node *>(ptr);
+
+    SDL_AtomicLock(&m_lock);
+    node->next = m_free;
+    m_free = node;
+    --m_num_allocated;
+    SDL_AtomicUnlock(&m_lock);
+  }
+
+  void * Pool::allocate(const size_t &size) {
+    if(size == m_requested_size)
+      return allocate();
+
+    count_allocation(size, 1lu);
+    return ::operator new(size);
+  }
+
+  void Pool::deallocate(void * const &ptr, const size_t &size) {
+    if(size == m_requested_size)
+      deallocate(ptr);
+    else
+      ::operator delete(ptr);
+  }
+
+  size_t Pool::get_num_allocated() const {
+    SDL_AtomicLock(&m_lock);
+    const size_t num_allocated = m_num_allocated;
+    SDL_AtomicUnlock(&m_lock);
+    return num_allocated;
+  }
+
+  size_t Pool::get_num_reserved() const {
+    SDL_AtomicLock(&m_lock);
+    const size_t num_reserved = m_blocks.size() * m_objects_per_block;
+    SDL_AtomicUnlock(&m_lock);
+    return num_reserved;
+  }
+
+  void Pool::grow() {
+    char * const block = reinterpret_cast<char *>(::operator new(m_object_size * m_objects_per_block));
+    m_blocks.push_back(block);
+
+    // Thread the new objects onto the free list so they are handed out in address order
+    for(size_t i = m_objects_per_block; i; --i) {
+      Free_Node * const node = reinterpret_cast<Free_Node *>(block + (i - 1u) * m_object_size);
+      node->next = m_free;
+      m_free = node;
+    }
+  }
+
+}
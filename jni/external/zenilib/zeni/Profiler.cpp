@@ -0,0 +1,304 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+#include <Zeni/Define.h>
+
+namespace Zeni {
+
+  static Uint64 profiler_useconds() {
+#if defined(_WINDOWS)
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return Uint64(count.QuadPart / frequency.QuadPart) * 1000000u +
+           Uint64(count.QuadPart % frequency.QuadPart) * 1000000u / Uint64(frequency.QuadPart);
+#else
+#if defined(_MACOSX)
+    const timespec ticks = orwl_gettime();
+#else
+    timespec ticks;
+    clock_gettime(CLOCK_MONOTONIC, &ticks);
+#endif
+    return Uint64(ticks.tv_sec) * 1000000u + Uint64(ticks.tv_nsec) / 1000u;
+#endif
+  }
+
+  static void profiler_memory_barrier() {
+#if defined(_WINDOWS)
+    MemoryBarrier();
+#else
+    __sync_synchronize();
+#endif
+  }
+
+  struct Profiler_Buffer {
+    struct Open {
+      const char * name;
+      Uint64 start;
+    };
+
+    Profiler_Buffer(const Uint32 &thread_)
+      : next(0),
+      thread(thread_),
+      generation(0u),
+      count(0u),
+      frame_begin(0u),
+      depth(0u),
+      dropped(0u)
+    {
+    }
+
+    Profiler_Buffer * next;
+    const Uint32 thread;
+
+    // Written only by the owning thread; Read by stop_capture()
+    volatile Uint32 generation;
+    volatile Uint32 count;
+
+    // Owning thread only
+    Uint32 frame_begin;
+    Uint32 depth;
+    Uint32 dropped;
+    Open open[ZENI_PROFILER_MAX_DEPTH];
+    Profiler::Event events[ZENI_PROFILER_BUFFER_SIZE];
+  };
+
+  static Profiler_Buffer * volatile g_profiler_buffers = 0;
+  static volatile Uint32 g_profiler_generation = 1u;
+  static volatile long g_profiler_threads = 0;
+  static bool g_profiler_capturing = false;
+  static size_t g_profiler_dropped = 0u;
+  static ZENI_THREAD_LOCAL Profiler_Buffer * t_profiler_buffer = 0;
+
+  static std::vector<Profiler::Event> & get_captured_Events() {
+    static std::vector<Profiler::Event> events;
+    return events;
+  }
+
+  static std::vector<Profiler::Summary> & get_last_frame_Summaries() {
+    static std::vector<Profiler::Summary> summaries;
+    return summaries;
+  }
+
+  static Profiler_Buffer & get_Profiler_Buffer() {
+    Profiler_Buffer *buffer = t_profiler_buffer;
+
+    if(!buffer) {
+      // Registered once per thread and never freed, so readers never see a dangling buffer
+#if defined(_WINDOWS)
+      buffer = new Profiler_Buffer(Uint32(InterlockedIncrement(&g_profiler_threads)));
+      do {
+        buffer->next = g_profiler_buffers;
+      } while(InterlockedCompareExchangePointer(reinterpret_cast<PVOID volatile *>(&g_profiler_buffers), buffer, buffer->next) != buffer->next);
+#else
+      buffer = new Profiler_Buffer(Uint32(__sync_add_and_fetch(&g_profiler_threads, 1)));
+      do {
+        buffer->next = g_profiler_buffers;
+      } while(!__sync_bool_compare_and_swap(&g_profiler_buffers, buffer->next, buffer));
+#endif
+      t_profiler_buffer = buffer;
+    }
+
+    // Discard events from before the last end_frame() or capture
+    const Uint32 generation = g_profiler_generation;
+    if(buffer->generation != generation) {
+      buffer->count = 0u;
+      buffer->frame_begin = 0u;
+      profiler_memory_barrier();
+      buffer->generation = generation;
+    }
+
+    return *buffer;
+  }
+
+  static void next_generation() {
+    profiler_memory_barrier();
+    g_profiler_generation = g_profiler_generation + 1u;
+  }
+
+  void Profiler::begin(const char * const name) {
+    Profiler_Buffer &buffer = get_Profiler_Buffer();
+
+    if(buffer.depth < ZENI_PROFILER_MAX_DEPTH) {
+      Profiler_Buffer::Open &open = buffer.open[buffer.depth];
+      open.name = name;
+      open.start = profiler_useconds();
+    }
+
+    ++buffer.depth;
+  }
+
+  void Profiler::end() {
+    const Uint64 now = profiler_useconds();
+    Profiler_Buffer &buffer = get_Profiler_Buffer();
+
+    if(!buffer.depth)
+      return;
+
+    if(--buffer.depth >= ZENI_PROFILER_MAX_DEPTH || buffer.count == ZENI_PROFILER_BUFFER_SIZE) {
+      ++buffer.dropped;
+      return;
+    }
+
+    const Profiler_Buffer::Open &open = buffer.open[buffer.depth];
+    Event &event = buffer.events[buffer.count];
+    event.name = open.name;
+    event.start = open.start;
+    event.duration = Uint32(now - open.start);
+    event.depth = buffer.depth;
+    event.thread = buffer.thread;
+
+    // Publish the Event only once it is complete
+    profiler_memory_barrier();
+    buffer.count = buffer.count + 1u;
+  }
+
+  struct Profiler_Event_Order {
+    bool operator()(const Profiler::Event &lhs, const Profiler::Event &rhs) const {
+      return lhs.start < rhs.start || (lhs.start == rhs.start && lhs.depth < rhs.depth);
+    }
+  };
+
+  void Profiler::end_frame() {
+    Profiler_Buffer &buffer = get_Profiler_Buffer();
+
+    static std::vector<Event> events;
+    events.assign(buffer.events + buffer.frame_begin, buffer.events + buffer.count);
+    std::sort(events.begin(), events.end(), Profiler_Event_Order());
+
+    std::vector<Summary> &summaries = get_last_frame_Summaries();
+    summaries.clear();
+
+    for(std::vector<Event>::const_iterator it = events.begin(); it != events.end(); ++it) {
+      std::vector<Summary>::iterator jt = summaries.begin();
+      while(jt != summaries.end() && (jt->name != it->name || jt->depth != it->depth))
+        ++jt;
+
+      if(jt == summaries.end()) {
+        Summary summary;
+        summary.name = it->name;
+        summary.depth = it->depth;
+        summary.calls = 0u;
+        summary.seconds = 0.0;
+        jt = summaries.insert(summaries.end(), summary);
+      }
+
+      ++jt->calls;
+      jt->seconds += it->duration * 0.000001;
+    }
+
+    if(g_profiler_capturing)
+      buffer.frame_begin = buffer.count;
+    else {
+      g_profiler_dropped += buffer.dropped;
+      buffer.dropped = 0u;
+      next_generation();
+    }
+  }
+
+  const std::vector<Profiler::Summary> & Profiler::get_last_frame() {
+    return get_last_frame_Summaries();
+  }
+
+  String Profiler::to_string() {
+    const std::vector<Summary> &summaries = get_last_frame_Summaries();
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3) << "Profile: " << summaries.size() << " scopes";
+
+    for(std::vector<Summary>::const_iterator it = summaries.begin(); it != summaries.end(); ++it)
+      oss << '\n' << std::string(2u * it->depth, ' ') << it->name
+          << ": " << it->calls << " calls, " << 1000.0 * it->seconds << " ms";
+
+    return oss.str().c_str();
+  }
+
+  void Profiler::start_capture() {
+    get_captured_Events().clear();
+    g_profiler_dropped = 0u;
+    g_profiler_capturing = true;
+    next_generation();
+  }
+
+  void Profiler::stop_capture() {
+    std::vector<Event> &captured = get_captured_Events();
+    captured.clear();
+
+    const Uint32 generation = g_profiler_generation;
+    for(Profiler_Buffer *buffer = g_profiler_buffers; buffer; buffer = buffer->next) {
+      if(buffer->generation != generation)
+        continue;
+
+      profiler_memory_barrier();
+      const Uint32 count = buffer->count;
+      profiler_memory_barrier();
+
+      captured.insert(captured.end(), buffer->events, buffer->events + count);
+    }
+
+    g_profiler_dropped += get_Profiler_Buffer().dropped;
+    get_Profiler_Buffer().dropped = 0u;
+
+    g_profiler_capturing = false;
+    next_generation();
+  }
+
+  bool Profiler::is_capturing() {
+    return g_profiler_capturing;
+  }
+
+  size_t Profiler::get_num_captured() {
+    return get_captured_Events().size();
+  }
+
+  size_t Profiler::get_num_dropped() {
+    return g_profiler_dropped;
+  }
+
+  void Profiler::write_chrome_trace(std::ostream &os) {
+    const std::vector<Event> &captured = get_captured_Events();
+
+    os << "{\"traceEvents\":[";
+
+    for(std::vector<Event>::const_iterator it = captured.begin(); it != captured.end(); ++it) {
+      if(it != captured.begin())
+        os << ',';
+
+      os << "\n{\"name\":\"";
+      for(const char *c = it->name; *c; ++c) {
+        if(*c == '"' || *c == '\\')
+          os << '\\';
+        os << *c;
+      }
+      os << "\",\"cat\":\"zenilib\",\"ph\":\"X\",\"ts\":" << it->start
+         << ",\"dur\":" << it->duration
+         << ",\"pid\":0,\"tid\":" << it->thread << '}';
+    }
+
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  }
+
+}
+
+#include <Zeni/Undefine.h>
@@ -148,6 +148,14 @@ namespace Zeni {
     return Quaternion(time * mplier, space * mplier);
   }
 
+  void Quaternion::rotate(Vector3f * const &dst, const Vector3f * const &src, const size_t &count) const {
+    get_matrix().transform_vectors(dst, src, count);
+
+    if(degenerate)
+      for(size_t n = 0; n != count; ++n)
+        dst[n].degenerate = true;
+  }
+
   std::ostream & serialize(std::ostream &os, const Quaternion &value) {
     return serialize(serialize(os, value.time), value.space);
   }
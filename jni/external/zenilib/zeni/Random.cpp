@@ -16,3 +16,120 @@
  */
 
 #include <zeni.h>
+
+#include <cmath>
+
+#include <Zeni/Define.h>
+
+#if defined(ZENI_SIMD_SSE2)
+#include <emmintrin.h>
+#elif defined(ZENI_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Zeni {
+
+  void Random::seed(const Uint32 &seed_) {
+    // Weyl sequence through the MurmurHash3 finalizer, so that nearby seeds give unrelated states
+    Uint32 weyl = seed_;
+
+    for(int i = 0; i != 4; ++i) {
+      weyl += 0x9E3779B9u;
+      Uint32 z = weyl;
+      z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+      z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+      m_state[i] = z ^ (z >> 16);
+    }
+
+    if(!(m_state[0] | m_state[1] | m_state[2] | m_state[3]))
+      m_state[0] = 1u;
+  }
+
+  void Random::rand_u32(Uint32 * const &dst, const size_t &count) {
+    for(size_t n = 0; n != count; ++n)
+      dst[n] = rand_u32();
+  }
+
+  void Random::frand_lt(float * const &dst, const size_t &count) {
+    size_t n = 0;
+
+#if defined(ZENI_SIMD_SSE2) || defined(ZENI_SIMD_NEON)
+    Uint32 bits[4];
+
+    for(; n + 4 <= count; n += 4) {
+      bits[0] = rand_u32();
+      bits[1] = rand_u32();
+      bits[2] = rand_u32();
+      bits[3] = rand_u32();
+
+#if defined(ZENI_SIMD_SSE2)
+      const __m128i mantissas = _mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bits)), 8);
+      _mm_storeu_ps(dst + n, _mm_mul_ps(_mm_cvtepi32_ps(mantissas), _mm_set1_ps(1.0f / 16777216.0f)));
+#else
+      const uint32x4_t mantissas = vshrq_n_u32(vld1q_u32(bits), 8);
+      vst1q_f32(dst + n, vmulq_n_f32(vcvtq_f32_u32(mantissas), 1.0f / 16777216.0f));
+#endif
+    }
+#endif
+
+    for(; n != count; ++n)
+      dst[n] = frand_lt();
+  }
+
+  void Random::rand_lt(Sint32 * const &dst, const size_t &count, const Sint32 &mod) {
+    assert(0 < mod);
+
+    for(size_t n = 0; n != count; ++n)
+      dst[n] = Sint32(bounded(Uint32(mod)));
+  }
+
+  void Random::unit_vectors(Vector3f * const &dst, const size_t &count) {
+    // Archimedes:  z is uniform on [-1, 1] for points uniform on the sphere
+    for(size_t n = 0; n != count; ++n) {
+      const float z = 2.0f * frand_lt() - 1.0f;
+      const float theta = 2.0f * Global::pi * frand_lt();
+      const float r = float(sqrt(1.0f - z * z));
+
+      dst[n] = Vector3f(r * float(cos(theta)), r * float(sin(theta)), z);
+    }
+  }
+
+  void Random::jump() {
+    static const Uint32 polynomial[4] = {0x8764000bu, 0xf542d2d3u, 0x6fa035c3u, 0x77f2db5bu};
+    jump_by(polynomial);
+  }
+
+  void Random::long_jump() {
+    static const Uint32 polynomial[4] = {0xb523952eu, 0x0b6f099fu, 0xccf5a0efu, 0x1c580662u};
+    jump_by(polynomial);
+  }
+
+  Random Random::split() {
+    const Random rv(*this);
+    jump();
+    return rv;
+  }
+
+  void Random::jump_by(const Uint32 * const polynomial) {
+    Uint32 state[4] = {0u, 0u, 0u, 0u};
+
+    for(int i = 0; i != 4; ++i)
+      for(int b = 0; b != 32; ++b) {
+        if(polynomial[i] & (1u << b)) {
+          state[0] ^= m_state[0];
+          state[1] ^= m_state[1];
+          state[2] ^= m_state[2];
+          state[3] ^= m_state[3];
+        }
+        rand_u32();
+      }
+
+    m_state[0] = state[0];
+    m_state[1] = state[1];
+    m_state[2] = state[2];
+    m_state[3] = state[3];
+  }
+
+}
+
+#include <Zeni/Undefine.h>
@@ -308,8 +308,15 @@ namespace Zeni {
   }
 
   std::ostream & serialize(std::ostream &os, const String &string) {
-    const Uint16 sz = Uint16(string.size());
-    return serialize(os, sz).write(string.c_str(), sz);
+    const Uint32 sz = Uint32(string.size());
+    return serialize_size(os, sz).write(string.c_str(), sz);
+  }
+
+  std::ostream & serialize_size(std::ostream &os, const Uint32 &size) {
+    if(size < 0xFFFFu)
+      return serialize(os, Uint16(size));
+
+    return serialize(serialize(os, Uint16(0xFFFFu)), size);
   }
   
   std::istream & unserialize(std::istream &is, Sint32 &value) {
@@ -398,12 +405,30 @@ namespace Zeni {
   }
 
   std::istream & unserialize(std::istream &is, String &string) {
+    Uint32 sz;
+
+    if(unserialize_size(is, sz)) {
+      // Grow only as the bytes arrive, so a corrupt size cannot demand gigabytes up front
+      string.resize(0u);
+      for(Uint32 done = 0u; is && done != sz; ) {
+        const Uint32 block = std::min(sz - done, Uint32(0x10000u));
+        string.resize(done + block);
+        is.read(&string[done], block);
+        done += block;
+      }
+    }
+
+    return is;
+  }
+
+  std::istream & unserialize_size(std::istream &is, Uint32 &size) {
     Uint16 sz;
-    unserialize(is, sz);
 
-    if(is) {
-      string.resize(sz);
-      is.read(const_cast<char *>(string.c_str()), sz);
+    if(unserialize(is, sz)) {
+      if(sz != 0xFFFFu)
+        size = sz;
+      else
+        unserialize(is, size);
     }
 
     return is;
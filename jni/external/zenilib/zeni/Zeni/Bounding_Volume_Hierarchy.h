@@ -0,0 +1,101 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Bounding_Volume_Hierarchy
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Bounding Volume Hierarchy for Frustum Culling
+ *
+ * Objects are inserted along with their world-space Bounding_Boxes.  The 
+ * hierarchy is (re)built lazily by splitting along the longest axis of the 
+ * object centers, so a subtree that is entirely outside of (or inside of) 
+ * a Frustum is culled (or accepted) with a single test.
+ *
+ * \note The visitor passed to visit_visible is called as visitor(object) for each object that is not culled.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_BOUNDING_VOLUME_HIERARCHY_H
+#define ZENI_BOUNDING_VOLUME_HIERARCHY_H
+
+#include <Zeni/Frustum.h>
+
+#include <vector>
+
+namespace Zeni {
+
+  template <typename TYPE>
+  class Bounding_Volume_Hierarchy {
+    struct Entry {
+      Entry(const TYPE &object_, const Bounding_Box &bounds_);
+
+      TYPE object;
+      Bounding_Box bounds;
+      Point3f center;
+    };
+
+    struct Center_Sorter {
+      Center_Sorter(const int &axis_) : axis(axis_) {}
+
+      bool operator()(const Entry &lhs, const Entry &rhs) const;
+
+      int axis;
+    };
+
+    struct Node {
+      Bounding_Box bounds;
+      size_t first; ///< Index of the first Entry
+      size_t count; ///< Number of Entries
+      size_t children; ///< Index of the first child Node, or 0 for a leaf
+    };
+
+  public:
+    Bounding_Volume_Hierarchy(const size_t &leaf_size = 4u);
+
+    inline size_t size() const; ///< Get the number of objects
+    inline bool empty() const; ///< Determine whether there are any objects
+
+    void insert(const TYPE &object, const Bounding_Box &bounds); ///< Add an object; The hierarchy will be rebuilt on the next visit
+    void clear(); ///< Remove all objects
+    void build(); ///< Rebuild the hierarchy now rather than on the next visit
+
+    template <typename VISITOR>
+    void visit_visible(const Frustum &frustum, VISITOR &visitor); ///< Call visitor(object) for each object not culled by frustum
+
+  private:
+    void build(const size_t &node);
+
+    template <typename VISITOR>
+    void visit_visible(const Frustum &frustum, VISITOR &visitor, const size_t &node) const;
+
+    template <typename VISITOR>
+    void visit_all(const Frustum &frustum, VISITOR &visitor, const size_t &node) const;
+
+    size_t m_leaf_size;
+    std::vector<Entry> m_entries;
+    std::vector<Node> m_nodes;
+    bool m_dirty;
+  };
+
+}
+
+#endif
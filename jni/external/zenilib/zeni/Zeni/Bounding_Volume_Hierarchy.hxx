@@ -0,0 +1,192 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZENI_BOUNDING_VOLUME_HIERARCHY_HXX
+#define ZENI_BOUNDING_VOLUME_HIERARCHY_HXX
+
+// HXXed below
+#include <Zeni/Frustum.h>
+
+#include <Zeni/Bounding_Volume_Hierarchy.h>
+
+// Not HXXed
+#include <algorithm>
+
+namespace Zeni {
+
+  template <typename TYPE>
+  Bounding_Volume_Hierarchy<TYPE>::Entry::Entry(const TYPE &object_, const Bounding_Box &bounds_)
+    : object(object_),
+    bounds(bounds_),
+    center(bounds_.get_center())
+  {
+  }
+
+  template <typename TYPE>
+  bool Bounding_Volume_Hierarchy<TYPE>::Center_Sorter::operator()(const Entry &lhs, const Entry &rhs) const {
+    return Vector3f(lhs.center)[axis] < Vector3f(rhs.center)[axis];
+  }
+
+  template <typename TYPE>
+  Bounding_Volume_Hierarchy<TYPE>::Bounding_Volume_Hierarchy(const size_t &leaf_size)
+    : m_leaf_size(leaf_size ? leaf_size : 1u),
+    m_dirty(false)
+  {
+  }
+
+  template <typename TYPE>
+  size_t Bounding_Volume_Hierarchy<TYPE>::size() const {
+    return m_entries.size();
+  }
+
+  template <typename TYPE>
+  bool Bounding_Volume_Hierarchy<TYPE>::empty() const {
+    return m_entries.empty();
+  }
+
+  template <typename TYPE>
+  void Bounding_Volume_Hierarchy<TYPE>::insert(const TYPE &object, const Bounding_Box &bounds) {
+    m_entries.push_back(Entry(object, bounds));
+    m_dirty = true;
+  }
+
+  template <typename TYPE>
+  void Bounding_Volume_Hierarchy<TYPE>::clear() {
+    m_entries.clear();
+    m_nodes.clear();
+    m_dirty = false;
+  }
+
+  template <typename TYPE>
+  void Bounding_Volume_Hierarchy<TYPE>::build() {
+    m_nodes.clear();
+    m_dirty = false;
+
+    if(m_entries.empty())
+      return;
+
+    m_nodes.reserve(2u * (m_entries.size() / m_leaf_size + 1u));
+
+    Node root;
+    root.first = 0u;
+    root.count = m_entries.size();
+    root.children = 0u;
+    m_nodes.push_back(root);
+
+    build(0u);
+  }
+
+  template <typename TYPE>
+  void Bounding_Volume_Hierarchy<TYPE>::build(const size_t &node) {
+    const size_t first = m_nodes[node].first;
+    const size_t count = m_nodes[node].count;
+
+    Bounding_Box bounds;
+    Bounding_Box centers;
+    for(size_t i = first, iend = first + count; i != iend; ++i) {
+      bounds.include(m_entries[i].bounds);
+      centers.include(m_entries[i].center);
+    }
+    m_nodes[node].bounds = bounds;
+
+    if(count <= m_leaf_size)
+      return;
+
+    const Vector3f spread = centers.get_size();
+    const int axis = spread.i > spread.j ? (spread.i > spread.k ? 0 : 2)
+                                         : (spread.j > spread.k ? 1 : 2);
+
+    const size_t half = count / 2u;
+    std::nth_element(m_entries.begin() + first,
+                     m_entries.begin() + first + half,
+                     m_entries.begin() + first + count,
+                     Center_Sorter(axis));
+
+    Node lower;
+    lower.first = first;
+    lower.count = half;
+    lower.children = 0u;
+
+    Node upper;
+    upper.first = first + half;
+    upper.count = count - half;
+    upper.children = 0u;
+
+    const size_t children = m_nodes.size();
+    m_nodes[node].children = children;
+    m_nodes.push_back(lower);
+    m_nodes.push_back(upper);
+
+    build(children);
+    build(children + 1u);
+  }
+
+  template <typename TYPE>
+  template <typename VISITOR>
+  void Bounding_Volume_Hierarchy<TYPE>::visit_visible(const Frustum &frustum, VISITOR &visitor) {
+    if(m_dirty)
+      build();
+
+    if(!m_nodes.empty())
+      visit_visible(frustum, visitor, 0u);
+  }
+
+  template <typename TYPE>
+  template <typename VISITOR>
+  void Bounding_Volume_Hierarchy<TYPE>::visit_visible(const Frustum &frustum, VISITOR &visitor, const size_t &node) const {
+    const Node &n = m_nodes[node];
+
+    switch(frustum.classify(n.bounds)) {
+      case Frustum::ZENI_OUTSIDE:
+        frustum.count_culled((unsigned long)(n.count));
+        break;
+
+      case Frustum::ZENI_INSIDE:
+        visit_all(frustum, visitor, node);
+        break;
+
+      case Frustum::ZENI_INTERSECTING:
+      default:
+        if(n.children) {
+          visit_visible(frustum, visitor, n.children);
+          visit_visible(frustum, visitor, n.children + 1u);
+        }
+        else {
+          for(size_t i = n.first, iend = n.first + n.count; i != iend; ++i)
+            if(!frustum.cull(m_entries[i].bounds))
+              visitor(m_entries[i].object);
+        }
+        break;
+    }
+  }
+
+  template <typename TYPE>
+  template <typename VISITOR>
+  void Bounding_Volume_Hierarchy<TYPE>::visit_all(const Frustum &frustum, VISITOR &visitor, const size_t &node) const {
+    const Node &n = m_nodes[node];
+
+    frustum.count_drawn((unsigned long)(n.count));
+
+    for(size_t i = n.first, iend = n.first + n.count; i != iend; ++i)
+      visitor(m_entries[i].object);
+  }
+
+}
+
+#include <Zeni/Frustum.hxx>
+
+#endif
@@ -0,0 +1,249 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Byte_Writer
+ *
+ * \ingroup zenilib
+ *
+ * \brief Serialization into a Caller-Owned Buffer
+ *
+ * A Byte_Writer appends to a fixed-size buffer that it does not own, so a
+ * message can be built directly in a packet without an std::ostringstream
+ * in between.  The serialize overloads below produce exactly the same
+ * bytes as their std::ostream counterparts.  So float and double are
+ * written in host byte order, as they always have been.
+ * serialize_portable() writes them big-endian instead, for data shared
+ * between hosts of either byte order.
+ *
+ * Anything that would overrun the buffer sets fail() instead, and nothing
+ * more is written until clear().
+ *
+ * write_bits() packs values most significant bit first.  Consecutive calls
+ * share bytes; Any other write starts on the next whole byte.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+/**
+ * \class Zeni::Byte_Reader
+ *
+ * \ingroup zenilib
+ *
+ * \brief Unserialization from a Caller-Owned Buffer
+ *
+ * A Byte_Reader is the counterpart to Byte_Writer.  Reading past the end
+ * of the buffer sets fail() and leaves the destination untouched.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_BYTE_WRITER_H
+#define ZENI_BYTE_WRITER_H
+
+#include <Zeni/Serialization.h>
+
+/* \cond */
+#include <algorithm>
+/* \endcond */
+
+namespace Zeni {
+
+  class ZENI_DLL Byte_Writer {
+  public:
+    Byte_Writer(void * const &buffer, const size_t &capacity)
+      : m_buffer(reinterpret_cast<char *>(buffer)),
+      m_capacity(capacity),
+      m_size(0u),
+      m_bit(0u),
+      m_fail(false)
+    {
+    }
+
+    const char * data() const {return m_buffer;}
+    const size_t & size() const {return m_size;} ///< Bytes written so far, including any partially packed byte
+    const size_t & capacity() const {return m_capacity;}
+    size_t remaining() const {return m_capacity - m_size;}
+
+    bool good() const {return !m_fail;}
+    bool fail() const {return m_fail;}
+    void clear() {m_size = 0u; m_bit = 0u; m_fail = false;} ///< Start over at the beginning of the buffer
+
+    inline char * write_in_place(const size_t &num_bytes); ///< Claim num_bytes to be filled in by the caller; Returns 0 on failure
+    inline Byte_Writer & write(const void * const &data, const size_t &num_bytes);
+    inline Byte_Writer & write_varint(const Uint32 &value); ///< 1 to 5 bytes, 7 bits at a time
+    inline Byte_Writer & write_varint(const Sint32 &value); ///< Zigzag encoded, so small magnitudes of either sign stay short
+    inline Byte_Writer & write_bits(const Uint32 &value, const Uint32 &num_bits); ///< Pack the low num_bits (1 to 32) of value
+
+  private:
+    char * m_buffer;
+    size_t m_capacity;
+    size_t m_size;
+    Uint32 m_bit; ///< Bits already packed into the last byte, or 0 if it is full
+    bool m_fail;
+  };
+
+  class ZENI_DLL Byte_Reader {
+  public:
+    Byte_Reader(const void * const &buffer, const size_t &size)
+      : m_buffer(reinterpret_cast<const char *>(buffer)),
+      m_size(size),
+      m_position(0u),
+      m_bit(0u),
+      m_fail(false)
+    {
+    }
+
+    const char * data() const {return m_buffer;}
+    const size_t & size() const {return m_size;}
+    const size_t & position() const {return m_position;} ///< Bytes consumed so far, including any partially unpacked byte
+    size_t remaining() const {return m_size - m_position;}
+
+    bool good() const {return !m_fail;}
+    bool fail() const {return m_fail;}
+    void clear() {m_position = 0u; m_bit = 0u; m_fail = false;} ///< Start over at the beginning of the buffer
+
+    inline const char * read_in_place(const size_t &num_bytes); ///< Consume num_bytes without copying them; Returns 0 on failure
+    inline Byte_Reader & read(void * const &data, const size_t &num_bytes);
+    inline Byte_Reader & read_varint(Uint32 &value);
+    inline Byte_Reader & read_varint(Sint32 &value);
+    inline Byte_Reader & read_bits(Uint32 &value, const Uint32 &num_bits); ///< Unpack num_bits (1 to 32) written by Byte_Writer::write_bits
+
+  private:
+    const char * m_buffer;
+    size_t m_size;
+    size_t m_position;
+    Uint32 m_bit; ///< Bits already unpacked from the last byte, or 0 if it is used up
+    bool m_fail;
+  };
+
+  /*** Stand-Alone serialization/unserialization functions ***/
+
+  inline Byte_Writer & serialize(Byte_Writer &writer, const Sint32 &value);
+  inline Byte_Writer & serialize(Byte_Writer &writer, const Uint32 &value);
+  inline Byte_Writer & serialize(Byte_Writer &writer, const Sint16 &value);
+  inline Byte_Writer & serialize(Byte_Writer &writer, const Uint16 &value);
+  inline Byte_Writer & serialize(Byte_Writer &writer, const Sint8 &value);
+  inline Byte_Writer & serialize(Byte_Writer &writer, const char &value);
+  inline Byte_Writer & serialize(Byte_Writer &writer, const unsigned char &value);
+  inline Byte_Writer & serialize(Byte_Writer &writer, const float &value);
+  inline Byte_Writer & serialize(Byte_Writer &writer, const double &value);
+  inline Byte_Writer & serialize_portable(Byte_Writer &writer, const float &value); ///< Big-endian, unlike the host order of serialize()
+  inline Byte_Writer & serialize_portable(Byte_Writer &writer, const double &value); ///< Big-endian, unlike the host order of serialize()
+  inline Byte_Writer & serialize(Byte_Writer &writer, const IPaddress &address);
+  inline Byte_Writer & serialize(Byte_Writer &writer, const String &string);
+  inline Byte_Writer & serialize_size(Byte_Writer &writer, const Uint32 &size); ///< 16 bits, or 65535 and then 32 bits
+
+  inline Byte_Reader & unserialize(Byte_Reader &reader, Sint32 &value);
+  inline Byte_Reader & unserialize(Byte_Reader &reader, Uint32 &value);
+  inline Byte_Reader & unserialize(Byte_Reader &reader, Sint16 &value);
+  inline Byte_Reader & unserialize(Byte_Reader &reader, Uint16 &value);
+  inline Byte_Reader & unserialize(Byte_Reader &reader, Sint8 &value);
+  inline Byte_Reader & unserialize(Byte_Reader &reader, char &value);
+  inline Byte_Reader & unserialize(Byte_Reader &reader, unsigned char &value);
+  inline Byte_Reader & unserialize(Byte_Reader &reader, float &value);
+  inline Byte_Reader & unserialize(Byte_Reader &reader, double &value);
+  inline Byte_Reader & unserialize_portable(Byte_Reader &reader, float &value); ///< Counterpart to serialize_portable()
+  inline Byte_Reader & unserialize_portable(Byte_Reader &reader, double &value); ///< Counterpart to serialize_portable()
+  inline Byte_Reader & unserialize(Byte_Reader &reader, IPaddress &address);
+  inline Byte_Reader & unserialize(Byte_Reader &reader, String &string);
+  inline Byte_Reader & unserialize_size(Byte_Reader &reader, Uint32 &size);
+
+  template <typename TYPE>
+  Byte_Writer & serialize(Byte_Writer &writer, const std::list<TYPE> &list_) {
+    Zeni::serialize_size(writer, static_cast<Uint32>(list_.size()));
+    for(typename std::list<TYPE>::const_iterator it = list_.begin(); it != list_.end(); ++it)
+      if(serialize(writer, *it).fail())
+        break;
+    return writer;
+  }
+
+  template <typename TYPE>
+  Byte_Reader & unserialize(Byte_Reader &reader, std::list<TYPE> &list_) {
+    list_.clear();
+
+    Uint32 size;
+    if(Zeni::unserialize_size(reader, size).good()) {
+      TYPE el;
+      for(Uint32 i = 0u; i != size; ++i) {
+        if(unserialize(reader, el).fail())
+          break;
+        list_.push_back(el);
+      }
+    }
+    return reader;
+  }
+
+  template <typename TYPE>
+  Byte_Writer & serialize(Byte_Writer &writer, const std::set<TYPE> &list_) {
+    Zeni::serialize_size(writer, static_cast<Uint32>(list_.size()));
+    for(typename std::set<TYPE>::const_iterator it = list_.begin(); it != list_.end(); ++it)
+      if(serialize(writer, *it).fail())
+        break;
+    return writer;
+  }
+
+  template <typename TYPE>
+  Byte_Reader & unserialize(Byte_Reader &reader, std::set<TYPE> &list_) {
+    list_.clear();
+
+    Uint32 size;
+    if(Zeni::unserialize_size(reader, size).good()) {
+      TYPE el;
+      for(Uint32 i = 0u; i != size; ++i) {
+        if(unserialize(reader, el).fail())
+          break;
+        list_.insert(el);
+      }
+    }
+    return reader;
+  }
+
+  template <typename TYPE>
+  Byte_Writer & serialize(Byte_Writer &writer, const std::vector<TYPE> &list_) {
+    Zeni::serialize_size(writer, static_cast<Uint32>(list_.size()));
+    for(typename std::vector<TYPE>::const_iterator it = list_.begin(); it != list_.end(); ++it)
+      if(serialize(writer, *it).fail())
+        break;
+    return writer;
+  }
+
+  template <typename TYPE>
+  Byte_Reader & unserialize(Byte_Reader &reader, std::vector<TYPE> &list_) {
+    list_.clear();
+
+    Uint32 size;
+    if(Zeni::unserialize_size(reader, size).good()) {
+      TYPE el;
+      // Every element takes at least a byte, so a corrupt size cannot reserve more than the buffer could hold
+      list_.reserve(std::min(size_t(size), reader.remaining()));
+      for(Uint32 i = 0u; i != size; ++i) {
+        if(unserialize(reader, el).fail())
+          break;
+        list_.push_back(el);
+      }
+    }
+    return reader;
+  }
+
+}
+
+#endif
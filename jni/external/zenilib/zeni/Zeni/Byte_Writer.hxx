@@ -0,0 +1,319 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZENI_BYTE_WRITER_HXX
+#define ZENI_BYTE_WRITER_HXX
+
+#include <Zeni/Byte_Writer.h>
+
+// Not HXXed
+#include <cstring>
+
+namespace Zeni {
+
+  char * Byte_Writer::write_in_place(const size_t &num_bytes) {
+    if(m_fail || num_bytes > m_capacity - m_size) {
+      m_fail = true;
+      return 0;
+    }
+
+    char * const dst = m_buffer + m_size;
+    m_size += num_bytes;
+    m_bit = 0u;
+    return dst;
+  }
+
+  Byte_Writer & Byte_Writer::write(const void * const &data, const size_t &num_bytes) {
+    char * const dst = write_in_place(num_bytes);
+    if(dst)
+      memcpy(dst, data, num_bytes);
+    return *this;
+  }
+
+  Byte_Writer & Byte_Writer::write_varint(const Uint32 &value) {
+    char buf[5];
+    size_t num_bytes = 0u;
+
+    Uint32 remainder = value;
+    while(remainder > 0x7Fu) {
+      buf[num_bytes++] = char(0x80u | (remainder & 0x7Fu));
+      remainder >>= 7;
+    }
+    buf[num_bytes++] = char(remainder);
+
+    return write(buf, num_bytes);
+  }
+
+  Byte_Writer & Byte_Writer::write_varint(const Sint32 &value) {
+    return write_varint((Uint32(value) << 1) ^ Uint32(value >> 31));
+  }
+
+  Byte_Writer & Byte_Writer::write_bits(const Uint32 &value, const Uint32 &num_bits) {
+    for(Uint32 bits = num_bits; bits && !m_fail; ) {
+      if(!m_bit) {
+        char * const dst = write_in_place(1u);
+        if(!dst)
+          break;
+        *dst = 0;
+      }
+
+      const Uint32 take = std::min(8u - m_bit, bits);
+      bits -= take;
+
+      const Uint32 chunk = (value >> bits) & ((1u << take) - 1u);
+      m_buffer[m_size - 1u] = char(Uint8(m_buffer[m_size - 1u]) | (chunk << (8u - m_bit - take)));
+      m_bit = (m_bit + take) & 7u;
+    }
+
+    return *this;
+  }
+
+  const char * Byte_Reader::read_in_place(const size_t &num_bytes) {
+    if(m_fail || num_bytes > m_size - m_position) {
+      m_fail = true;
+      return 0;
+    }
+
+    const char * const src = m_buffer + m_position;
+    m_position += num_bytes;
+    m_bit = 0u;
+    return src;
+  }
+
+  Byte_Reader & Byte_Reader::read(void * const &data, const size_t &num_bytes) {
+    const char * const src = read_in_place(num_bytes);
+    if(src)
+      memcpy(data, src, num_bytes);
+    return *this;
+  }
+
+  Byte_Reader & Byte_Reader::read_varint(Uint32 &value) {
+    Uint32 result = 0u;
+
+    for(Uint32 shift = 0u; shift != 35u; shift += 7u) {
+      const char * const src = read_in_place(1u);
+      if(!src)
+        return *this;
+
+      const Uint32 byte = Uint8(*src);
+      result |= (byte & 0x7Fu) << shift;
+
+      if(!(byte & 0x80u)) {
+        value = result;
+        return *this;
+      }
+    }
+
+    // More than 5 bytes cannot have come from write_varint
+    m_fail = true;
+    return *this;
+  }
+
+  Byte_Reader & Byte_Reader::read_varint(Sint32 &value) {
+    Uint32 zigzag;
+    if(read_varint(zigzag).good())
+      value = Sint32((zigzag >> 1) ^ (0u - (zigzag & 1u)));
+    return *this;
+  }
+
+  Byte_Reader & Byte_Reader::read_bits(Uint32 &value, const Uint32 &num_bits) {
+    Uint32 result = 0u;
+
+    for(Uint32 bits = num_bits; bits; ) {
+      if(!m_bit && !read_in_place(1u))
+        return *this;
+
+      const Uint32 take = std::min(8u - m_bit, bits);
+      bits -= take;
+
+      const Uint32 byte = Uint8(m_buffer[m_position - 1u]);
+      result = (result << take) | ((byte >> (8u - m_bit - take)) & ((1u << take) - 1u));
+      m_bit = (m_bit + take) & 7u;
+    }
+
+    value = result;
+    return *this;
+  }
+
+  Byte_Writer & serialize(Byte_Writer &writer, const Sint32 &value) {
+    return serialize(writer, Uint32(value));
+  }
+
+  Byte_Writer & serialize(Byte_Writer &writer, const Uint32 &value) {
+    char * const dst = writer.write_in_place(sizeof(Uint32));
+    if(dst) {
+      dst[0] = char(value >> 24);
+      dst[1] = char(value >> 16);
+      dst[2] = char(value >> 8);
+      dst[3] = char(value);
+    }
+    return writer;
+  }
+
+  Byte_Writer & serialize(Byte_Writer &writer, const Sint16 &value) {
+    return serialize(writer, Uint16(value));
+  }
+
+  Byte_Writer & serialize(Byte_Writer &writer, const Uint16 &value) {
+    char * const dst = writer.write_in_place(sizeof(Uint16));
+    if(dst) {
+      dst[0] = char(value >> 8);
+      dst[1] = char(value);
+    }
+    return writer;
+  }
+
+  Byte_Writer & serialize(Byte_Writer &writer, const Sint8 &value) {
+    return writer.write(&value, 1u);
+  }
+
+  Byte_Writer & serialize(Byte_Writer &writer, const char &value) {
+    return writer.write(&value, 1u);
+  }
+
+  Byte_Writer & serialize(Byte_Writer &writer, const unsigned char &value) {
+    return writer.write(&value, 1u);
+  }
+
+  Byte_Writer & serialize(Byte_Writer &writer, const float &value) {
+    return writer.write(&value, sizeof(float));
+  }
+
+  Byte_Writer & serialize(Byte_Writer &writer, const double &value) {
+    return writer.write(&value, sizeof(double));
+  }
+
+  Byte_Writer & serialize_portable(Byte_Writer &writer, const float &value) {
+    Uint32 bits;
+    memcpy(&bits, &value, sizeof(Uint32));
+    return serialize(writer, bits);
+  }
+
+  Byte_Writer & serialize_portable(Byte_Writer &writer, const double &value) {
+    Uint64 bits;
+    memcpy(&bits, &value, sizeof(Uint64));
+    return serialize(serialize(writer, Uint32(bits >> 32)), Uint32(bits));
+  }
+
+  Byte_Writer & serialize(Byte_Writer &writer, const IPaddress &address) {
+    return writer.write(&address, sizeof(IPaddress));
+  }
+
+  Byte_Writer & serialize(Byte_Writer &writer, const String &string) {
+    const Uint32 sz = Uint32(string.size());
+    return serialize_size(writer, sz).write(string.c_str(), sz);
+  }
+
+  Byte_Writer & serialize_size(Byte_Writer &writer, const Uint32 &size) {
+    if(size < 0xFFFFu)
+      return serialize(writer, Uint16(size));
+
+    return serialize(serialize(writer, Uint16(0xFFFFu)), size);
+  }
+
+  Byte_Reader & unserialize(Byte_Reader &reader, Sint32 &value) {
+    Uint32 u_value;
+    if(unserialize(reader, u_value).good())
+      value = Sint32(u_value);
+    return reader;
+  }
+
+  Byte_Reader & unserialize(Byte_Reader &reader, Uint32 &value) {
+    const char * const src = reader.read_in_place(sizeof(Uint32));
+    if(src)
+      value = (Uint32(Uint8(src[0])) << 24) | (Uint32(Uint8(src[1])) << 16) | (Uint32(Uint8(src[2])) << 8) | Uint32(Uint8(src[3]));
+    return reader;
+  }
+
+  Byte_Reader & unserialize(Byte_Reader &reader, Sint16 &value) {
+    Uint16 u_value;
+    if(unserialize(reader, u_value).good())
+      value = Sint16(u_value);
+    return reader;
+  }
+
+  Byte_Reader & unserialize(Byte_Reader &reader, Uint16 &value) {
+    const char * const src = reader.read_in_place(sizeof(Uint16));
+    if(src)
+      value = Uint16((Uint8(src[0]) << 8) | Uint8(src[1]));
+    return reader;
+  }
+
+  Byte_Reader & unserialize(Byte_Reader &reader, Sint8 &value) {
+    return reader.read(&value, 1u);
+  }
+
+  Byte_Reader & unserialize(Byte_Reader &reader, char &value) {
+    return reader.read(&value, 1u);
+  }
+
+  Byte_Reader & unserialize(Byte_Reader &reader, unsigned char &value) {
+    return reader.read(&value, 1u);
+  }
+
+  Byte_Reader & unserialize(Byte_Reader &reader, float &value) {
+    return reader.read(&value, sizeof(float));
+  }
+
+  Byte_Reader & unserialize(Byte_Reader &reader, double &value) {
+    return reader.read(&value, sizeof(double));
+  }
+
+  Byte_Reader & unserialize_portable(Byte_Reader &reader, float &value) {
+    Uint32 bits;
+    if(unserialize(reader, bits).good())
+      memcpy(&value, &bits, sizeof(float));
+    return reader;
+  }
+
+  Byte_Reader & unserialize_portable(Byte_Reader &reader, double &value) {
+    Uint32 high, low;
+    if(unserialize(unserialize(reader, high), low).good()) {
+      const Uint64 bits = (Uint64(high) << 32) | low;
+      memcpy(&value, &bits, sizeof(double));
+    }
+    return reader;
+  }
+
+  Byte_Reader & unserialize(Byte_Reader &reader, IPaddress &address) {
+    return reader.read(&address, sizeof(IPaddress));
+  }
+
+  Byte_Reader & unserialize(Byte_Reader &reader, String &string) {
+    Uint32 sz;
+    if(unserialize_size(reader, sz).good()) {
+      const char * const src = reader.read_in_place(sz);
+      if(src)
+        string = String(src, sz);
+    }
+    return reader;
+  }
+
+  Byte_Reader & unserialize_size(Byte_Reader &reader, Uint32 &size) {
+    Uint16 sz;
+    if(unserialize(reader, sz).good()) {
+      if(sz != 0xFFFFu)
+        size = sz;
+      else
+        unserialize(reader, size);
+    }
+    return reader;
+  }
+
+}
+
+#endif
@@ -38,6 +38,7 @@
 
 #include <Zeni/Collision.h>
 #include <Zeni/Coordinate.h>
+#include <Zeni/Frustum.h>
 #include <Zeni/Vector3f.h>
 #include <Zeni/Matrix4f.h>
 #include <Zeni/Quaternion.h>
@@ -75,6 +76,7 @@ namespace Zeni {
     inline float get_tunneled_fov_rad() const; ///< Get the field of view (in the y-axis) in radians, shifted by tunnel vision
     inline Matrix4f get_view_matrix() const; ///< Equivalent to gluLookAt + tunnel_vision_factor
     inline Matrix4f get_projection_matrix(const std::pair<Point2i, Point2i> &viewport) const; ///< Equivalent to gluPerspective + tunnel_vision_factor
+    inline Frustum get_frustum(const std::pair<Point2i, Point2i> &viewport) const; ///< Get the world-space Frustum seen through a viewport
 
     void adjust_yaw(const float &theta); ///< Adjust the orientation of the camera: left == positive;
     void adjust_pitch(const float &phi); ///< Adjust the orientation of the camera: up == positive;
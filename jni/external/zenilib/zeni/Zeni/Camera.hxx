@@ -20,6 +20,7 @@
 
 // HXXed below
 #include <Zeni/Coordinate.h>
+#include <Zeni/Frustum.h>
 #include <Zeni/Matrix4f.h>
 #include <Zeni/Quaternion.h>
 
@@ -79,11 +80,16 @@ namespace Zeni {
       get_tunneled_near_clip(), get_tunneled_far_clip());
   }
 
+  Frustum Camera::get_frustum(const std::pair<Point2i, Point2i> &viewport) const {
+    return Frustum(get_projection_matrix(viewport) * get_view_matrix());
+  }
+
 }
 
 #include <Zeni/Undefine.h>
 
 #include <Zeni/Coordinate.hxx>
+#include <Zeni/Frustum.hxx>
 #include <Zeni/Matrix4f.hxx>
 #include <Zeni/Quaternion.hxx>
 
@@ -157,13 +157,40 @@
  * Contact: bazald@zenipex.com
  */
 
+/**
+ * \class Zeni::Collision::Statistics
+ *
+ * \ingroup zenilib
+ *
+ * \brief Collision Query Counters
+ *
+ * When zenilib is built with ENABLE_COLLISION_STATISTICS defined, every 
+ * Collision query counts its calls and time, keyed by the two primitives 
+ * involved and the kind of query.  Only the outermost query is recorded, 
+ * so a Capsule-Sphere test is not also counted as a Line_Segment-Point3f 
+ * test.  Game calls end_frame() once per frame, and the Console_State 
+ * command 'collision_statistics [file.csv]' reports the last frame.
+ *
+ * \note Counting is not thread safe; queries should come from one thread.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
 #ifndef ZENI_COLLISION_H
 #define ZENI_COLLISION_H
 
 #include <Zeni/Coordinate.h>
 #include <Zeni/Vector3f.h>
 #include <Zeni/Matrix4f.h>
+#include <Zeni/String.h>
+
+#ifdef ENABLE_COLLISION_STATISTICS
+#include <Zeni/Timer_HQ.h>
+#endif
 
+#include <iosfwd>
 #include <utility>
 
 namespace Zeni {
@@ -467,6 +494,69 @@ namespace Zeni {
       Vector3f normal_c;
     };
 
+    enum PRIMITIVE {ZENI_POINT = 0, ZENI_SPHERE, ZENI_PLANE, ZENI_LINE, ZENI_RAY, ZENI_LINE_SEGMENT,
+                    ZENI_INFINITE_CYLINDER, ZENI_CAPSULE, ZENI_PARALLELEPIPED, ZENI_PRIMITIVE_COUNT};
+
+    class ZENI_DLL Statistics {
+    public:
+      enum QUERY {ZENI_SHORTEST_DISTANCE = 0, ZENI_NEAREST_POINT, ZENI_INTERSECTS, ZENI_QUERY_COUNT};
+
+      struct ZENI_DLL Counter {
+        Counter() : calls(0u), seconds(0.0) {}
+
+        unsigned long calls;
+        double seconds;
+      };
+
+      const Counter & get(const PRIMITIVE &lhs, const PRIMITIVE &rhs, const QUERY &query) const {return m_counters[lhs][rhs][query];}
+      Counter get_total() const; ///< Get the sum over all primitive pairs and queries
+
+      void record(const PRIMITIVE &lhs, const PRIMITIVE &rhs, const QUERY &query, const double &seconds);
+      void clear();
+
+      String to_string() const; ///< One line per nonzero Counter, most expensive first
+      void write_csv(std::ostream &os, const bool &header = true) const; ///< 'lhs,rhs,query,calls,seconds' per nonzero Counter
+
+      static const char * get_name(const PRIMITIVE &primitive);
+      static const char * get_name(const QUERY &query);
+
+      // For the intersects templates
+      static PRIMITIVE get_primitive(const Point3f &) {return ZENI_POINT;}
+      static PRIMITIVE get_primitive(const Sphere &) {return ZENI_SPHERE;}
+      static PRIMITIVE get_primitive(const Plane &) {return ZENI_PLANE;}
+      static PRIMITIVE get_primitive(const Line &) {return ZENI_LINE;}
+      static PRIMITIVE get_primitive(const Ray &) {return ZENI_RAY;}
+      static PRIMITIVE get_primitive(const Line_Segment &) {return ZENI_LINE_SEGMENT;}
+      static PRIMITIVE get_primitive(const Infinite_Cylinder &) {return ZENI_INFINITE_CYLINDER;}
+      static PRIMITIVE get_primitive(const Capsule &) {return ZENI_CAPSULE;}
+      static PRIMITIVE get_primitive(const Parallelepiped &) {return ZENI_PARALLELEPIPED;}
+
+      static Statistics & get_current(); ///< Get the Statistics accumulated so far this frame
+      static const Statistics & get_last_frame(); ///< Get the Statistics of the last complete frame
+      static void end_frame(); ///< Move the current Statistics into get_last_frame() and start counting again
+
+    private:
+      Counter m_counters[ZENI_PRIMITIVE_COUNT][ZENI_PRIMITIVE_COUNT][ZENI_QUERY_COUNT];
+    };
+
+#ifdef ENABLE_COLLISION_STATISTICS
+    class ZENI_DLL Query_Timer {
+      Query_Timer(const Query_Timer &);
+      Query_Timer & operator=(const Query_Timer &);
+
+    public:
+      Query_Timer(const PRIMITIVE &lhs, const PRIMITIVE &rhs, const Statistics::QUERY &query); ///< Time a query, unless it is nested in another
+      ~Query_Timer(); ///< Record the query in Statistics::get_current()
+
+    private:
+      PRIMITIVE m_lhs;
+      PRIMITIVE m_rhs;
+      Statistics::QUERY m_query;
+      bool m_outermost;
+      Time_HQ m_start;
+    };
+#endif
+
   }
 
 }
@@ -50,6 +50,7 @@ namespace Zeni {
 
     template <typename TYPE>
     bool Sphere::intersects(const TYPE &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_SPHERE, Statistics::get_primitive(rhs), ZENI_INTERSECTS);
       return shortest_distance(rhs) < ZENI_COLLISION_EPSILON;
     }
 
@@ -74,6 +75,7 @@ namespace Zeni {
 
     template <typename TYPE>
     bool Plane::intersects(const TYPE &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_PLANE, Statistics::get_primitive(rhs), ZENI_INTERSECTS);
       return shortest_distance(rhs) < ZENI_COLLISION_EPSILON;
     }
 
@@ -107,6 +109,7 @@ namespace Zeni {
 
     template <typename TYPE>
     bool Line_Segment::intersects(const TYPE &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE_SEGMENT, Statistics::get_primitive(rhs), ZENI_INTERSECTS);
       return shortest_distance(rhs) < ZENI_COLLISION_EPSILON;
     }
 
@@ -140,6 +143,7 @@ namespace Zeni {
 
     template <typename TYPE>
     bool Ray::intersects(const TYPE &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_RAY, Statistics::get_primitive(rhs), ZENI_INTERSECTS);
       return shortest_distance(rhs) < ZENI_COLLISION_EPSILON;
     }
 
@@ -155,6 +159,7 @@ namespace Zeni {
 
     template <typename TYPE>
     bool Line::intersects(const TYPE &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_LINE, Statistics::get_primitive(rhs), ZENI_INTERSECTS);
       return shortest_distance(rhs) < ZENI_COLLISION_EPSILON;
     }
 
@@ -167,6 +172,7 @@ namespace Zeni {
 
     template <typename TYPE>
     bool Infinite_Cylinder::intersects(const TYPE &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_INFINITE_CYLINDER, Statistics::get_primitive(rhs), ZENI_INTERSECTS);
       return shortest_distance(rhs) < ZENI_COLLISION_EPSILON;
     }
 
@@ -200,6 +206,7 @@ namespace Zeni {
 
     template <typename TYPE>
     bool Capsule::intersects(const TYPE &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_CAPSULE, Statistics::get_primitive(rhs), ZENI_INTERSECTS);
       return shortest_distance(rhs) < ZENI_COLLISION_EPSILON;
     }
 
@@ -218,6 +225,7 @@ namespace Zeni {
 
     template <typename TYPE>
     bool Parallelepiped::intersects(const TYPE &rhs) const {
+      ZENI_COLLISION_QUERY(ZENI_PARALLELEPIPED, Statistics::get_primitive(rhs), ZENI_INTERSECTS);
       return shortest_distance(rhs) < ZENI_COLLISION_EPSILON;
     }
 
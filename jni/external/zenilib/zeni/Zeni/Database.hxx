@@ -23,6 +23,7 @@
 
 #include <Zeni/Database.h>
 
+#include <Zeni/Profiler.h>
 #include <Zeni/XML.h>
 
 #include <algorithm>
@@ -223,6 +224,8 @@ namespace Zeni {
 
   template <class TYPE>
   void Database<TYPE>::load_file(const String &filename) {
+    ZENI_PROFILE_SCOPE("Database::load_file");
+
     Filenames::iterator it = std::find(m_filenames.begin(), m_filenames.end(), filename);
     if(it != m_filenames.end())
       m_filenames.erase(it);
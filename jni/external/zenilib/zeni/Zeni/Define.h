@@ -49,6 +49,20 @@
 // Net.h
 #define ZENI_DEFAULT_CHUNK_SIZE (64u)
 #define ZENI_DEFAULT_CHUNK_SETS (64u)
+#define ZENI_DEFAULT_CHUNK_TIMEOUT (5000u)
+#define ZENI_DEFAULT_MAX_MESSAGE_SIZE (16u * 1024u * 1024u)
+
+// Net_Compressor.h
+#define ZENI_DEFAULT_COMPRESSION_THRESHOLD (32u)
+#define ZENI_DEFAULT_COMPRESSION_LEVEL (6)
+
+// Net_Async.h
+#define ZENI_DEFAULT_LOOKUP_TIMEOUT (10000u)
+#define ZENI_DEFAULT_CONNECT_TIMEOUT (10000u)
+
+// Net_Thread.h
+#define ZENI_DEFAULT_NET_THREAD_QUEUE_SIZE (1024u)
+#define ZENI_DEFAULT_NET_THREAD_PACKET_SIZE (8192u)
 
 // Sound_Source.h
 #define ZENI_DEFAULT_PITCH              (1.0f)
@@ -77,6 +91,21 @@
 
 // Collision.cpp
 #define ZENI_COLLISION_EPSILON (0.0001f)
+#ifdef ENABLE_COLLISION_STATISTICS
+#define ZENI_COLLISION_QUERY(lhs, rhs, query) const Query_Timer query_timer(lhs, rhs, Statistics::query)
+#else
+#define ZENI_COLLISION_QUERY(lhs, rhs, query)
+#endif
+
+// Matrix4f.cpp, Random.cpp, Console_State.cpp
+#if !defined(DISABLE_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define ZENI_SIMD_SSE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZENI_SIMD_SSE2
+#endif
+#elif !defined(DISABLE_SIMD) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define ZENI_SIMD_NEON
+#endif
 
 // Configurator_Video.cpp
 #define ZENI_REVERT_TIMEOUT 15
@@ -98,6 +127,11 @@
 #define ZENI_DEFAULT_II_JOYSTICK_MAX (1.0f)
 #define ZENI_DEFAULT_II_MOUSE_MIN (1)
 #define ZENI_DEFAULT_II_MOUSE_MAX (100)
+#define ZENI_II_DENSE_CONTROLLERS (4)
+
+// Job_System.cpp
+#define ZENI_JOB_DEQUE_CAPACITY (4096u)
+#define ZENI_JOB_SPINS_BEFORE_SLEEP (64u)
 
 // Material.cpp
 #define ZENI_DIFFUSE_TO_SPECULAR(d) (Color(d.a, 0.5f * d.r + 0.5f, 0.5f * d.g + 0.5f, 0.5f * d.b + 0.5f))
@@ -105,6 +139,15 @@
 // Net_Primitives.cpp
 #define ZENI_SPRINTF_BUFFER_SIZE (64)
 
+// Profiler.cpp
+#define ZENI_PROFILER_BUFFER_SIZE (16384u)
+#define ZENI_PROFILER_MAX_DEPTH (64u)
+#ifdef _MSC_VER
+#define ZENI_THREAD_LOCAL __declspec(thread)
+#else
+#define ZENI_THREAD_LOCAL __thread
+#endif
+
 // Texture.cpp
 #define ZENI_MAX_TEXTURE_WIDTH (2048)
 #define ZENI_MAX_TEXTURE_HEIGHT (2048)
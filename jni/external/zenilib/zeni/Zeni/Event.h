@@ -15,14 +15,41 @@
  * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+/**
+ * \class Zeni::Event
+ *
+ * \ingroup zenilib
+ *
+ * \brief A List of Handlers to Call Together
+ *
+ * Handlers are called in the order they were first added.  fire()
+ * allocates nothing; Handlers added during a fire() are first called by
+ * the next one, and Handlers removed during a fire() are skipped and
+ * released once the outermost fire() returns.
+ *
+ * When zenilib is built with ENABLE_BENCHMARKS defined, the Console_State
+ * command 'event_benchmark' times fire() with 1, 10 and 100 Handlers.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
 #ifndef ZENI_EVENT_H
 #define ZENI_EVENT_H
 
-#include <Zeni/Hash_Map.h>
+/* \cond */
+#include <cstddef>
+#include <vector>
+/* \endcond */
 
 namespace Zeni {
 
   class ZENI_DLL Event {
+    // Undefined
+    Event(const Event &);
+    Event & operator=(const Event &);
+
   public:
     class ZENI_DLL Handler {
     public:
@@ -33,18 +60,22 @@ namespace Zeni {
       virtual Handler * duplicate() const = 0;
     };
 
-    typedef Unordered_Map<Handler *, bool> Handlers;
+    Event()
+      : m_firing(0u),
+      m_removed(false)
+    {
+    }
 
     ~Event() {
       clear();
     }
 
     void lend_Handler(Handler * const &handler) {
-      m_handlers[handler] = false;
+      add_Handler(handler, false);
     }
 
     void give_Handler(Handler * const &handler) {
-      m_handlers[handler] = true;
+      add_Handler(handler, true);
     }
 
     void fax_Handler(Handler * const &handler) {
@@ -52,39 +83,114 @@ namespace Zeni {
     }
 
     void remove_Handler(Handler * const &handler) {
-      Handlers::iterator ht = m_handlers.find(handler);
-
-      if(ht != m_handlers.end()) {
-        if(ht->second)
-          delete ht->first;
-
-        m_handlers.erase(ht);
-      }
+      const size_t index = find_Handler(handler);
+      if(index != m_handlers.size())
+        remove_at(index);
     }
 
     void fire() {
-      const Handlers m_copy = m_handlers;
-      for(Handlers::const_iterator ht = m_copy.begin(), hend = m_copy.end(); ht != hend; ++ht)
-        (*ht->first)();
+      ++m_firing;
+
+      try {
+        // Handlers added along the way land past 'end'; Removed ones are nulled in place
+        for(size_t i = 0u, end = m_handlers.size(); i != end; ++i) {
+          Handler * const handler = m_handlers[i].handler;
+          if(handler)
+            (*handler)();
+        }
+      }
+      catch(...) {
+        end_fire();
+        throw;
+      }
+
+      end_fire();
     }
 
     void clear() {
-      for(Handlers::const_iterator ht = m_handlers.begin(), hend = m_handlers.end(); ht != hend; ++ht)
-        if(ht->second)
-          delete ht->first;
+      for(std::vector<Entry>::iterator it = m_handlers.begin(); it != m_handlers.end(); ++it)
+        it->handler = 0;
+
+      m_removed = true;
+      if(!m_firing)
+        compact();
+    }
 
-      m_handlers.clear();
+    size_t size() const {
+      size_t count = 0u;
+      for(std::vector<Entry>::const_iterator it = m_handlers.begin(); it != m_handlers.end(); ++it)
+        if(it->handler)
+          ++count;
+      return count;
     }
 
   private:
+    struct Entry {
+      Handler * handler; ///< 0 once removed during a fire()
+      Handler * owned; ///< The Handler to delete once it is removed, if given
+    };
+
+    size_t find_Handler(Handler * const &handler) const {
+      size_t i = 0u;
+      while(i != m_handlers.size() && m_handlers[i].handler != handler)
+        ++i;
+      return i;
+    }
+
+    void add_Handler(Handler * const &handler, const bool &owned) {
+      const size_t index = find_Handler(handler);
+
+      if(index != m_handlers.size())
+        m_handlers[index].owned = owned ? handler : 0;
+      else {
+        const Entry entry = {handler, owned ? handler : 0};
+        m_handlers.push_back(entry);
+      }
+    }
+
+    void remove_at(const size_t &index) {
+      Entry &entry = m_handlers[index];
+
+      if(m_firing) {
+        // The Handler may be running right now; Release it after the outermost fire()
+        entry.handler = 0;
+        m_removed = true;
+      }
+      else {
+        delete entry.owned;
+        m_handlers.erase(m_handlers.begin() + index);
+      }
+    }
+
+    void end_fire() {
+      if(!--m_firing && m_removed)
+        compact();
+    }
+
+    void compact() {
+      size_t kept = 0u;
+
+      for(size_t i = 0u; i != m_handlers.size(); ++i) {
+        if(m_handlers[i].handler)
+          m_handlers[kept++] = m_handlers[i];
+        else
+          delete m_handlers[i].owned;
+      }
+
+      m_handlers.resize(kept);
+      m_removed = false;
+    }
+
 #ifdef _WINDOWS
 #pragma warning( push )
 #pragma warning( disable : 4251 )
 #endif
-    Handlers m_handlers;
+    std::vector<Entry> m_handlers;
 #ifdef _WINDOWS
 #pragma warning( pop )
 #endif
+    size_t m_firing;
+    bool m_removed;
   };
 
 }
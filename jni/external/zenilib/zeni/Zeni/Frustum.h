@@ -0,0 +1,130 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \struct Zeni::Bounding_Box
+ *
+ * \ingroup zenilib
+ *
+ * \brief An Axis-Aligned Bounding Box
+ *
+ * A Bounding_Box starts out empty and grows to contain every Point3f and 
+ * Bounding_Box it is asked to include.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+/**
+ * \class Zeni::Frustum
+ *
+ * \ingroup zenilib
+ *
+ * \brief A View Frustum for Culling
+ *
+ * A Frustum is described by the six planes of a combined projection * view 
+ * Matrix4f.  It can classify Point3fs, Collision::Spheres and Bounding_Boxes 
+ * as being outside of it, intersecting it, or fully inside of it.
+ *
+ * Every call to cull(...) is counted, so a Frustum created once per frame 
+ * doubles as a counter of how many objects were culled and how many were drawn.
+ *
+ * \note Construct a Frustum from projection * view * world to test objects in their local space.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_FRUSTUM_H
+#define ZENI_FRUSTUM_H
+
+#include <Zeni/Collision.h>
+#include <Zeni/Coordinate.h>
+#include <Zeni/Matrix4f.h>
+#include <Zeni/Vector3f.h>
+
+namespace Zeni {
+
+  struct ZENI_DLL Bounding_Box {
+    inline Bounding_Box();
+    inline Bounding_Box(const Point3f &lower_bound_, const Point3f &upper_bound_);
+
+    inline bool empty() const; ///< Determine whether nothing has been included yet
+    inline Point3f get_center() const; ///< Get the center of the Bounding_Box
+    inline Vector3f get_size() const; ///< Get the dimensions of the Bounding_Box
+    inline Collision::Sphere get_bounding_sphere() const; ///< Get a Sphere containing the entire Bounding_Box
+
+    inline void include(const Point3f &point); ///< Grow to contain a Point3f
+    inline void include(const Bounding_Box &box); ///< Grow to contain another Bounding_Box
+
+    Bounding_Box transformed(const Matrix4f &transformation) const; ///< Get the Bounding_Box of the transformed corners
+
+    Point3f lower_bound;
+    Point3f upper_bound;
+  };
+
+  class ZENI_DLL Frustum {
+  public:
+    enum PLANE {ZENI_LEFT_PLANE = 0,
+                ZENI_RIGHT_PLANE = 1,
+                ZENI_BOTTOM_PLANE = 2,
+                ZENI_TOP_PLANE = 3,
+                ZENI_NEAR_PLANE = 4,
+                ZENI_FAR_PLANE = 5};
+
+    enum CONTAINMENT {ZENI_OUTSIDE = 0,
+                      ZENI_INTERSECTING = 1,
+                      ZENI_INSIDE = 2};
+
+    Frustum(); ///< A Frustum that contains everything
+    explicit Frustum(const Matrix4f &clip_matrix); ///< Extract the Frustum from projection * view [* world]
+
+    // Accessors
+    inline const Vector3f & get_normal(const PLANE &plane) const; ///< Get the (inward-facing) normal of a plane
+    inline const float & get_distance(const PLANE &plane) const; ///< Get the offset of a plane along its normal
+
+    // Classification
+    CONTAINMENT classify(const Point3f &point) const; ///< Classify a Point3f
+    CONTAINMENT classify(const Collision::Sphere &sphere) const; ///< Classify a Sphere
+    CONTAINMENT classify(const Bounding_Box &box) const; ///< Classify a Bounding_Box
+
+    template <typename TYPE>
+    bool intersects(const TYPE &rhs) const; ///< Determine whether any part of rhs is inside the Frustum
+
+    // Culling with Statistics
+    template <typename TYPE>
+    bool cull(const TYPE &rhs) const; ///< Returns true if rhs should be skipped; Counts it as culled or drawn
+    inline void count_culled(const unsigned long &num_culled = 1lu) const; ///< Count objects culled without calling cull(...)
+    inline void count_drawn(const unsigned long &num_drawn = 1lu) const; ///< Count objects drawn without calling cull(...)
+
+    inline unsigned long get_num_culled() const; ///< Get the number of objects culled so far
+    inline unsigned long get_num_drawn() const; ///< Get the number of objects drawn so far
+    inline void reset_statistics() const; ///< Zero the culled and drawn counters
+
+  private:
+    Vector3f m_normal[6];
+    float m_distance[6];
+
+    mutable unsigned long m_num_culled;
+    mutable unsigned long m_num_drawn;
+  };
+
+}
+
+#endif
@@ -0,0 +1,145 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZENI_FRUSTUM_HXX
+#define ZENI_FRUSTUM_HXX
+
+// HXXed below
+#include <Zeni/Collision.h>
+#include <Zeni/Coordinate.h>
+#include <Zeni/Vector3f.h>
+
+#include <Zeni/Frustum.h>
+
+// Not HXXed
+#include <algorithm>
+#include <cassert>
+
+namespace Zeni {
+
+  Bounding_Box::Bounding_Box()
+    : lower_bound(1.0f, 1.0f, 1.0f),
+    upper_bound(-1.0f, -1.0f, -1.0f)
+  {
+  }
+
+  Bounding_Box::Bounding_Box(const Point3f &lower_bound_, const Point3f &upper_bound_)
+    : lower_bound(lower_bound_),
+    upper_bound(upper_bound_)
+  {
+  }
+
+  bool Bounding_Box::empty() const {
+    return lower_bound.x > upper_bound.x ||
+           lower_bound.y > upper_bound.y ||
+           lower_bound.z > upper_bound.z;
+  }
+
+  Point3f Bounding_Box::get_center() const {
+    return lower_bound.interpolate_to(0.5f, upper_bound);
+  }
+
+  Vector3f Bounding_Box::get_size() const {
+    return upper_bound - lower_bound;
+  }
+
+  Collision::Sphere Bounding_Box::get_bounding_sphere() const {
+    if(empty())
+      return Collision::Sphere();
+
+    return Collision::Sphere(get_center(), 0.5f * get_size().magnitude());
+  }
+
+  void Bounding_Box::include(const Point3f &point) {
+    if(empty()) {
+      lower_bound = point;
+      upper_bound = point;
+      return;
+    }
+
+    lower_bound.x = std::min(lower_bound.x, point.x);
+    lower_bound.y = std::min(lower_bound.y, point.y);
+    lower_bound.z = std::min(lower_bound.z, point.z);
+
+    upper_bound.x = std::max(upper_bound.x, point.x);
+    upper_bound.y = std::max(upper_bound.y, point.y);
+    upper_bound.z = std::max(upper_bound.z, point.z);
+  }
+
+  void Bounding_Box::include(const Bounding_Box &box) {
+    if(box.empty())
+      return;
+
+    include(box.lower_bound);
+    include(box.upper_bound);
+  }
+
+  const Vector3f & Frustum::get_normal(const PLANE &plane) const {
+    assert(-1 < plane && plane < 6);
+    return m_normal[plane];
+  }
+
+  const float & Frustum::get_distance(const PLANE &plane) const {
+    assert(-1 < plane && plane < 6);
+    return m_distance[plane];
+  }
+
+  template <typename TYPE>
+  bool Frustum::intersects(const TYPE &rhs) const {
+    return classify(rhs) != ZENI_OUTSIDE;
+  }
+
+  template <typename TYPE>
+  bool Frustum::cull(const TYPE &rhs) const {
+    if(intersects(rhs)) {
+      ++m_num_drawn;
+      return false;
+    }
+    else {
+      ++m_num_culled;
+      return true;
+    }
+  }
+
+  void Frustum::count_culled(const unsigned long &num_culled) const {
+    m_num_culled += num_culled;
+  }
+
+  void Frustum::count_drawn(const unsigned long &num_drawn) const {
+    m_num_drawn += num_drawn;
+  }
+
+  unsigned long Frustum::get_num_culled() const {
+    return m_num_culled;
+  }
+
+  unsigned long Frustum::get_num_drawn() const {
+    return m_num_drawn;
+  }
+
+  void Frustum::reset_statistics() const {
+    m_num_culled = 0lu;
+    m_num_drawn = 0lu;
+  }
+
+}
+
+#include <Zeni/Collision.hxx>
+#include <Zeni/Coordinate.hxx>
+#include <Zeni/Vector3f.hxx>
+
+#endif
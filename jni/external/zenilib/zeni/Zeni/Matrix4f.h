@@ -28,6 +28,10 @@
  * creator functions for Zero and Identity matrices, and more advanced 
  * rendering-specific matrices as well.
  *
+ * Multiplication, inversion, transposition, and the batch transformations 
+ * use SSE or NEON when available at compile time.  Define DISABLE_SIMD to 
+ * force the scalar implementations.
+ *
  * \author bazald
  *
  * Contact: bazald@zenipex.com
@@ -92,7 +96,7 @@ namespace Zeni {
     inline Matrix4f & operator-=(const Matrix4f &rhs); ///< Set equal to the difference
 
     // Matrix Products
-    inline Matrix4f operator*(const Matrix4f &rhs) const; ///< Get the product
+    Matrix4f operator*(const Matrix4f &rhs) const; ///< Get the product
     inline Matrix4f operator*=(const Matrix4f &rhs); ///< Get the product
     inline Matrix4f operator/(const Matrix4f &rhs) const; ///< Get the product with the inverse
     inline Matrix4f operator/=(const Matrix4f &rhs); ///< Set equal to the product with the inverse
@@ -116,6 +120,10 @@ namespace Zeni {
     inline Vector3f get_row(const int &row) const; ///< Get a row of the upper left 3x3 matrix
     Vector3f operator*(const Vector3f &vector) const; ///< Transform a Vector3f
 
+    // Batch Transformations
+    void transform_points(Point3f * const &dst, const Point3f * const &src, const size_t &count) const; ///< Transform 'count' Point3fs, including translation; dst may equal src
+    void transform_vectors(Vector3f * const &dst, const Vector3f * const &src, const size_t &count) const; ///< Transform 'count' Vector3fs by the upper-left 3x3 matrix; dst may equal src
+
   private:
 	  float m_matrix[4][4];
   };
@@ -199,20 +199,6 @@ namespace Zeni {
     return *this;
 	}
 
-  Matrix4f Matrix4f::operator*(const Matrix4f &rhs) const {
-    Matrix4f matrix;
-
-    for(int i = 0; i < 4; ++i)
-      for(int j = 0; j < 4; ++j)
-        matrix.m_matrix[j][i] =
-        m_matrix[0][i] * rhs.m_matrix[j][0] +
-        m_matrix[1][i] * rhs.m_matrix[j][1] +
-        m_matrix[2][i] * rhs.m_matrix[j][2] +
-        m_matrix[3][i] * rhs.m_matrix[j][3];
-
-    return matrix;
-  }
-
   Matrix4f Matrix4f::operator*=(const Matrix4f &rhs) {
     return *this = *this * rhs;
   }
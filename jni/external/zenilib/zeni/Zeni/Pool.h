@@ -0,0 +1,133 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Pool
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Fixed-Size Object Allocator
+ *
+ * A Pool hands out objects of one size from blocks it requests from the
+ * heap several objects at a time, and keeps returned objects on a free
+ * list for reuse.  Classes that are created and destroyed many times per
+ * frame (Triangle, Quadrilateral, Sound_Source) route their operator
+ * new and delete through a Pool, so existing owners need not change.
+ *
+ * Requests of any other size (e.g. from a derived class) go straight to
+ * the heap.  Blocks are only released when the Pool is destroyed.
+ *
+ * A Pool is thread safe, since Renderables and Sound_Sources may be
+ * created and destroyed on Job_System workers and the Render_Thread as
+ * well as the main thread.  The spin lock is held only while the free list
+ * is touched.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+/**
+ * \class Zeni::Allocation_Statistics
+ *
+ * \ingroup zenilib
+ *
+ * \brief Pool Counters
+ *
+ * Every Pool counts what it hands out and how often it had to
+ * go to the heap to do so.  Game calls end_frame() once per frame, and
+ * with ENABLE_BENCHMARKS defined, the Console_State command
+ * 'allocation_statistics' reports the last frame.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_POOL_H
+#define ZENI_POOL_H
+
+#include <Zeni/String.h>
+
+/* \cond */
+#include <SDL/SDL_atomic.h>
+#include <cstddef>
+#include <vector>
+/* \endcond */
+
+namespace Zeni {
+
+  struct ZENI_DLL Allocation_Statistics {
+    Allocation_Statistics();
+
+    unsigned long allocations; ///< Objects handed out by Pools
+    unsigned long heap_allocations; ///< Blocks (and odd-sized objects) requested from the heap
+    unsigned long bytes; ///< Bytes handed out by Pools
+
+    String to_string() const;
+
+    static Allocation_Statistics get_current(); ///< Get the Allocation_Statistics accumulated so far this frame
+    static const Allocation_Statistics & get_last_frame(); ///< Get the Allocation_Statistics of the last complete frame
+    static void end_frame(); ///< Move the current Allocation_Statistics into get_last_frame() and start counting again
+  };
+
+  class ZENI_DLL Pool {
+    Pool(const Pool &);
+    Pool & operator=(const Pool &);
+
+  public:
+    Pool(const size_t &object_size, const size_t &objects_per_block = 64u);
+    ~Pool(); ///< Release every block; All objects must have been returned first
+
+    void * allocate(); ///< Get one object's worth of uninitialized memory
+    void deallocate(void * const &ptr); ///< Return an object obtained from allocate()
+
+    // For operator new and delete; Other sizes go to the heap
+    void * allocate(const size_t &size);
+    void deallocate(void * const &ptr, const size_t &size);
+
+    const size_t & get_object_size() const {return m_object_size;}
+    size_t get_num_allocated() const; ///< Objects currently handed out
+    size_t get_num_reserved() const; ///< Objects the blocks can hold
+
+  private:
+    struct Free_Node {
+      Free_Node * next;
+    };
+
+    void grow();
+
+    size_t m_object_size;
+    size_t m_requested_size;
+    size_t m_objects_per_block;
+    size_t m_num_allocated;
+    Free_Node * m_free;
+    mutable SDL_SpinLock m_lock;
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::vector<char *> m_blocks;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  };
+
+}
+
+#endif
@@ -0,0 +1,110 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Profiler
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Hierarchical CPU Profiler
+ *
+ * ZENI_PROFILE_SCOPE("name") times the rest of the enclosing block.  Scopes
+ * nest, and each thread records into its own fixed-size buffer without
+ * locking.  When zenilib is built without ENABLE_PROFILER defined, the
+ * macro expands to nothing.
+ *
+ * Game calls end_frame() once per frame.  Outside of a capture, that
+ * summarizes the main thread's last frame (see get_last_frame()) and
+ * discards every thread's events.  Between start_capture() and
+ * stop_capture(), events from all threads are kept so that
+ * write_chrome_trace() can export them for chrome://tracing.
+ *
+ * The Console_State commands 'profile' and 'profile_capture' expose both.
+ *
+ * \note Scope names must be string literals, or otherwise outlive the Profiler.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_PROFILER_H
+#define ZENI_PROFILER_H
+
+#include <Zeni/String.h>
+
+#include <SDL/SDL_stdinc.h>
+
+/* \cond */
+#include <iosfwd>
+#include <vector>
+/* \endcond */
+
+#ifdef ENABLE_PROFILER
+#define ZENI_PROFILE_CONCATENATE_IMPL(lhs, rhs) lhs ## rhs
+#define ZENI_PROFILE_CONCATENATE(lhs, rhs) ZENI_PROFILE_CONCATENATE_IMPL(lhs, rhs)
+#define ZENI_PROFILE_SCOPE(name) const Zeni::Profiler::Scope ZENI_PROFILE_CONCATENATE(zeni_profile_scope_, __LINE__)(name)
+#else
+#define ZENI_PROFILE_SCOPE(name)
+#endif
+
+namespace Zeni {
+
+  class ZENI_DLL Profiler {
+  public:
+    class ZENI_DLL Scope {
+      Scope(const Scope &);
+      Scope & operator=(const Scope &);
+
+    public:
+      Scope(const char * const name) {begin(name);}
+      ~Scope() {end();}
+    };
+
+    struct ZENI_DLL Event {
+      const char * name;
+      Uint64 start; ///< Microseconds
+      Uint32 duration; ///< Microseconds
+      Uint32 depth;
+      Uint32 thread;
+    };
+
+    struct ZENI_DLL Summary {
+      const char * name;
+      Uint32 depth;
+      Uint32 calls;
+      double seconds;
+    };
+
+    static void begin(const char * const name); ///< Open a scope on the calling thread
+    static void end(); ///< Close the innermost scope on the calling thread
+
+    static void end_frame(); ///< Summarize the calling thread's frame; Discard events unless capturing
+    static const std::vector<Summary> & get_last_frame(); ///< Get the last frame's scopes, in the order they were first opened
+    static String to_string(); ///< Get the last frame's scopes as an indented list
+
+    static void start_capture(); ///< Keep events from all threads until stop_capture()
+    static void stop_capture(); ///< Collect the captured events for write_chrome_trace()
+    static bool is_capturing();
+    static size_t get_num_captured(); ///< Get the number of Events collected by the last stop_capture()
+    static size_t get_num_dropped(); ///< Get the number of Events dropped due to full buffers
+    static void write_chrome_trace(std::ostream &os); ///< Write the captured Events in Chrome's trace event JSON format
+  };
+
+}
+
+#endif
@@ -94,6 +94,7 @@ namespace Zeni {
 
     // Useful interops
     inline Vector3f operator*(const Vector3f &rhs) const; ///< Rotate a vector, maintaining constant magnitude
+    void rotate(Vector3f * const &dst, const Vector3f * const &src, const size_t &count) const; ///< Rotate 'count' Vector3fs at once, dependent on Quaternion being pre-normalized; dst may equal src
     inline std::pair<Vector3f, float> get_rotation() const; ///< Get the rotation in radians left about an axis
     inline Matrix4f get_matrix() const; ///< Get the matrix form of the rotation in row-major order
 
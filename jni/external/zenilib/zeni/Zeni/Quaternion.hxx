@@ -69,7 +69,13 @@ namespace Zeni {
   }
 
   Quaternion Quaternion::grassman_product(const Quaternion &rhs) const {
-    return Quaternion(time * rhs.time - space * rhs.space, time * rhs.space + rhs.time * space + space % rhs.space, degenerate || rhs.degenerate);
+    // time * rhs.time - space * rhs.space, time * rhs.space + rhs.time * space + space % rhs.space
+    return Quaternion(time * rhs.time - space.i * rhs.space.i - space.j * rhs.space.j - space.k * rhs.space.k,
+                      Vector3f(time * rhs.space.i + rhs.time * space.i + space.j * rhs.space.k - space.k * rhs.space.j,
+                               time * rhs.space.j + rhs.time * space.j + space.k * rhs.space.i - space.i * rhs.space.k,
+                               time * rhs.space.k + rhs.time * space.k + space.i * rhs.space.j - space.j * rhs.space.i,
+                               space.degenerate || rhs.space.degenerate),
+                      degenerate || rhs.degenerate);
   }
 
   Quaternion Quaternion::grassman_even_product(const Quaternion &rhs) const {
@@ -22,6 +22,11 @@
  *
  * \brief A Random Number Generator
  *
+ * Random is a xoshiro128** generator:  fast, 32 bits per step, and with a 
+ * period of 2^128 - 1.  jump() and split() provide non-overlapping streams, 
+ * e.g. one per worker thread.  The bulk functions fill whole arrays, using 
+ * SSE2 or NEON for conversions when available.
+ *
  * \author bazald
  *
  * Contact: bazald@zenipex.com
@@ -31,54 +36,107 @@
 #define ZENI_RANDOM_H
 
 #include <cassert>
+#include <cstddef>
 #include <cstdlib>
 
 #include <SDL/SDL_stdinc.h>
 
 namespace Zeni {
 
+  struct Vector3f;
+
   class ZENI_DLL Random {
   public:
-    Random(const Uint32 &seed = Uint32(std::rand()))
-     : m_random_value(seed)
+    Random(const Uint32 &seed_ = Uint32(std::rand()))
     {
+      seed(seed_);
     }
 
+    /// Reset the state of the generator
+    void seed(const Uint32 &seed_);
+
     /// Get the maximum size of a random integer returned from rand()
     Sint32 rand_max() const {
-      return 32767;
+      return 0x7FFFFFFF;
+    }
+
+    /// Get 32 random bits
+    Uint32 rand_u32() {
+      const Uint32 result = rotl(m_state[1] * 5u, 7) * 9u;
+      const Uint32 t = m_state[1] << 9;
+
+      m_state[2] ^= m_state[0];
+      m_state[3] ^= m_state[1];
+      m_state[1] ^= m_state[2];
+      m_state[0] ^= m_state[3];
+      m_state[2] ^= t;
+      m_state[3] = rotl(m_state[3], 11);
+
+      return result;
     }
 
     /// Get a random integer in the range [0, rand_max()]
     Sint32 rand() {
-      m_random_value = m_random_value * 1103515245 + 12345;
-      return Sint32(static_cast<Sint32>(m_random_value / 65536) % (rand_max() + 1));
+      return Sint32(rand_u32() >> 1);
     }
 
     /// Get a random floating point number in the range [0.0f, 1.0f)
     float frand_lt() {
-      return rand() / float(rand_max() + 1);
+      return (rand_u32() >> 8) * (1.0f / 16777216.0f);
     }
 
     /// Get a random floating point number in the range [0.0f, 1.0f]
     float frand_lte() {
-      return rand() / float(rand_max());
+      return (rand_u32() >> 8) * (1.0f / 16777215.0f);
     }
 
     /// Get a random integer in the range [0, mod)
     Sint32 rand_lt(const Sint32 &mod) {
-      assert(mod <= rand_max() + 1);
-      return Sint32(frand_lt() * mod);
+      assert(0 < mod);
+      return Sint32(bounded(Uint32(mod)));
     }
 
     /// Get a random integer in the range [0, mod]
     Sint32 rand_lte(const Sint32 &mod) {
-      assert(mod <= rand_max());
-      return Sint32(frand_lt() * (mod + 1));
+      assert(-1 < mod);
+      return Sint32(bounded(Uint32(mod) + 1u));
     }
 
+    // Bulk Generation
+    void rand_u32(Uint32 * const &dst, const size_t &count); ///< Fill 'dst' with random bits
+    void frand_lt(float * const &dst, const size_t &count); ///< Fill 'dst' with floats in the range [0.0f, 1.0f)
+    void rand_lt(Sint32 * const &dst, const size_t &count, const Sint32 &mod); ///< Fill 'dst' with integers in the range [0, mod)
+    void unit_vectors(Vector3f * const &dst, const size_t &count); ///< Fill 'dst' with unit Vector3fs, uniformly distributed over the sphere
+
+    // Independent Streams
+    void jump(); ///< Advance 2^64 steps, as if rand_u32() were called that many times
+    void long_jump(); ///< Advance 2^96 steps, as if rand_u32() were called that many times
+    Random split(); ///< Get a copy of this generator, then jump() this one past everything the copy will generate
+
   private:
-    Uint32 m_random_value;
+    static Uint32 rotl(const Uint32 &x, const int &k) {
+      return (x << k) | (x >> (32 - k));
+    }
+
+    /// Get a uniformly distributed integer in the range [0, range) (Lemire's method)
+    Uint32 bounded(const Uint32 &range) {
+      Uint64 product = Uint64(rand_u32()) * range;
+      Uint32 low = Uint32(product);
+
+      if(low < range) {
+        const Uint32 threshold = (0u - range) % range;
+        while(low < threshold) {
+          product = Uint64(rand_u32()) * range;
+          low = Uint32(product);
+        }
+      }
+
+      return Uint32(product >> 32);
+    }
+
+    void jump_by(const Uint32 * const polynomial);
+
+    Uint32 m_state[4];
   };
 
 }
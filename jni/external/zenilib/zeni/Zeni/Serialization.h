@@ -28,6 +28,11 @@
  * where only part of a class should be sent or received at a time, it is 
  * not the way to go.  Go higher level in those cases.
  *
+ * Strings and containers are prefixed by their size in 16 bits, as they
+ * always have been.  Sizes of 65535 and up are written as 65535 followed
+ * by the actual size in 32 bits, so anything smaller is unchanged on the
+ * wire.
+ *
  * \author bazald
  *
  * Contact: bazald@zenipex.com
@@ -40,6 +45,7 @@
 
 #include <SDL/SDL_net.h>
 
+#include <algorithm>
 #include <iostream>
 #include <list>
 #include <set>
@@ -110,6 +116,7 @@ namespace Zeni {
   //ZENI_DLL std::ostream & serialize(std::ostream &os, const bool &value);
   ZENI_DLL std::ostream & serialize(std::ostream &os, const IPaddress &address);
   ZENI_DLL std::ostream & serialize(std::ostream &os, const String &string);
+  ZENI_DLL std::ostream & serialize_size(std::ostream &os, const Uint32 &size); ///< 16 bits, or 65535 and then 32 bits
   
   inline std::istream & unserialize(std::istream &is, Serializable &value) {return value.unserialize(is);}
 
@@ -125,10 +132,11 @@ namespace Zeni {
   //ZENI_DLL std::istream & unserialize(std::istream &is, bool &value);
   ZENI_DLL std::istream & unserialize(std::istream &is, IPaddress &address);
   ZENI_DLL std::istream & unserialize(std::istream &is, String &string);
+  ZENI_DLL std::istream & unserialize_size(std::istream &is, Uint32 &size);
 
   template <typename TYPE>
   std::ostream & serialize(std::ostream &os, const std::list<TYPE> &list_) {
-    Zeni::serialize(os, static_cast<Uint16>(list_.size()));
+    Zeni::serialize_size(os, static_cast<Uint32>(list_.size()));
     for(typename std::list<TYPE>::const_iterator it = list_.begin(); it != list_.end(); ++it)
       if(!serialize(os, *it))
         break;
@@ -139,10 +147,10 @@ namespace Zeni {
   std::istream & unserialize(std::istream &is, std::list<TYPE> &list_) {
     list_.clear();
 
-    Uint16 size;
-    if(Zeni::unserialize(is, size)) {
+    Uint32 size;
+    if(Zeni::unserialize_size(is, size)) {
       TYPE el;
-      for(Uint16 i = 0u; i != size; ++i) {
+      for(Uint32 i = 0u; i != size; ++i) {
         if(!unserialize(is, el))
           break;
         list_.push_back(el);
@@ -153,7 +161,7 @@ namespace Zeni {
 
   template <typename TYPE>
   std::ostream & serialize(std::ostream &os, const std::set<TYPE> &list_) {
-    Zeni::serialize(os, static_cast<Uint16>(list_.size()));
+    Zeni::serialize_size(os, static_cast<Uint32>(list_.size()));
     for(typename std::set<TYPE>::const_iterator it = list_.begin(); it != list_.end(); ++it)
       if(!serialize(os, *it))
         break;
@@ -164,10 +172,10 @@ namespace Zeni {
   std::istream & unserialize(std::istream &is, std::set<TYPE> &list_) {
     list_.clear();
 
-    Uint16 size;
-    if(Zeni::unserialize(is, size)) {
+    Uint32 size;
+    if(Zeni::unserialize_size(is, size)) {
       TYPE el;
-      for(Uint16 i = 0u; i != size; ++i) {
+      for(Uint32 i = 0u; i != size; ++i) {
         if(!unserialize(is, el))
           break;
         list_.insert(el);
@@ -178,7 +186,7 @@ namespace Zeni {
 
   template <typename TYPE>
   std::ostream & serialize(std::ostream &os, const std::vector<TYPE> &list_) {
-    if(Zeni::serialize(os, static_cast<Uint16>(list_.size())))
+    if(Zeni::serialize_size(os, static_cast<Uint32>(list_.size())))
       for(typename std::vector<TYPE>::const_iterator it = list_.begin(); it != list_.end(); ++it)
         if(!serialize(os, *it))
           break;
@@ -189,11 +197,12 @@ namespace Zeni {
   std::istream & unserialize(std::istream &is, std::vector<TYPE> &list_) {
     list_.clear();
 
-    Uint16 size;
-    if(Zeni::unserialize(is, size)) {
+    Uint32 size;
+    if(Zeni::unserialize_size(is, size)) {
       TYPE el;
-      list_.reserve(size);
-      for(Uint16 i = 0u; i != size; ++i) {
+      // No more than a 16-bit size could ask for until the elements actually arrive
+      list_.reserve(std::min(size, Uint32(0xFFFFu)));
+      for(Uint32 i = 0u; i != size; ++i) {
         if(!unserialize(is, el))
           break;
         list_.push_back(el);
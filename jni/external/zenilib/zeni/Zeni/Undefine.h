@@ -49,6 +49,20 @@
 // Net.h
 #undef ZENI_DEFAULT_CHUNK_SIZE
 #undef ZENI_DEFAULT_CHUNK_SETS
+#undef ZENI_DEFAULT_CHUNK_TIMEOUT
+#undef ZENI_DEFAULT_MAX_MESSAGE_SIZE
+
+// Net_Compressor.h
+#undef ZENI_DEFAULT_COMPRESSION_THRESHOLD
+#undef ZENI_DEFAULT_COMPRESSION_LEVEL
+
+// Net_Async.h
+#undef ZENI_DEFAULT_LOOKUP_TIMEOUT
+#undef ZENI_DEFAULT_CONNECT_TIMEOUT
+
+// Net_Thread.h
+#undef ZENI_DEFAULT_NET_THREAD_QUEUE_SIZE
+#undef ZENI_DEFAULT_NET_THREAD_PACKET_SIZE
 
 // Sound_Source.h
 #undef ZENI_DEFAULT_PITCH
@@ -77,6 +91,12 @@
 
 // Collision.cpp
 #undef ZENI_COLLISION_EPSILON
+#undef ZENI_COLLISION_QUERY
+
+// Matrix4f.cpp, Random.cpp
+#undef ZENI_SIMD_SSE
+#undef ZENI_SIMD_SSE2
+#undef ZENI_SIMD_NEON
 
 // Configurator_Video.cpp
 #undef ZENI_REVERT_TIMEOUT
@@ -98,6 +118,11 @@
 #undef ZENI_DEFAULT_II_JOYSTICK_MAX
 #undef ZENI_DEFAULT_II_MOUSE_MIN
 #undef ZENI_DEFAULT_II_MOUSE_MAX
+#undef ZENI_II_DENSE_CONTROLLERS
+
+// Job_System.cpp
+#undef ZENI_JOB_DEQUE_CAPACITY
+#undef ZENI_JOB_SPINS_BEFORE_SLEEP
 
 // Material.cpp
 #undef ZENI_DIFFUSE_TO_SPECULAR
@@ -105,6 +130,11 @@
 // Net_Primitives.cpp
 #undef ZENI_SPRINTF_BUFFER_SIZE
 
+// Profiler.cpp
+#undef ZENI_PROFILER_BUFFER_SIZE
+#undef ZENI_PROFILER_MAX_DEPTH
+#undef ZENI_THREAD_LOCAL
+
 // Texture.cpp
 #undef ZENI_MAX_TEXTURE_WIDTH
 #undef ZENI_MAX_TEXTURE_HEIGHT
@@ -24,4 +24,4 @@ project "zeni"
 --     pchsource "jni/external/zenilib/zeni/String.cpp"
 
     files { "**.h", "**.hxx", "**.cpp" }
-    links { "local_tinyxml" }
+    links { "local_tinyxml", "local_SDL" }
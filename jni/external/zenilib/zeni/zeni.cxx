@@ -23,7 +23,10 @@
 #include "Zeni/Colors.cpp"
 #include "Zeni/Coordinate.cpp"
 #include "Zeni/File_Ops.cpp"
+#include "Zeni/Frustum.cpp"
 #include "Zeni/Matrix4f.cpp"
+#include "Zeni/Pool.cpp"
+#include "Zeni/Profiler.cpp"
 #include "Zeni/Quaternion.cpp"
 #include "Zeni/Quit_Event.cpp"
 #include "Zeni/Random.cpp"
@@ -43,6 +43,8 @@
 #endif
 
 #include <Zeni/Android.h>
+#include <Zeni/Bounding_Volume_Hierarchy.h>
+#include <Zeni/Byte_Writer.h>
 #include <Zeni/Camera.h>
 #include <Zeni/Chronometer.h>
 #include <Zeni/Collision.h>
@@ -51,8 +53,11 @@
 #include <Zeni/Coordinate.h>
 #include <Zeni/Database.h>
 #include <Zeni/File_Ops.h>
+#include <Zeni/Frustum.h>
 #include <Zeni/Hash_Map.h>
 #include <Zeni/Matrix4f.h>
+#include <Zeni/Pool.h>
+#include <Zeni/Profiler.h>
 #include <Zeni/Quaternion.h>
 #include <Zeni/Quit_Event.h>
 #include <Zeni/Random.h>
@@ -63,10 +68,13 @@
 #include <Zeni/Vector3f.h>
 #include <Zeni/XML.h>
 
+#include <Zeni/Bounding_Volume_Hierarchy.hxx>
+#include <Zeni/Byte_Writer.hxx>
 #include <Zeni/Camera.hxx>
 #include <Zeni/Collision.hxx>
 #include <Zeni/Color.hxx>
 #include <Zeni/Coordinate.hxx>
+#include <Zeni/Frustum.hxx>
 #include <Zeni/Matrix4f.hxx>
 #include <Zeni/Quaternion.hxx>
 #include <Zeni/Resource.hxx>
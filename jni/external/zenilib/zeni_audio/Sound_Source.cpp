@@ -97,6 +97,11 @@ namespace Zeni {
     uninit();
   }
 
+  Pool & Sound_Source_HW::get_pool() {
+    static Pool * const pool = new Pool(sizeof(Sound_Source_HW), 16u); // Never destroyed, so Sound_Source_HW can still be freed during static destruction
+    return *pool;
+  }
+
   Sound_Source_HW * Sound_Source_HW::Try_Construct() {
     ALuint source = AL_NONE;
 #ifndef DISABLE_AL
@@ -526,6 +531,11 @@ namespace Zeni {
 #endif
   }
 
+  Pool & Sound_Source::get_pool() {
+    static Pool * const pool = new Pool(sizeof(Sound_Source)); // Never destroyed, so Sound_Sources can still be freed during static destruction
+    return *pool;
+  }
+
   Sound_Source::Sound_Source()
     : m_hw(0),
     m_priority(ZENI_DEFAULT_SOUND_PRIORITY),
@@ -188,35 +188,29 @@ namespace Zeni {
     if(size < 2)
       return;
 
-    std::vector<Sound_Source *> less, greater;
-    std::vector<Sound_Source *>::iterator pivot = begin + size / 2;
-    Sound_Source * const pivotValue = *pivot;
-
-    for(std::vector<Sound_Source *>::iterator x = begin; x != end; ++x)
-      if(x != pivot) {
-        if(policy(*x, pivotValue))
-          less.push_back(*x);
-        else
-          greater.push_back(*x);
-      }
+    // Partition in place, with the pivot parked at the back, to avoid allocating every frame
+    const std::vector<Sound_Source *>::iterator last = end - 1;
+    std::iter_swap(begin + size / 2, last);
+    Sound_Source * const pivotValue = *last;
 
-    const std::vector<Sound_Source *>::iterator less_end = std::copy(less.begin(), less.end(), begin);
-    *less_end = pivotValue;
-    const std::vector<Sound_Source *>::iterator greater_begin = less_end + 1;
-    std::copy(greater.begin(), greater.end(), greater_begin);
+    std::vector<Sound_Source *>::iterator less_end = begin;
+    for(std::vector<Sound_Source *>::iterator x = begin; x != last; ++x)
+      if(policy(*x, pivotValue))
+        std::iter_swap(x, less_end++);
 
-    less.clear();
-    greater.clear();
+    std::iter_swap(less_end, last);
+    const std::vector<Sound_Source *>::iterator greater_begin = less_end + 1;
 
     sound_quicksort(begin, less_end, policy);
     sound_quicksort(greater_begin, end, policy);
   }
 
   void Sound_Source_Pool::update() {
+    ZENI_PROFILE_SCOPE("Sound_Source_Pool::update");
+
     /*** Handle the playing and destroying ***/
 
-    std::vector<Sound_Source *> keepers;
-    keepers.reserve(m_playing_and_destroying.size());
+    std::vector<Sound_Source *>::iterator keepers_end = m_playing_and_destroying.begin();
     for(std::vector<Sound_Source *>::iterator it = m_playing_and_destroying.begin();
         it != m_playing_and_destroying.end();
         ++it)
@@ -226,9 +220,9 @@ namespace Zeni {
         delete *it;
       }
       else
-        keepers.push_back(*it);
+        *keepers_end++ = *it;
     }
-    m_playing_and_destroying.swap(keepers);
+    m_playing_and_destroying.erase(keepers_end, m_playing_and_destroying.end());
 
     /*** If muted, skip the rest of the update ***/
 
@@ -237,7 +231,8 @@ namespace Zeni {
 
     /*** Do the regular update ***/
 
-    std::vector<Sound_Source_HW *> unassigned_hw;
+    std::vector<Sound_Source_HW *> &unassigned_hw = m_unassigned_hw;
+    unassigned_hw.clear();
     const size_t needed_hw = m_handles.size();
     size_t given_hw = 0;
 
@@ -56,6 +56,7 @@
 
 #include <Zeni/Coordinate.h>
 #include <Zeni/Error.h>
+#include <Zeni/Pool.h>
 #include <Zeni/Sound.h>
 #include <Zeni/Timer_HQ.h>
 #include <Zeni/Vector3f.h>
@@ -83,6 +84,16 @@ namespace Zeni {
 
     static Sound_Source_HW * Try_Construct();
 
+    // Allocation from a Pool; Defined here, before DEBUG_NEW can redefine 'new'
+    static void * operator new(size_t size) {return get_pool().allocate(size);}
+    static void operator delete(void * ptr, size_t size) {get_pool().deallocate(ptr, size);}
+#if defined(_DEBUG) && defined(_WINDOWS)
+    static void * operator new(size_t size, int, const char *, int) {return get_pool().allocate(size);}
+    static void operator delete(void * ptr, int, const char *, int) {get_pool().deallocate(ptr, sizeof(Sound_Source_HW));}
+#endif
+
+    static Pool & get_pool();
+
   public:
     enum STATE {STOPPED, PAUSED, PLAYING};
 
@@ -198,7 +209,17 @@ namespace Zeni {
 
     inline bool is_assigned() const; ///< Check to see if the Sound_Source is assigned to actual hardware.
 
+    // Allocation from a Pool, since play_sound creates one per effect; Defined here, before DEBUG_NEW can redefine 'new'
+    static void * operator new(size_t size) {return get_pool().allocate(size);}
+    static void operator delete(void * ptr, size_t size) {get_pool().deallocate(ptr, size);}
+#if defined(_DEBUG) && defined(_WINDOWS)
+    static void * operator new(size_t size, int, const char *, int) {return get_pool().allocate(size);}
+    static void operator delete(void * ptr, int, const char *, int) {get_pool().deallocate(ptr, sizeof(Sound_Source));}
+#endif
+
   private:
+    static Pool & get_pool();
+
     void assign(Sound_Source_HW &hw);
     Sound_Source_HW * unassign();
 
@@ -125,6 +125,7 @@ namespace Zeni {
 #endif
     std::vector<Sound_Source *> m_handles;
     std::vector<Sound_Source *> m_playing_and_destroying;
+    std::vector<Sound_Source_HW *> m_unassigned_hw; ///< Scratch space for update(), kept to avoid reallocating every frame
 #ifdef _WINDOWS
 #pragma warning( pop )
 #endif
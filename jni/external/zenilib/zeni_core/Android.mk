@@ -9,6 +9,8 @@ LOCAL_C_INCLUDES += . $(LOCAL_PATH)/../zeni $(LOCAL_PATH)/../../tinyxml $(LOCAL_
 #LOCAL_SRC_FILES := zeni_core.cxx
 LOCAL_SRC_FILES := \
   Core.cpp \
+  Frame_Limiter.cpp \
+  Job_System.cpp \
   Joysticks.cpp \
   Timer.cpp
 LOCAL_LDLIBS    := -landroid -llog
@@ -0,0 +1,93 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_core.h>
+
+#include <SDL/SDL.h>
+
+namespace Zeni {
+
+  Frame_Limiter::Frame_Limiter(const double &spin_threshold)
+    : m_spin_threshold(spin_threshold),
+    m_period(0.0),
+    m_next(0.0),
+    m_window_start(0.0),
+    m_error_sum(0.0),
+    m_error_max(0.0),
+    m_samples(0lu),
+    m_jitter(0.0),
+    m_jitter_max(0.0)
+  {
+  }
+
+  double Frame_Limiter::wait(const double &fps) {
+    Timer &tr = get_Timer();
+    const double start = tr.get_seconds();
+
+    if(fps <= 0.0) {
+      m_period = 0.0;
+      return 0.0;
+    }
+
+    const double period = 1.0 / fps;
+    if(period != m_period) {
+      m_period = period;
+      m_next = start + period;
+      m_window_start = start;
+      m_error_sum = 0.0;
+      m_error_max = 0.0;
+      m_samples = 0lu;
+      return 0.0;
+    }
+
+    ZENI_PROFILE_SCOPE("Frame_Limiter::wait");
+
+    const double sleep = m_next - start - m_spin_threshold;
+    if(sleep >= 0.001)
+      SDL_Delay(Uint32(sleep * 1000.0));
+
+    double now = tr.get_seconds();
+    while(now < m_next)
+      now = tr.get_seconds();
+
+    const double error = now - m_next;
+    m_error_sum += error;
+    if(error > m_error_max)
+      m_error_max = error;
+    ++m_samples;
+
+    if(now - m_window_start >= 1.0) {
+      m_jitter = m_error_sum / m_samples;
+      m_jitter_max = m_error_max;
+      m_window_start = now;
+      m_error_sum = 0.0;
+      m_error_max = 0.0;
+      m_samples = 0lu;
+    }
+
+    m_next += period;
+    if(m_next < now)
+      m_next = now + period;
+
+    return now - start;
+  }
+
+  void Frame_Limiter::set_spin_threshold(const double &spin_threshold) {
+    m_spin_threshold = spin_threshold;
+  }
+
+}
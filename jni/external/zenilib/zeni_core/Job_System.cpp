@@ -0,0 +1,415 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_core.h>
+
+#include <cassert>
+
+#if defined(_DEBUG) && defined(_WINDOWS)
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+
+#include <Zeni/Singleton.hxx>
+
+#include <Zeni/Define.h>
+
+namespace Zeni {
+
+  /// Counters wrap, so compare them by their difference
+  static int job_distance(const int &from, const int &to) {
+    return int(Uint32(to) - Uint32(from));
+  }
+
+  struct Job_Deque {
+    Job_Deque(Job_System &system_)
+      : system(system_),
+      victim(0u)
+    {
+      SDL_AtomicSet(&top, 0);
+      SDL_AtomicSet(&bottom, 0);
+    }
+
+    // Owning thread only; Fails when full
+    bool push(Job * const &job) {
+      const int b = bottom.value;
+      const int t = SDL_AtomicGet(&top);
+
+      if(job_distance(t, b) >= int(ZENI_JOB_DEQUE_CAPACITY))
+        return false;
+
+      jobs[Uint32(b) % ZENI_JOB_DEQUE_CAPACITY] = job;
+
+      // Publish the Job before the new bottom
+      SDL_MemoryBarrierRelease();
+      SDL_AtomicSet(&bottom, b + 1);
+
+      return true;
+    }
+
+    // Owning thread only
+    Job * pop() {
+      // Claim the bottom Job before looking at top (SDL_AtomicAdd is a full barrier)
+      const int b = SDL_AtomicAdd(&bottom, -1) - 1;
+      const int t = SDL_AtomicGet(&top);
+
+      if(job_distance(t, b) < 0) {
+        SDL_AtomicSet(&bottom, b + 1);
+        return 0;
+      }
+
+      Job * job = jobs[Uint32(b) % ZENI_JOB_DEQUE_CAPACITY];
+
+      if(t == b) {
+        // The last Job may be stolen out from under us
+        if(!SDL_AtomicCAS(&top, t, t + 1))
+          job = 0;
+        SDL_AtomicSet(&bottom, t + 1);
+      }
+
+      return job;
+    }
+
+    // Any thread
+    Job * steal() {
+      const int t = SDL_AtomicGet(&top);
+      const int b = SDL_AtomicGet(&bottom);
+
+      if(job_distance(t, b) <= 0)
+        return 0;
+
+      Job * const job = jobs[Uint32(t) % ZENI_JOB_DEQUE_CAPACITY];
+
+      return SDL_AtomicCAS(&top, t, t + 1) ? job : 0;
+    }
+
+    Job_System &system;
+    size_t victim;
+
+    // Keep the ends of the deque on separate cache lines
+    char padding0[64];
+    SDL_atomic_t top;
+    char padding1[64];
+    SDL_atomic_t bottom;
+    char padding2[64];
+
+    Job * volatile jobs[ZENI_JOB_DEQUE_CAPACITY];
+  };
+
+  static ZENI_THREAD_LOCAL Job_Deque * t_job_deque = 0;
+
+  Job_Group::Job_Group()
+    : m_mutex(SDL_CreateMutex())
+  {
+    SDL_AtomicSet(&m_pending, 0);
+    SDL_AtomicSet(&m_finishing, 0);
+  }
+
+  Job_Group::~Job_Group() {
+    if(!is_done())
+      get_Job_System().wait(*this);
+
+    SDL_DestroyMutex(m_mutex);
+  }
+
+  bool Job_Group::is_done() const {
+    // A finishing thread may still be using the Job_Group after m_pending reaches 0
+    return !SDL_AtomicGet(&m_pending) && !SDL_AtomicGet(&m_finishing);
+  }
+
+  template class Singleton<Job_System>;
+
+  Job_System * Job_System::create() {
+    return new Job_System;
+  }
+
+  Singleton<Job_System>::Uninit Job_System::g_uninit;
+  Singleton<Job_System>::Reinit Job_System::g_reinit;
+
+  size_t Job_System::g_num_workers = size_t(-1);
+
+  Job_System::Job_System()
+    : m_main_thread(SDL_ThreadID()),
+    m_wake(SDL_CreateSemaphore(0u)),
+    m_shared_mutex(SDL_CreateMutex()),
+    m_main_mutex(SDL_CreateMutex())
+  {
+    Core::remove_post_reinit(&g_reinit);
+
+    // Ensure Core is initialized
+    Core &cr = get_Core();
+
+    SDL_AtomicSet(&m_num_sleeping, 0);
+    SDL_AtomicSet(&m_quit, 0);
+    SDL_AtomicSet(&m_num_shared, 0);
+    SDL_AtomicSet(&m_num_main, 0);
+
+    size_t num_workers = g_num_workers;
+    if(num_workers == size_t(-1)) {
+      const int cpus = SDL_GetCPUCount();
+      num_workers = cpus > 1 ? size_t(cpus - 1) : 0u;
+    }
+
+    m_deques.push_back(new Job_Deque(*this));
+    t_job_deque = m_deques[0];
+
+    for(size_t i = 0u; i != num_workers; ++i) {
+      Job_Deque * const deque = new Job_Deque(*this);
+      deque->victim = i + 1u;
+      m_deques.push_back(deque);
+    }
+
+    for(size_t i = 0u; i != num_workers; ++i) {
+      SDL_Thread * const thread = SDL_CreateThread(&worker, "Zeni::Job_System", m_deques[i + 1u]);
+      if(!thread)
+        break;
+      m_workers.push_back(thread);
+    }
+
+    cr.lend_pre_uninit(&g_uninit);
+    cr.lend_post_reinit(&g_reinit);
+  }
+
+  Job_System::~Job_System() {
+    Core::remove_pre_uninit(&g_uninit);
+
+    SDL_AtomicSet(&m_quit, 1);
+    for(size_t i = 0u; i != m_workers.size(); ++i)
+      SDL_SemPost(m_wake);
+
+    for(std::vector<SDL_Thread *>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+      SDL_WaitThread(*it, 0);
+
+    if(t_job_deque && &t_job_deque->system == this)
+      t_job_deque = 0;
+
+    for(std::vector<Job_Deque *>::iterator it = m_deques.begin(); it != m_deques.end(); ++it)
+      delete *it;
+
+    SDL_DestroyMutex(m_main_mutex);
+    SDL_DestroyMutex(m_shared_mutex);
+    SDL_DestroySemaphore(m_wake);
+  }
+
+  void Job_System::preinit_num_workers(const size_t &num_workers) {
+    g_num_workers = num_workers;
+  }
+
+  bool Job_System::is_main_thread() const {
+    return SDL_ThreadID() == m_main_thread;
+  }
+
+  void Job_System::run(Job &job, Job_Group &group) {
+    job.m_group = &group;
+    SDL_AtomicIncRef(&group.m_pending);
+    schedule(job);
+  }
+
+  void Job_System::run_after(Job_Group &dependency, Job &job, Job_Group &group) {
+    job.m_group = &group;
+    SDL_AtomicIncRef(&group.m_pending);
+
+    SDL_LockMutex(dependency.m_mutex);
+    if(SDL_AtomicGet(&dependency.m_pending)) {
+      dependency.m_continuations.push_back(&job);
+      SDL_UnlockMutex(dependency.m_mutex);
+    }
+    else {
+      SDL_UnlockMutex(dependency.m_mutex);
+      schedule(job);
+    }
+  }
+
+  void Job_System::run_on_main_thread(Job &job, Job_Group &group) {
+    job.m_group = &group;
+    SDL_AtomicIncRef(&group.m_pending);
+
+    SDL_LockMutex(m_main_mutex);
+    m_main.push_back(&job);
+    SDL_AtomicIncRef(&m_num_main);
+    SDL_UnlockMutex(m_main_mutex);
+  }
+
+  void Job_System::wait(Job_Group &group) {
+    Job_Deque * const own = t_job_deque && &t_job_deque->system == this ? t_job_deque : 0;
+    const bool main_thread = own == m_deques[0];
+
+    while(!group.is_done()) {
+      if(main_thread && run_main_thread_job())
+        continue;
+
+      if(Job * const job = find_job(own))
+        execute(*job);
+    }
+  }
+
+  void Job_System::run_main_thread_jobs() {
+    assert(is_main_thread());
+
+    // Jobs scheduled by these Jobs wait for the next frame
+    for(int i = SDL_AtomicGet(&m_num_main); i > 0; --i)
+      run_main_thread_job();
+  }
+
+  int Job_System::worker(void * deque_) {
+    Job_Deque &deque = *reinterpret_cast<Job_Deque *>(deque_);
+    Job_System &system = deque.system;
+
+    t_job_deque = &deque;
+
+    for(unsigned int spins = 0u; !SDL_AtomicGet(&system.m_quit);) {
+      if(Job * const job = system.find_job(&deque)) {
+        system.execute(*job);
+        spins = 0u;
+        continue;
+      }
+
+      if(++spins < ZENI_JOB_SPINS_BEFORE_SLEEP)
+        continue;
+      spins = 0u;
+
+      // Announce the intent to sleep before looking one last time, so wake() cannot miss it
+      SDL_AtomicIncRef(&system.m_num_sleeping);
+
+      Job * const job = system.find_job(&deque);
+      if(!job && !SDL_AtomicGet(&system.m_quit))
+        SDL_SemWait(system.m_wake);
+
+      SDL_AtomicAdd(&system.m_num_sleeping, -1);
+
+      if(job)
+        system.execute(*job);
+    }
+
+    t_job_deque = 0;
+
+    return 0;
+  }
+
+  void Job_System::schedule(Job &job) {
+    Job_Deque * const own = t_job_deque && &t_job_deque->system == this ? t_job_deque : 0;
+
+    if(!own || !own->push(&job)) {
+      SDL_LockMutex(m_shared_mutex);
+      m_shared.push_back(&job);
+      SDL_AtomicIncRef(&m_num_shared);
+      SDL_UnlockMutex(m_shared_mutex);
+    }
+
+    wake();
+  }
+
+  Job * Job_System::find_job(Job_Deque * const &own) {
+    if(own) {
+      if(Job * const job = own->pop())
+        return job;
+    }
+
+    if(SDL_AtomicGet(&m_num_shared)) {
+      Job * job = 0;
+
+      SDL_LockMutex(m_shared_mutex);
+      if(!m_shared.empty()) {
+        job = m_shared.front();
+        m_shared.pop_front();
+        SDL_AtomicAdd(&m_num_shared, -1);
+      }
+      SDL_UnlockMutex(m_shared_mutex);
+
+      if(job)
+        return job;
+    }
+
+    // Start from a different victim each time to spread out the thieves
+    const size_t num_deques = m_deques.size();
+    const size_t first = own ? ++own->victim : 0u;
+
+    for(size_t i = 0u; i != num_deques; ++i) {
+      Job_Deque * const victim = m_deques[(first + i) % num_deques];
+      if(victim != own) {
+        if(Job * const job = victim->steal())
+          return job;
+      }
+    }
+
+    return 0;
+  }
+
+  bool Job_System::run_main_thread_job() {
+    if(!SDL_AtomicGet(&m_num_main))
+      return false;
+
+    Job * job = 0;
+
+    SDL_LockMutex(m_main_mutex);
+    if(!m_main.empty()) {
+      job = m_main.front();
+      m_main.pop_front();
+      SDL_AtomicAdd(&m_num_main, -1);
+    }
+    SDL_UnlockMutex(m_main_mutex);
+
+    if(!job)
+      return false;
+
+    execute(*job);
+
+    return true;
+  }
+
+  void Job_System::execute(Job &job) {
+    Job_Group &group = *job.m_group;
+
+    {
+      ZENI_PROFILE_SCOPE("Job");
+
+      job();
+    }
+
+    finish(group);
+  }
+
+  void Job_System::finish(Job_Group &group) {
+    SDL_AtomicIncRef(&group.m_finishing);
+
+    if(SDL_AtomicAdd(&group.m_pending, -1) == 1) {
+      std::vector<Job *> continuations;
+
+      SDL_LockMutex(group.m_mutex);
+      continuations.swap(group.m_continuations);
+      SDL_UnlockMutex(group.m_mutex);
+
+      for(std::vector<Job *>::iterator it = continuations.begin(); it != continuations.end(); ++it)
+        schedule(**it);
+    }
+
+    // The Job_Group may be destroyed as soon as this is done
+    SDL_AtomicAdd(&group.m_finishing, -1);
+  }
+
+  void Job_System::wake() {
+    if(SDL_AtomicGet(&m_num_sleeping) > 0 && SDL_SemValue(m_wake) < Uint32(SDL_AtomicGet(&m_num_sleeping)))
+      SDL_SemPost(m_wake);
+  }
+
+  Job_System & get_Job_System() {
+    return Job_System::get();
+  }
+
+}
+
+#include <Zeni/Undefine.h>
@@ -28,24 +28,15 @@
 namespace Zeni {
 
   Time::Time(const Time::Tick_Type &ticks)
-    : m_ticks(ticks)
+    : m_useconds(Uint64(ticks) * 1000u)
   {
   }
 
   Time::Time()
-    : m_ticks(get_Timer().get_ticks())
+    : m_useconds(get_Timer().get_useconds())
   {
   }
 
-  void Timer::update() {
-#ifdef ANDROID
-    Timer_HQ &tr = get_Timer_HQ();
-    m_ticks = 1000lu * tr.get_ticks() / tr.get_ticks_per_second();
-#else
-    m_ticks = SDL_GetTicks();
-#endif
-  }
-
   template class Singleton<Timer>;
   template class Chronometer<Time>;
 
@@ -56,7 +47,10 @@ namespace Zeni {
   Singleton<Timer>::Uninit Timer::g_uninit;
   Singleton<Timer>::Reinit Timer::g_reinit;
 
-  Timer::Timer() {
+  Timer::Timer()
+    : m_start(SDL_GetPerformanceCounter()),
+    m_frequency(SDL_GetPerformanceFrequency())
+  {
     Core::remove_post_reinit(&g_reinit);
 
     // Ensure Core is initialized
@@ -0,0 +1,75 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Frame_Limiter
+ *
+ * \ingroup zenilib
+ *
+ * \brief Frame Pacing
+ *
+ * wait() blocks until the next frame is due at a given rate.  Most of the
+ * wait is spent asleep in SDL_Delay, which is only accurate to a
+ * millisecond or so; the last get_spin_threshold() seconds are spent
+ * polling the Timer so that frames start on time.
+ *
+ * Frames are scheduled at fixed intervals rather than relative to the end
+ * of the previous wait, so short frames make up for long ones.  If a frame
+ * falls more than a whole interval behind, the schedule starts over.
+ *
+ * The jitter statistics describe how late frames started relative to
+ * their schedule, over the last complete second of waiting.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_FRAME_LIMITER_H
+#define ZENI_FRAME_LIMITER_H
+
+namespace Zeni {
+
+  class ZENI_CORE_DLL Frame_Limiter {
+  public:
+    Frame_Limiter(const double &spin_threshold = 0.002);
+
+    double wait(const double &fps); ///< Wait until the next frame is due at 'fps' frames per second; Returns the seconds waited; 0 fps never waits
+
+    const double & get_spin_threshold() const {return m_spin_threshold;} ///< Get the number of seconds at the end of each wait spent spinning instead of sleeping
+    void set_spin_threshold(const double &spin_threshold = 0.002); ///< Set the number of seconds at the end of each wait spent spinning instead of sleeping
+
+    const double & get_jitter() const {return m_jitter;} ///< Get the mean number of seconds late each frame started
+    const double & get_jitter_max() const {return m_jitter_max;} ///< Get the most seconds late any frame started
+
+  private:
+    double m_spin_threshold;
+    double m_period;
+    double m_next;
+
+    double m_window_start;
+    double m_error_sum;
+    double m_error_max;
+    unsigned long m_samples;
+
+    double m_jitter;
+    double m_jitter_max;
+  };
+
+}
+
+#endif
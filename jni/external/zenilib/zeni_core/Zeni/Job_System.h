@@ -0,0 +1,248 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Job
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Unit of Work for the Job_System
+ *
+ * Derive from Job and implement operator()().  The Job_System neither
+ * copies nor deletes a Job, so it must outlive the wait() on its
+ * Job_Group, and it may only be scheduled again once it has finished.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+/**
+ * \class Zeni::Job_Group
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Set of Jobs to Wait On
+ *
+ * Every Job is scheduled as part of a Job_Group.  The group is done once
+ * every Job in it has finished, including Jobs added while it was
+ * running and continuations added with Job_System::run_after().
+ *
+ * Destroying a Job_Group waits for it first.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+/**
+ * \class Zeni::Job_System
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Work-Stealing Job System Singleton
+ *
+ * The Job_System starts one worker thread for each CPU core beyond the
+ * first, unless told otherwise by preinit_num_workers().  The main thread
+ * (the one that first calls get_Job_System()) and each worker own a
+ * Chase-Lev deque.  A thread pushes and pops Jobs at the bottom of its own
+ * deque without locking, and idle threads steal from the tops of the
+ * others.  Jobs scheduled from any other thread go to a shared queue.
+ *
+ * Jobs that must call into OpenGL or OpenAL can be scheduled with
+ * run_on_main_thread().  Game runs them once per frame, and wait() runs
+ * them while the main thread is waiting.
+ *
+ * parallel_for() splits an index range into Jobs and waits for them all.
+ * With ENABLE_BENCHMARKS defined, the Console_State command 'job_scaling'
+ * times it with 1 to N threads.
+ *
+ * Worker threads are stopped when the Job_System is destroyed, which
+ * happens along with Core.
+ *
+ * \note Jobs must not throw.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_JOB_SYSTEM_H
+#define ZENI_JOB_SYSTEM_H
+
+#include <Zeni/Singleton.h>
+
+#include <SDL/SDL.h>
+
+/* \cond */
+#include <cstddef>
+#include <deque>
+#include <vector>
+/* \endcond */
+
+namespace Zeni {
+
+  class ZENI_CORE_DLL Job_Group;
+  class ZENI_CORE_DLL Job_System;
+  struct Job_Deque;
+
+  class ZENI_CORE_DLL Job {
+    friend class Job_System;
+
+    Job & operator=(const Job &);
+
+  public:
+    Job() : m_group(0) {}
+    Job(const Job &) : m_group(0) {} ///< Copies nothing of the original's scheduling
+    virtual ~Job() {}
+
+    virtual void operator()() = 0;
+
+  private:
+    Job_Group * m_group;
+  };
+
+  class ZENI_CORE_DLL Job_Group {
+    friend class Job_System;
+
+    // Undefined
+    Job_Group(const Job_Group &);
+    Job_Group & operator=(const Job_Group &);
+
+  public:
+    Job_Group();
+    ~Job_Group();
+
+    bool is_done() const; ///< Check whether every Job in the group has finished
+
+  private:
+    mutable SDL_atomic_t m_pending;
+    mutable SDL_atomic_t m_finishing;
+    SDL_mutex * m_mutex;
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::vector<Job *> m_continuations;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  };
+
+  template <typename FUNCTION>
+  class Job_Range : public Job {
+  public:
+    Job_Range() : m_function(0), m_begin(0u), m_end(0u) {}
+
+    inline void set(FUNCTION &function, const size_t &begin, const size_t &end);
+
+    inline void operator()(); ///< Call function(begin, end)
+
+  private:
+    FUNCTION * m_function;
+    size_t m_begin;
+    size_t m_end;
+  };
+
+#ifdef _WINDOWS
+  ZENI_CORE_EXT template class ZENI_CORE_DLL Singleton<Job_System>;
+#endif
+
+  class ZENI_CORE_DLL Job_System : public Singleton<Job_System> {
+    friend class Singleton<Job_System>;
+
+    static Job_System * create();
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    static Uninit g_uninit;
+    static Reinit g_reinit;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+
+    Job_System();
+    ~Job_System();
+
+    // Undefined
+    Job_System(const Job_System &);
+    Job_System & operator=(const Job_System &);
+
+  public:
+    static void preinit_num_workers(const size_t &num_workers = size_t(-1)); ///< Set the number of worker threads to start; Defaults to one fewer than the number of CPU cores
+    static const size_t & get_preinit_num_workers() {return g_num_workers;} ///< Get the number of worker threads set by preinit_num_workers(); size_t(-1) for the default
+
+    // Accessors
+    size_t get_num_workers() const {return m_workers.size();} ///< Get the number of worker threads
+    size_t get_num_threads() const {return m_workers.size() + 1u;} ///< Get the number of threads that run Jobs, including the main thread
+    bool is_main_thread() const; ///< Check whether the calling thread is the main thread
+
+    // Scheduling
+    void run(Job &job, Job_Group &group); ///< Schedule a Job on any thread
+    void run_after(Job_Group &dependency, Job &job, Job_Group &group); ///< Schedule a Job once every Job in 'dependency' has finished
+    void run_on_main_thread(Job &job, Job_Group &group); ///< Schedule a Job on the main thread, e.g. to call OpenGL or OpenAL
+
+    void wait(Job_Group &group); ///< Run Jobs on the calling thread until every Job in 'group' has finished
+    void run_main_thread_jobs(); ///< Run the Jobs scheduled with run_on_main_thread(); Called by Game once per frame
+
+    template <typename FUNCTION>
+    inline void parallel_for(const size_t &begin, const size_t &end, FUNCTION &function, const size_t &grain = 1u); ///< Call function(chunk_begin, chunk_end) on chunks of at least 'grain' indices covering [begin, end), and wait for all of them
+
+  private:
+    static int worker(void * deque);
+
+    void schedule(Job &job);
+    Job * find_job(Job_Deque * const &own);
+    bool run_main_thread_job();
+    void execute(Job &job);
+    void finish(Job_Group &group);
+    void wake();
+
+    static size_t g_num_workers;
+
+    SDL_threadID m_main_thread;
+    SDL_sem * m_wake;
+    SDL_atomic_t m_num_sleeping;
+    SDL_atomic_t m_quit;
+
+    SDL_mutex * m_shared_mutex;
+    SDL_atomic_t m_num_shared;
+
+    SDL_mutex * m_main_mutex;
+    SDL_atomic_t m_num_main;
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::vector<Job_Deque *> m_deques; ///< [0] belongs to the main thread
+    std::vector<SDL_Thread *> m_workers;
+    std::deque<Job *> m_shared;
+    std::deque<Job *> m_main;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  };
+
+  ZENI_CORE_DLL Job_System & get_Job_System(); ///< Get access to the singleton.
+
+}
+
+#endif
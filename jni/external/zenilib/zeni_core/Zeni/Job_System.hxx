@@ -0,0 +1,71 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZENI_JOB_SYSTEM_HXX
+#define ZENI_JOB_SYSTEM_HXX
+
+#include <Zeni/Job_System.h>
+
+namespace Zeni {
+
+  template <typename FUNCTION>
+  void Job_Range<FUNCTION>::set(FUNCTION &function, const size_t &begin, const size_t &end) {
+    m_function = &function;
+    m_begin = begin;
+    m_end = end;
+  }
+
+  template <typename FUNCTION>
+  void Job_Range<FUNCTION>::operator()() {
+    (*m_function)(m_begin, m_end);
+  }
+
+  template <typename FUNCTION>
+  void Job_System::parallel_for(const size_t &begin, const size_t &end, FUNCTION &function, const size_t &grain) {
+    if(end <= begin)
+      return;
+
+    // A few chunks per thread leaves room for stealing to even out the load
+    const size_t count = end - begin;
+    const size_t min_chunk = grain ? grain : 1u;
+    const size_t grain_chunks = (count + min_chunk - 1u) / min_chunk;
+    const size_t max_chunks = 4u * get_num_threads();
+    const size_t chunks = grain_chunks < max_chunks ? grain_chunks : max_chunks;
+
+    if(chunks < 2u) {
+      function(begin, end);
+      return;
+    }
+
+    std::vector<Job_Range<FUNCTION> > jobs(chunks);
+    Job_Group group;
+
+    for(size_t i = 0u; i != chunks; ++i)
+      jobs[i].set(function, begin + count * i / chunks, begin + count * (i + 1u) / chunks);
+
+    // Keep the first chunk for the calling thread
+    for(size_t i = 1u; i != chunks; ++i)
+      run(jobs[i], group);
+
+    jobs[0]();
+
+    wait(group);
+  }
+
+}
+
+#endif
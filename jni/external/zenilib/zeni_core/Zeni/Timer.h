@@ -22,7 +22,10 @@
  *
  * \brief A Snapshot of the Timer
  *
- * \note Guaranteed millisecond precision
+ * Ticks are milliseconds.  Seconds are doubles with the microsecond
+ * precision of the Timer.
+ *
+ * \note Guaranteed microsecond precision
  *
  * \author bazald
  *
@@ -39,7 +42,12 @@
  * Rather than using multiple Timers, I recommend using just this one and 
  * storing Times wherever necessary.
  *
- * \note Guaranteed millisecond precision
+ * The Timer is driven by SDL_GetPerformanceCounter (a monotonic clock),
+ * rather than by the millisecond SDL_GetTicks, so frame times do not
+ * quantize at high frame rates.  Reading it writes no shared state, so
+ * Times may be taken on any thread.
+ *
+ * \note Guaranteed microsecond precision
  *
  * \author bazald
  *
@@ -52,6 +60,9 @@
 #include <Zeni/Chronometer.h>
 #include <Zeni/Singleton.h>
 
+#include <SDL/SDL_stdinc.h>
+#include <SDL/SDL_timer.h>
+
 #ifdef _WINDOWS
 #include <Windows.h>
 #else
@@ -62,8 +73,8 @@ namespace Zeni {
 
   class ZENI_CORE_DLL Time {
   public:
-    typedef size_t Tick_Type;
-    typedef float Second_Type;
+    typedef size_t Tick_Type; ///< Milliseconds
+    typedef double Second_Type;
 
     Time(); ///< Initialize to the current time
     explicit Time(const Tick_Type &ticks);
@@ -72,10 +83,10 @@ namespace Zeni {
     // Accessors
     // Time passed since last updated
     inline Tick_Type get_ticks_passed() const; ///< Get the number of clock ticks passed since this Time
-    inline float get_seconds_passed() const; ///< Get the number of seconds passed since this Time
+    inline double get_seconds_passed() const; ///< Get the number of seconds passed since this Time
     // From a specific time
     inline Tick_Type get_ticks_since(const Time &time) const; ///< Get the number of clock ticks passed between 'time' and this Time
-    inline float get_seconds_since(const Time &time) const; ///< Get the number of seconds passed between 'time' and this Time
+    inline double get_seconds_since(const Time &time) const; ///< Get the number of seconds passed between 'time' and this Time
 
     // Modifiers
     inline void update(); ///< Update to current Time
@@ -84,7 +95,7 @@ namespace Zeni {
     inline bool operator<(const Time &rhs) const;
 
   private:
-    Tick_Type m_ticks;
+    Uint64 m_useconds;
   };
 
   class ZENI_CORE_DLL Timer;
@@ -120,13 +131,13 @@ namespace Zeni {
     // Accessors
     inline Time::Tick_Type get_ticks(); ///< Get the number of ticks passed since instantiation
     inline Time::Tick_Type get_ticks_per_second(); ///< Get the number of ticks per second
-    inline float get_seconds(); ///< Get the number of seconds passed since instantiation
+    inline Uint64 get_useconds(); ///< Get the number of microseconds passed since instantiation
+    inline double get_seconds(); ///< Get the number of seconds passed since instantiation
     inline Time get_time(); ///< Get the current Time
 
   private:
-    void update();
-
-    Time::Tick_Type m_ticks; // Wraps at around 49 days
+    Uint64 m_start;
+    Uint64 m_frequency;
   };
 
   ZENI_CORE_DLL Timer & get_Timer(); ///< Get access to the singleton.
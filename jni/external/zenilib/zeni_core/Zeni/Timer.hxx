@@ -20,55 +20,57 @@
 
 #include <Zeni/Timer.h>
 
-#include <SDL/SDL.h>
-
 namespace Zeni {
 
   Time & Time::operator=(const Time::Tick_Type &ticks) {
-    m_ticks = ticks;
+    m_useconds = Uint64(ticks) * 1000u;
     return *this;
   }
 
   Time::Tick_Type Time::get_ticks_passed() const {
-    return get_Timer().get_ticks() - m_ticks;
+    return Tick_Type(get_Timer().get_useconds() / 1000u - m_useconds / 1000u);
   }
 
-  float Time::get_seconds_passed() const {
-    return float(get_ticks_passed()) * 0.001f;
+  double Time::get_seconds_passed() const {
+    return double(Sint64(get_Timer().get_useconds() - m_useconds)) * 0.000001;
   }
 
   Time::Tick_Type Time::get_ticks_since(const Time &time) const {
-    return m_ticks - time.m_ticks;
+    return Tick_Type(m_useconds / 1000u - time.m_useconds / 1000u);
   }
 
-  float Time::get_seconds_since(const Time &time) const {
-    return float(get_ticks_since(time)) * 0.001f;
+  double Time::get_seconds_since(const Time &time) const {
+    return double(Sint64(m_useconds - time.m_useconds)) * 0.000001;
   }
 
   void Time::update() {
-    m_ticks = get_Timer().get_ticks();
+    m_useconds = get_Timer().get_useconds();
   }
 
   bool Time::operator<(const Time &rhs) const {
-    return m_ticks < rhs.m_ticks;
+    return m_useconds < rhs.m_useconds;
   }
 
   Time::Tick_Type Timer::get_ticks() {
-    update();
-    return m_ticks;
+    return Time::Tick_Type(get_useconds() / 1000u); // Wraps at around 49 days with a 32-bit size_t
   }
 
   Time::Tick_Type Timer::get_ticks_per_second() {
     return 1000u;
   }
 
-  float Timer::get_seconds() {
-    return float(get_ticks()) * 0.001f;
+  Uint64 Timer::get_useconds() {
+    // Split to keep the multiplication from overflowing
+    const Uint64 counts = SDL_GetPerformanceCounter() - m_start;
+    return counts / m_frequency * 1000000u + counts % m_frequency * 1000000u / m_frequency;
+  }
+
+  double Timer::get_seconds() {
+    return double(get_useconds()) * 0.000001;
   }
 
   Time Timer::get_time() {
-    update();
-    return Time(m_ticks);
+    return Time();
   }
 
 }
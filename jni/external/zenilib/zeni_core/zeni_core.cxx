@@ -18,5 +18,7 @@
 #include <zeni_core.h>
 
 #include "Zeni/Core.cpp"
+#include "Zeni/Frame_Limiter.cpp"
+#include "Zeni/Job_System.cpp"
 #include "Zeni/Joysticks.cpp"
 #include "Zeni/Timer.cpp"
@@ -17,6 +17,7 @@ LOCAL_SRC_FILES := \
   Material.cpp \
   Model.cpp \
   Projector.cpp \
+  Render_Thread.cpp \
   Renderable.cpp \
   Shader.cpp \
   Texture.cpp \
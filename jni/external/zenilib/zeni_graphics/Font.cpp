@@ -165,6 +165,8 @@ namespace Zeni {
   }
 
   void Font_FT::render_text(const String &text, const Point2f &position, const Color &color, const JUSTIFY &justify) const {
+    ZENI_PROFILE_SCOPE("Font_FT::render_text");
+
     Video &vr = get_Video();
     const float &x = position.x;
     const float &y = position.y;
@@ -217,6 +219,8 @@ NEXT_LINE:
   }
 
   void Font_FT::render_text(const String &text, const Point3f &position, const Vector3f &right, const Vector3f &down, const Color &color, const JUSTIFY &justify) const {
+    ZENI_PROFILE_SCOPE("Font_FT::render_text");
+
     Video &vr = get_Video();
 
     const Color previous_color = vr.get_Color();
@@ -228,6 +228,9 @@ namespace Zeni {
       std::swap(m_file, lhs->m_file);
       std::swap(m_keyframe, lhs->m_keyframe);
       std::swap(m_unrenderer, lhs->m_unrenderer);
+      std::swap(m_extents, lhs->m_extents);
+      std::swap(m_position, lhs->m_position);
+      std::swap(m_radius, lhs->m_radius);
       std::swap(m_scale, lhs->m_scale);
       std::swap(m_rotate, lhs->m_rotate);
       std::swap(m_translate, lhs->m_translate);
@@ -251,6 +254,23 @@ namespace Zeni {
 //     GUARANTEED_FINISHED_END();
   }
 
+  Matrix4f Model::get_transformation() const {
+    return Matrix4f::Translate(Vector3f(m_translate)) *
+           Quaternion::Axis_Angle(m_rotate, m_rotate_angle).get_matrix() *
+           Matrix4f::Scale(m_scale);
+  }
+
+  Bounding_Box Model::get_bounding_box() const {
+    return Bounding_Box(m_extents.lower_bound, m_extents.upper_bound).transformed(get_transformation());
+  }
+
+  Collision::Sphere Model::get_bounding_sphere() const {
+    const float max_scale = std::max(std::max(fabs(m_scale.i), fabs(m_scale.j)), fabs(m_scale.k));
+
+    return Collision::Sphere(Point3f(get_transformation() * Vector3f(m_position)),
+                             max_scale * m_radius);
+  }
+
   float Model::get_keyframes() const {
 //     GUARANTEED_FINISHED_BEGIN(m_loader);
     return float(m_file->frames);
@@ -337,6 +357,14 @@ namespace Zeni {
     
 //     GUARANTEED_FINISHED_END();
   }
+
+  bool Model::render(const Frustum &frustum) const {
+    if(frustum.cull(get_bounding_sphere()))
+      return false;
+
+    render();
+    return true;
+  }
 #endif
 
   void Model_Renderer::operator()(const Model &model, Lib3dsMeshInstanceNode * const &node, Lib3dsMesh * const &mesh) {
@@ -404,6 +432,7 @@ namespace Zeni {
     visit_meshes(m_extents);
 
     m_position = m_extents.upper_bound.interpolate_to(0.5f, m_extents.lower_bound);
+    m_radius = 0.5f * (m_extents.upper_bound - m_extents.lower_bound).magnitude();
   }
 #endif
 
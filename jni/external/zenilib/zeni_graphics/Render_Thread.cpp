@@ -0,0 +1,328 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_graphics.h>
+
+#if defined(_DEBUG) && defined(_WINDOWS)
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+
+#include <Zeni/Singleton.hxx>
+
+namespace Zeni {
+
+  Render_Command_2d::Render_Command_2d(const std::pair<Point2f, Point2f> &camera2d, const bool &fix_aspect_ratio)
+    : m_camera2d(camera2d),
+    m_fix_aspect_ratio(fix_aspect_ratio)
+  {
+  }
+
+  void Render_Command_2d::operator()() {
+    get_Video().set_2d(m_camera2d, m_fix_aspect_ratio);
+  }
+
+  Render_Command_3d::Render_Command_3d(const Camera &camera)
+    : m_camera(camera)
+  {
+  }
+
+  void Render_Command_3d::operator()() {
+    get_Video().set_3d(m_camera);
+  }
+
+  Render_Command_Color::Render_Command_Color(const Color &color)
+    : m_color(color)
+  {
+  }
+
+  void Render_Command_Color::operator()() {
+    get_Video().set_Color(m_color);
+  }
+
+  Render_Command_Renderable::Render_Command_Renderable(Renderable * const &renderable)
+    : m_renderable(renderable)
+  {
+    assert(m_renderable);
+  }
+
+  Render_Command_Renderable::~Render_Command_Renderable() {
+    delete m_renderable;
+  }
+
+  void Render_Command_Renderable::operator()() {
+    get_Video().render(*m_renderable);
+  }
+
+  Render_Command_Vertex_Buffer::Render_Command_Vertex_Buffer(Vertex_Buffer &vertex_buffer)
+    : m_vertex_buffer(&vertex_buffer)
+  {
+  }
+
+  void Render_Command_Vertex_Buffer::operator()() {
+    m_vertex_buffer->render();
+  }
+
+  Render_Command_List::Render_Command_List()
+    : m_immediate(false)
+  {
+  }
+
+  Render_Command_List::~Render_Command_List() {
+    clear();
+  }
+
+  void Render_Command_List::give(Render_Command * const &command) {
+    assert(command);
+
+    if(m_immediate) {
+      try {
+        (*command)();
+      }
+      catch(...) {
+        delete command;
+        throw;
+      }
+
+      delete command;
+    }
+    else
+      m_commands.push_back(command);
+  }
+
+  void Render_Command_List::execute() {
+    for(std::vector<Render_Command *>::iterator it = m_commands.begin(); it != m_commands.end(); ++it)
+      (**it)();
+  }
+
+  void Render_Command_List::clear() {
+    for(std::vector<Render_Command *>::iterator it = m_commands.begin(); it != m_commands.end(); ++it)
+      delete *it;
+    m_commands.clear();
+  }
+
+  template class Singleton<Render_Thread>;
+
+  Render_Thread * Render_Thread::create() {
+    return new Render_Thread;
+  }
+
+  Singleton<Render_Thread>::Uninit Render_Thread::g_uninit;
+  Singleton<Render_Thread>::Reinit Render_Thread::g_reinit;
+
+  Render_Thread::Render_Thread()
+    : m_context(0),
+    m_thread(0),
+    m_mutex(0),
+    m_submitted(0),
+    m_replayed(0),
+    m_recording(0u),
+    m_replaying(0),
+    m_quit(false),
+    m_failed(false),
+    m_lending(false),
+    m_lent(false),
+    m_low_latency(false)
+  {
+    Video::remove_post_reinit(&g_reinit);
+
+    // Ensure Video is initialized
+    Video &vr = get_Video();
+
+    if(Video::get_video_mode() == Video::ZENI_VIDEO_DX9)
+      throw Render_Thread_Init_Failure();
+
+    m_context = SDL_GL_GetCurrentContext();
+    if(!m_context)
+      throw Render_Thread_Init_Failure();
+
+    m_mutex = SDL_CreateMutex();
+    m_submitted = SDL_CreateCond();
+    m_replayed = SDL_CreateCond();
+
+    // The context can only be current on one thread at a time
+    SDL_GL_MakeCurrent(get_Window().get_window(), 0);
+
+    m_thread = SDL_CreateThread(&run, "Zeni::Render_Thread", this);
+    if(!m_thread) {
+      SDL_GL_MakeCurrent(get_Window().get_window(), m_context);
+      SDL_DestroyCond(m_replayed);
+      SDL_DestroyCond(m_submitted);
+      SDL_DestroyMutex(m_mutex);
+      throw Render_Thread_Init_Failure();
+    }
+
+    vr.lend_pre_uninit(&g_uninit);
+    vr.lend_post_reinit(&g_reinit);
+  }
+
+  Render_Thread::~Render_Thread() {
+    Video::remove_pre_uninit(&g_uninit);
+
+    // The last frame submitted is still replayed
+    SDL_LockMutex(m_mutex);
+    m_quit = true;
+    SDL_CondSignal(m_submitted);
+    SDL_UnlockMutex(m_mutex);
+
+    SDL_WaitThread(m_thread, 0);
+
+    SDL_GL_MakeCurrent(get_Window().get_window(), m_context);
+
+    SDL_DestroyCond(m_replayed);
+    SDL_DestroyCond(m_submitted);
+    SDL_DestroyMutex(m_mutex);
+  }
+
+  void Render_Thread::submit() {
+    SDL_LockMutex(m_mutex);
+
+    // With two lists, the main thread can be at most one frame ahead
+    while(m_replaying)
+      SDL_CondWait(m_replayed, m_mutex);
+
+    m_replaying = &m_lists[m_recording];
+    m_recording = 1u - m_recording;
+    SDL_CondSignal(m_submitted);
+
+    if(m_low_latency) {
+      while(m_replaying)
+        SDL_CondWait(m_replayed, m_mutex);
+    }
+
+    const bool failed = m_failed;
+    m_failed = false;
+
+    SDL_UnlockMutex(m_mutex);
+
+    // The list to record into was replayed last time, so it can be cleared without holding the lock
+    m_lists[m_recording].clear();
+
+    if(failed)
+      throw Render_Thread_Failure();
+  }
+
+  void Render_Thread::finish() {
+    SDL_LockMutex(m_mutex);
+    while(m_replaying)
+      SDL_CondWait(m_replayed, m_mutex);
+    SDL_UnlockMutex(m_mutex);
+  }
+
+  void Render_Thread::begin_direct() {
+    SDL_LockMutex(m_mutex);
+
+    while(m_replaying)
+      SDL_CondWait(m_replayed, m_mutex);
+
+    m_lending = true;
+    SDL_CondSignal(m_submitted);
+
+    while(!m_lent)
+      SDL_CondWait(m_replayed, m_mutex);
+
+    SDL_UnlockMutex(m_mutex);
+
+    SDL_GL_MakeCurrent(get_Window().get_window(), m_context);
+    m_lists[m_recording].set_immediate(true);
+  }
+
+  void Render_Thread::end_direct() {
+    m_lists[m_recording].set_immediate(false);
+    SDL_GL_MakeCurrent(get_Window().get_window(), 0);
+
+    SDL_LockMutex(m_mutex);
+    m_lending = false;
+    SDL_CondSignal(m_submitted);
+    SDL_UnlockMutex(m_mutex);
+  }
+
+  int Render_Thread::run(void * render_thread) {
+    Render_Thread &rt = *reinterpret_cast<Render_Thread *>(render_thread);
+    Video &vr = get_Video();
+
+    SDL_GL_MakeCurrent(get_Window().get_window(), rt.m_context);
+
+    SDL_LockMutex(rt.m_mutex);
+
+    for(;;) {
+      while(!rt.m_replaying && !rt.m_quit && !rt.m_lending)
+        SDL_CondWait(rt.m_submitted, rt.m_mutex);
+
+      if(rt.m_lending) {
+        // The context can only be current on one thread at a time
+        SDL_GL_MakeCurrent(get_Window().get_window(), 0);
+        rt.m_lent = true;
+        SDL_CondBroadcast(rt.m_replayed);
+
+        while(rt.m_lending)
+          SDL_CondWait(rt.m_submitted, rt.m_mutex);
+
+        SDL_GL_MakeCurrent(get_Window().get_window(), rt.m_context);
+        rt.m_lent = false;
+        continue;
+      }
+
+      if(!rt.m_replaying)
+        break;
+
+      Render_Command_List &list = *rt.m_replaying;
+      bool failed = false;
+
+      SDL_UnlockMutex(rt.m_mutex);
+
+      {
+        ZENI_PROFILE_SCOPE("Render_Thread::replay");
+
+        try {
+          if(vr.begin_prerender() && vr.begin_render()) {
+            try {
+              list.execute();
+            }
+            catch(...) {
+              vr.end_render();
+              throw;
+            }
+
+            vr.end_render();
+          }
+        }
+        catch(...) {
+          // Reported to the main thread by the next submit()
+          failed = true;
+        }
+      }
+
+      SDL_LockMutex(rt.m_mutex);
+
+      rt.m_replaying = 0;
+      rt.m_failed = rt.m_failed || failed;
+      SDL_CondBroadcast(rt.m_replayed);
+    }
+
+    SDL_UnlockMutex(rt.m_mutex);
+
+    SDL_GL_MakeCurrent(get_Window().get_window(), 0);
+
+    return 0;
+  }
+
+  Render_Thread & get_Render_Thread() {
+    return Render_Thread::get();
+  }
+
+}
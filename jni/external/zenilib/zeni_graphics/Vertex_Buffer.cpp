@@ -54,7 +54,8 @@ namespace Zeni {
     : m_align_normals(false),
     m_renderer(0),
     m_prerendered(false),
-    m_macrorenderer(new Vertex_Buffer_Macrorenderer)
+    m_macrorenderer(new Vertex_Buffer_Macrorenderer),
+    m_bounds_calculated(false)
   {
     get_vbos().insert(this);
   }
@@ -241,6 +242,8 @@ namespace Zeni {
   };
 
   void Vertex_Buffer::render() {
+    ZENI_PROFILE_SCOPE("Vertex_Buffer::render");
+
     if(!m_renderer) {
       Video &vr = get_Video();
 
@@ -253,13 +256,67 @@ namespace Zeni {
     m_renderer->render();
   }
 
+  bool Vertex_Buffer::render(const Frustum &frustum) {
+    if(frustum.cull(get_bounding_box()))
+      return false;
+
+    render();
+    return true;
+  }
+
   void Vertex_Buffer::lose() {
     delete m_renderer;
     m_renderer = 0;
   }
 
+  const Bounding_Box & Vertex_Buffer::get_bounding_box() const {
+    if(!m_bounds_calculated)
+      calculate_bounds();
+    return m_bounding_box;
+  }
+
+  const Collision::Sphere & Vertex_Buffer::get_bounding_sphere() const {
+    if(!m_bounds_calculated)
+      calculate_bounds();
+    return m_bounding_sphere;
+  }
+
+  template <typename VERTEX>
+  static void include_triangles(Bounding_Box &box, const std::vector<Triangle<VERTEX> *> &triangles) {
+    for(typename std::vector<Triangle<VERTEX> *>::const_iterator it = triangles.begin(), iend = triangles.end(); it != iend; ++it)
+      for(int j = 0; j != 3; ++j)
+        box.include((**it)[j].position);
+  }
+
+  template <typename VERTEX>
+  static void include_triangles(float &radius2, const Point3f &center, const std::vector<Triangle<VERTEX> *> &triangles) {
+    for(typename std::vector<Triangle<VERTEX> *>::const_iterator it = triangles.begin(), iend = triangles.end(); it != iend; ++it)
+      for(int j = 0; j != 3; ++j)
+        radius2 = std::max(radius2, ((**it)[j].position - center).magnitude2());
+  }
+
+  void Vertex_Buffer::calculate_bounds() const {
+    Bounding_Box box;
+    include_triangles(box, m_triangles_cm);
+    include_triangles(box, m_triangles_t);
+
+    /* The center of the box is not the center of the minimal sphere, but 
+     * measuring the farthest vertex from it is tighter than the half-diagonal.
+     */
+    const Point3f center = box.get_center();
+    float radius2 = 0.0f;
+    include_triangles(radius2, center, m_triangles_cm);
+    include_triangles(radius2, center, m_triangles_t);
+
+    m_bounding_box = box;
+    m_bounding_sphere = Collision::Sphere(center, sqrt(radius2));
+    m_bounds_calculated = true;
+  }
+
   void Vertex_Buffer::prerender() {
     if(!m_prerendered) {
+      ZENI_PROFILE_SCOPE("Vertex_Buffer::prerender");
+
       sort_triangles();
       set_descriptors();
       if(m_align_normals)
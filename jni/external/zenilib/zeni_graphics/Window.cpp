@@ -438,6 +438,10 @@ namespace Zeni {
     return (SDL_GetWindowFlags(m_window) & SDL_WINDOW_INPUT_FOCUS) != 0;
   }
 
+  bool Window::is_minimized() const {
+    return (SDL_GetWindowFlags(m_window) & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_HIDDEN)) != 0;
+  }
+
   void Window::set_tt(const String &title, const String &taskmsg) {
     get_m_title() = title;
     get_m_taskmsg() = taskmsg;
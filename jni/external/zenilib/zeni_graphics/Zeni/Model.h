@@ -66,6 +66,7 @@
 
 #include <Zeni/Coordinate.h>
 #include <Zeni/Error.h>
+#include <Zeni/Frustum.h>
 #include <Zeni/Vector3f.h>
 
 #include <memory>
@@ -116,6 +117,9 @@ namespace Zeni {
     inline Lib3dsFile * const & get_file() const; ///< Get the full 3ds file info
     Point3f get_position() const; ///< Get the position of the Model
     inline const Model_Extents & get_extents() const; ///< Get the extents of the Model
+    Matrix4f get_transformation() const; ///< Get the Matrix4f applied by scale, rotate, and translate
+    Bounding_Box get_bounding_box() const; ///< Get the world-space bounds of the Model, first frame only if animated
+    Collision::Sphere get_bounding_sphere() const; ///< Get a world-space bounding Sphere for the Model, first frame only if animated
     float get_keyframes() const; ///< Get the number of keyframes; may be higher than you expect
     inline const Vector3f & get_scale() const; ///< Get the Model scale
     inline std::pair<Vector3f, float> get_rotate() const; ///< Get the Model rotation
@@ -136,6 +140,7 @@ namespace Zeni {
     void visit_meshes(Model_Visitor &mv, Lib3dsNode * node = 0, Lib3dsMesh * const &mesh = 0) const; ///< Visit all meshes
 
     void render() const;
+    bool render(const Frustum &frustum) const; ///< Render the Model unless it is outside the (world-space) Frustum; Returns true if rendered
 
     // Thread-Unsafe versions
     inline Lib3dsFile * const & thun_get_file() const; ///< Get the full 3ds file info - Thread Unsafe Version
@@ -150,6 +155,7 @@ namespace Zeni {
 
     Model_Extents m_extents;
     Point3f m_position;
+    float m_radius; ///< Model-space bounding Sphere radius about m_position
 
     Vector3f m_scale, m_rotate;
     Point3f m_translate;
@@ -18,6 +18,7 @@
 #ifndef ZENI_QUADRILATERAL_H
 #define ZENI_QUADRILATERAL_H
 
+#include <Zeni/Pool.h>
 #include <Zeni/Renderable.h>
 #include <Zeni/Triangle.h>
 
@@ -65,6 +66,14 @@ namespace Zeni {
     Triangle<VERTEX> * get_duplicate_t0() const; ///< Get the first half of the Quadrilateral
     Triangle<VERTEX> * get_duplicate_t1() const; ///< Get the second half of the Quadrilateral
 
+    // Allocation from a Pool shared by all Quadrilateral<VERTEX>s; Defined here, before DEBUG_NEW can redefine 'new'
+    static void * operator new(size_t size) {return get_pool().allocate(size);}
+    static void operator delete(void * ptr, size_t size) {get_pool().deallocate(ptr, size);}
+#if defined(_DEBUG) && defined(_WINDOWS)
+    static void * operator new(size_t size, int, const char *, int) {return get_pool().allocate(size);}
+    static void operator delete(void * ptr, int, const char *, int) {get_pool().deallocate(ptr, sizeof(Quadrilateral<VERTEX>));}
+#endif
+
     // Indexing
     const VERTEX & operator[](const int &index) const; ///< Get 'index'
     VERTEX & operator[](const int &index); ///< Get 'index'
@@ -75,6 +84,8 @@ namespace Zeni {
     VERTEX d;
 
   private:
+    static Pool & get_pool();
+
     void * m_alignment_rubbish;
   };
 
@@ -19,6 +19,7 @@
 #define ZENI_QUADRILATERAL_HXX
 
 // HXXed below
+#include <Zeni/Pool.h>
 #include <Zeni/Triangle.h>
 #include <Zeni/Vertex3f.h>
 
@@ -118,6 +119,13 @@ namespace Zeni {
     return t1;
   }
 
+  // Only instantiated by zeni_graphics (Vertex2f.cpp and Vertex3f.cpp), so every module allocates from the library's Pools
+  template <typename VERTEX>
+  Pool & Quadrilateral<VERTEX>::get_pool() {
+    static Pool * const pool = new Pool(sizeof(Quadrilateral<VERTEX>)); // Never destroyed, so Quadrilaterals can still be freed during static destruction
+    return *pool;
+  }
+
   template <typename VERTEX>
   const VERTEX & Quadrilateral<VERTEX>::operator[](const int &index) const {
     assert(-1 < index && index < 4);
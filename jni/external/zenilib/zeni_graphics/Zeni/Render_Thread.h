@@ -0,0 +1,278 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Render_Command
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Recorded Rendering Call
+ *
+ * Derive from Render_Command and implement operator()() to make calls to
+ * Video on the render thread.  The Render_Command_2d, _3d, _Color,
+ * _Renderable and _Vertex_Buffer commands cover the common cases.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+/**
+ * \class Zeni::Render_Command_List
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Frame's Worth of Render_Commands
+ *
+ * A Render_Command_List owns the Render_Commands given to it, and
+ * execute() runs them in the order they were given.  While immediate,
+ * give() instead runs each Render_Command and deletes it at once.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+/**
+ * \class Zeni::Render_Thread
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Render Thread Singleton
+ *
+ * While the Render_Thread exists, it owns the OpenGL context.  Game then
+ * calls prerender() and render() on the main thread as usual, but rather
+ * than drawing, Gamestates give Render_Commands to
+ * get_Render_Command_List().  At the end of the frame, Game calls
+ * submit() to hand the list to the render thread, which replays it
+ * between Video::begin_render() and Video::end_render().  The commands
+ * are destroyed back on the main thread, by the following submit().
+ *
+ * Two lists are kept.  By default, the main thread records the next
+ * frame while the render thread replays the last one, so logic and
+ * driver time overlap at the cost of a frame of latency.  With
+ * set_low_latency(true), submit() instead waits for the frame to be
+ * displayed before returning.
+ *
+ * Anything that calls into OpenGL, such as loading a Texture or Font,
+ * must happen in a Render_Command while the Render_Thread exists, and
+ * Jobs run with Job_System::run_on_main_thread() no longer have the
+ * context either.  A Gamestate opts into recording with
+ * Gamestate_Base::records_render_commands().  For any other Gamestate
+ * (including the Console_State and popup menus), Game calls
+ * begin_direct(), which waits for the render thread and has it lend the
+ * context to the main thread, draws the frame directly, and hands the
+ * context back with end_direct().  Meanwhile the list is immediate, so a
+ * recording Gamestate drawn by a popup still draws in order.
+ * Direct3D 9 is not supported.
+ *
+ * The Render_Thread is created by get_Render_Thread() and stopped by
+ * destroy(), and it is stopped and restarted along with Video.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_RENDER_THREAD_H
+#define ZENI_RENDER_THREAD_H
+
+#include <Zeni/Camera.h>
+#include <Zeni/Color.h>
+#include <Zeni/Coordinate.h>
+#include <Zeni/Error.h>
+#include <Zeni/Singleton.h>
+
+#include <SDL/SDL.h>
+
+/* \cond */
+#include <vector>
+/* \endcond */
+
+namespace Zeni {
+
+  class Renderable;
+  class Vertex_Buffer;
+
+  class ZENI_GRAPHICS_DLL Render_Command {
+  public:
+    virtual ~Render_Command() {}
+
+    virtual void operator()() = 0;
+  };
+
+  class ZENI_GRAPHICS_DLL Render_Command_2d : public Render_Command {
+  public:
+    Render_Command_2d(const std::pair<Point2f, Point2f> &camera2d, const bool &fix_aspect_ratio = false);
+
+    void operator()(); ///< Video::set_2d
+
+  private:
+    std::pair<Point2f, Point2f> m_camera2d;
+    bool m_fix_aspect_ratio;
+  };
+
+  class ZENI_GRAPHICS_DLL Render_Command_3d : public Render_Command {
+  public:
+    Render_Command_3d(const Camera &camera);
+
+    void operator()(); ///< Video::set_3d
+
+  private:
+    Camera m_camera;
+  };
+
+  class ZENI_GRAPHICS_DLL Render_Command_Color : public Render_Command {
+  public:
+    Render_Command_Color(const Color &color);
+
+    void operator()(); ///< Video::set_Color
+
+  private:
+    Color m_color;
+  };
+
+  class ZENI_GRAPHICS_DLL Render_Command_Renderable : public Render_Command {
+    // Undefined
+    Render_Command_Renderable(const Render_Command_Renderable &);
+    Render_Command_Renderable & operator=(const Render_Command_Renderable &);
+
+  public:
+    Render_Command_Renderable(Renderable * const &renderable); ///< Takes ownership, e.g. of a Triangle's get_duplicate()
+    ~Render_Command_Renderable();
+
+    void operator()(); ///< Video::render
+
+  private:
+    Renderable * m_renderable;
+  };
+
+  class ZENI_GRAPHICS_DLL Render_Command_Vertex_Buffer : public Render_Command {
+  public:
+    Render_Command_Vertex_Buffer(Vertex_Buffer &vertex_buffer); ///< The Vertex_Buffer must be left unchanged until it has been replayed
+
+    void operator()(); ///< Vertex_Buffer::render
+
+  private:
+    Vertex_Buffer * m_vertex_buffer;
+  };
+
+  class ZENI_GRAPHICS_DLL Render_Command_List {
+    // Undefined
+    Render_Command_List(const Render_Command_List &);
+    Render_Command_List & operator=(const Render_Command_List &);
+
+  public:
+    Render_Command_List();
+    ~Render_Command_List();
+
+    size_t size() const {return m_commands.size();}
+    bool empty() const {return m_commands.empty();}
+
+    void give(Render_Command * const &command); ///< Append a Render_Command, giving the Render_Command_List ownership
+    void execute(); ///< Run every Render_Command in order
+    void clear(); ///< Delete every Render_Command
+
+    bool is_immediate() const {return m_immediate;}
+    void set_immediate(const bool &immediate) {m_immediate = immediate;} ///< Run Render_Commands as they are given rather than keeping them
+
+  private:
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::vector<Render_Command *> m_commands;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+    bool m_immediate;
+  };
+
+  class ZENI_GRAPHICS_DLL Render_Thread;
+
+#ifdef _WINDOWS
+  ZENI_GRAPHICS_EXT template class ZENI_GRAPHICS_DLL Singleton<Render_Thread>;
+#endif
+
+  class ZENI_GRAPHICS_DLL Render_Thread : public Singleton<Render_Thread> {
+    friend class Singleton<Render_Thread>;
+
+    static Render_Thread * create();
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    static Uninit g_uninit;
+    static Reinit g_reinit;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+
+    Render_Thread();
+    ~Render_Thread();
+
+    // Undefined
+    Render_Thread(const Render_Thread &);
+    Render_Thread & operator=(const Render_Thread &);
+
+  public:
+    // Accessors
+    Render_Command_List & get_Render_Command_List() {return m_lists[m_recording];} ///< Get the list for the frame being recorded
+    bool is_low_latency() const {return m_low_latency;}
+
+    // Modifiers
+    void set_low_latency(const bool &low_latency = true) {m_low_latency = low_latency;} ///< Wait for each frame to be displayed in submit(), rather than overlapping it with the next
+
+    void submit(); ///< Hand the recorded frame to the render thread; Called by Game once per frame; Throws Render_Thread_Failure if a Render_Command threw
+    void finish(); ///< Wait for the render thread to finish any frame it has been handed
+
+    void begin_direct(); ///< Finish, then make the context current on this thread until end_direct(); Called by Game to draw a frame without recording it
+    void end_direct(); ///< Hand the context back to the render thread
+
+  private:
+    static int run(void * render_thread);
+
+    SDL_GLContext m_context;
+    SDL_Thread * m_thread;
+    SDL_mutex * m_mutex;
+    SDL_cond * m_submitted;
+    SDL_cond * m_replayed;
+
+    Render_Command_List m_lists[2];
+    size_t m_recording;
+    Render_Command_List * m_replaying; ///< Guarded by m_mutex
+    bool m_quit; ///< Guarded by m_mutex
+    bool m_failed; ///< Guarded by m_mutex
+    bool m_lending; ///< Guarded by m_mutex; The main thread wants the context
+    bool m_lent; ///< Guarded by m_mutex; The render thread has released the context
+    bool m_low_latency;
+  };
+
+  ZENI_GRAPHICS_DLL Render_Thread & get_Render_Thread(); ///< Get access to the singleton.
+
+  struct ZENI_GRAPHICS_DLL Render_Thread_Init_Failure : public Error {
+    Render_Thread_Init_Failure() : Error("Zeni Render Thread Failed to Initialize Correctly") {}
+  };
+
+  struct ZENI_GRAPHICS_DLL Render_Thread_Failure : public Error {
+    Render_Thread_Failure() : Error("Zeni Render Thread Failed to Replay a Frame") {}
+  };
+
+}
+
+#endif
@@ -18,6 +18,7 @@
 #ifndef ZENI_TRIANGLE_H
 #define ZENI_TRIANGLE_H
 
+#include <Zeni/Pool.h>
 #include <Zeni/Renderable.h>
 
 namespace Zeni {
@@ -65,6 +66,14 @@ namespace Zeni {
     Triangle<VERTEX> * get_duplicate_subt2() const; ///< Get quarter 2 of the Triangle; Can be used for software LOD increase
     Triangle<VERTEX> * get_duplicate_subt3() const; ///< Get quarter 3 of the Triangle; Can be used for software LOD increase
 
+    // Allocation from a Pool shared by all Triangle<VERTEX>s; Defined here, before DEBUG_NEW can redefine 'new'
+    static void * operator new(size_t size) {return get_pool().allocate(size);}
+    static void operator delete(void * ptr, size_t size) {get_pool().deallocate(ptr, size);}
+#if defined(_DEBUG) && defined(_WINDOWS)
+    static void * operator new(size_t size, int, const char *, int) {return get_pool().allocate(size);}
+    static void operator delete(void * ptr, int, const char *, int) {get_pool().deallocate(ptr, sizeof(Triangle<VERTEX>));}
+#endif
+
     // Indexing
     const VERTEX & operator[](const int &index) const; ///< Get 'index'
     VERTEX & operator[](const int &index); ///< Get 'index'
@@ -74,6 +83,8 @@ namespace Zeni {
     VERTEX c;
 
   private:
+    static Pool & get_pool();
+
     void * m_alignment_rubbish;
   };
 
@@ -19,6 +19,7 @@
 #define ZENI_TRIANGLE_HXX
 
 // HXXed below
+#include <Zeni/Pool.h>
 #include <Zeni/Vertex3f.h>
 #include <Zeni/Video_DX9.h>
 
@@ -140,6 +141,13 @@ namespace Zeni {
     return triangle;
   }
 
+  // Only instantiated by zeni_graphics (Vertex2f.cpp and Vertex3f.cpp), so every module allocates from the library's Pools
+  template <typename VERTEX>
+  Pool & Triangle<VERTEX>::get_pool() {
+    static Pool * const pool = new Pool(sizeof(Triangle<VERTEX>)); // Never destroyed, so Triangles can still be freed during static destruction
+    return *pool;
+  }
+
   template <typename VERTEX>
   const VERTEX & Triangle<VERTEX>::operator[](const int &index) const {
     assert(-1 < index && index < 3);
@@ -136,8 +136,12 @@ namespace Zeni {
     void give_Macrorenderer(Vertex_Buffer_Macrorenderer * const &macrorenderer); ///< Wraps the final render call
 
     void render(); ///< Render the Vertex_Buffer
+    bool render(const Frustum &frustum); ///< Render the Vertex_Buffer unless it is outside the Frustum (in the local space of the Vertex_Buffer); Returns true if rendered
     void lose(); ///< Lose the Vertex_Buffer
 
+    const Bounding_Box & get_bounding_box() const; ///< Get the axis-aligned bounds of all Triangles, cached until more are added
+    const Collision::Sphere & get_bounding_sphere() const; ///< Get a bounding Sphere for all Triangles, cached until more are added
+
   private:
     void prerender(); ///< Create the vertex buffer in the GPU/VPU
 
@@ -155,6 +159,9 @@ namespace Zeni {
     // Align normals of similar vertices
     void align_similar_normals();
 
+    // Calculate cached bounding volumes
+    void calculate_bounds() const;
+
 #ifdef _WINDOWS
 #pragma warning( push )
 #pragma warning( disable : 4251 )
@@ -175,6 +182,10 @@ namespace Zeni {
 
     Vertex_Buffer_Macrorenderer * m_macrorenderer;
 
+    mutable Bounding_Box m_bounding_box;
+    mutable Collision::Sphere m_bounding_sphere;
+    mutable bool m_bounds_calculated;
+
   public:
     static void lose_all(); /// Lose all Vertex_Buffer objects, presumably when losing resources in Textures and Fonts
 
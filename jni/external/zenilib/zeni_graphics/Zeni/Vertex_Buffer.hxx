@@ -43,6 +43,7 @@ namespace Zeni {
     m_descriptors_cm.clear();
     m_descriptors_t.clear();
     m_prerendered = false;
+    m_bounds_calculated = false;
   }
   
 #ifndef DISABLE_GL_FIXED
@@ -38,6 +38,7 @@
 #include <Zeni/Core.h>
 #include <Zeni/Color.h>
 #include <Zeni/Coordinate.h>
+#include <Zeni/Frustum.h>
 #include <Zeni/Image.h>
 #include <Zeni/Matrix4f.h>
 #include <Zeni/Singleton.h>
@@ -196,6 +197,7 @@ namespace Zeni {
     inline const Matrix4f & get_view_matrix() const; ///< Get the view Matrix4f
     inline const Matrix4f & get_projection_matrix() const; ///< Get the projection Matrix4f
     inline const std::pair<Point2i, Point2i> & get_viewport() const; ///< Get the viewport
+    inline Frustum get_frustum() const; ///< Get the world-space Frustum of the current view and projection matrices
     virtual void set_view_matrix(const Matrix4f &view) = 0; ///< Set the view Matrix4f
     virtual void set_projection_matrix(const Matrix4f &projection) = 0; ///< Set the projection Matrix4f
     virtual void set_viewport(const std::pair<Point2i, Point2i> &viewport =
@@ -136,6 +136,10 @@ namespace Zeni {
     return m_viewport;
   }
 
+  Frustum Video::get_frustum() const {
+    return Frustum(m_projection * m_view);
+  }
+
 }
 
 #include <Zeni/Undefine.h>
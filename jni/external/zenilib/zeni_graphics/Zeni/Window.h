@@ -86,6 +86,7 @@ namespace Zeni {
     inline static const bool & is_resizable(); ///< Determine whether the frame is resizable (windowed only)
     inline const std::vector<Point2i> & get_resolutions() const; ///< Get available full screen resolutions
     bool has_focus() const; ///< Determine if the Window currently has focus or not
+    bool is_minimized() const; ///< Determine if the Window is currently minimized or hidden
 
     // Window Decorations
     inline const String & get_title() const; ///< Get the window title
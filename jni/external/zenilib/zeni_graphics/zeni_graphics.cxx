@@ -26,6 +26,7 @@
 #include "Zeni/Material.cpp"
 #include "Zeni/Model.cpp"
 #include "Zeni/Projector.cpp"
+#include "Zeni/Render_Thread.cpp"
 #include "Zeni/Renderable.cpp"
 #include "Zeni/Shader.cpp"
 #include "Zeni/Texture.cpp"
@@ -38,6 +38,7 @@
 #include <Zeni/Model.h>
 #include <Zeni/Projector.h>
 #include <Zeni/Quadrilateral.h>
+#include <Zeni/Render_Thread.h>
 #include <Zeni/Renderable.h>
 #include <Zeni/Shader.h>
 #include <Zeni/Texture.h>
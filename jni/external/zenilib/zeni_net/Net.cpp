@@ -18,10 +18,20 @@
 #include <zeni_net.h>
 
 #include <SDL/SDL.h>
+#include <algorithm>
 #include <vector>
 #include <list>
 #include <sstream>
 
+#if defined(_WINDOWS)
+#include <winsock2.h>
+#else
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
 #if defined(_DEBUG) && defined(_WINDOWS)
 #define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
 #define new DEBUG_NEW
@@ -33,6 +43,8 @@ namespace Zeni {
 
   template class ZENI_NET_DLL Singleton<Net>;
 
+  static const Uint32 g_tcp_message_growth = 4096u; ///< The first allocation for a message being received, doubling as more arrives
+
   Net * Net::create() {
     return new Net;
   }
@@ -40,7 +52,9 @@ namespace Zeni {
   Singleton<Net>::Uninit Net::g_uninit;
   Singleton<Net>::Reinit Net::g_reinit;
 
-  Net::Net() {
+  Net::Net()
+    : m_resolver(0)
+  {
     Core::remove_post_reinit(&g_reinit);
 
     // Ensure Core is initialized
@@ -56,6 +70,8 @@ namespace Zeni {
   Net::~Net() {
     Core::remove_pre_uninit(&g_uninit);
 
+    stop_resolver();
+
     SDLNet_Quit();
   }
 
@@ -76,6 +92,7 @@ namespace Zeni {
   TCP_Socket::TCP_Socket(IPaddress ip)
     : sock(0),
     sockset(0),
+    m_ready(false),
 #ifdef _WINDOWS
 #pragma warning( push )
 #pragma warning( disable : 4355 )
@@ -108,6 +125,7 @@ namespace Zeni {
   TCP_Socket::TCP_Socket(TCPsocket socket)
     : sock(socket),
     sockset(0),
+    m_ready(false),
 #ifdef _WINDOWS
 #pragma warning( push )
 #pragma warning( disable : 4355 )
@@ -125,6 +143,8 @@ namespace Zeni {
     if(!sockset ||
        SDLNet_TCP_AddSocket(sockset, sock) == -1)
     {
+      if(sockset)
+        SDLNet_FreeSocketSet(sockset);
       SDLNet_TCP_Close(sock);
       throw TCP_Socket_Init_Failure();
     }
@@ -159,15 +179,15 @@ namespace Zeni {
     return rv;
   }
 
-  int TCP_Socket::try_send(const void * const &data, const Uint16 &num_bytes) {
-    return SDLNet_TCP_Send(sock, const_cast<void *>(data), num_bytes) < num_bytes ? -1 : 0;
+  int TCP_Socket::try_send(const void * const &data, const Uint32 &num_bytes) {
+    return SDLNet_TCP_Send(sock, const_cast<void *>(data), int(num_bytes)) < int(num_bytes) ? -1 : 0;
   }
 
   int TCP_Socket::try_send(const String &data) {
-    return try_send(data.c_str(), Uint16(data.size()));
+    return try_send(data.c_str(), Uint32(data.size()));
   }
 
-  void TCP_Socket::send(const void * const &data, const Uint16 &num_bytes) {
+  void TCP_Socket::send(const void * const &data, const Uint32 &num_bytes) {
     if(try_send(data, num_bytes) == -1)
       throw Socket_Closed();
   }
@@ -177,11 +197,12 @@ namespace Zeni {
       throw Socket_Closed();
   }
 
-  int TCP_Socket::try_receive(void * const &data, const Uint16 &num_bytes) {
-    int retval = check_socket();
+  int TCP_Socket::try_receive(void * const &data, const Uint32 &num_bytes) {
+    int retval = m_ready ? 1 : check_socket();
+    m_ready = false;
     
     if(retval) {
-      retval = SDLNet_TCP_Recv(sock, data, num_bytes);
+      retval = SDLNet_TCP_Recv(sock, data, int(num_bytes));
       if(retval <= 0)
         return -1;
     }
@@ -189,7 +210,7 @@ namespace Zeni {
     return retval;
   }
 
-  int TCP_Socket::try_receive(String &data, const Uint16 &num_bytes) {
+  int TCP_Socket::try_receive(String &data, const Uint32 &num_bytes) {
     data.resize(size_t(num_bytes));
 
     const int retval = receive(const_cast<char *>(data.c_str()), num_bytes);
@@ -200,7 +221,7 @@ namespace Zeni {
     return retval;
   }
 
-  int TCP_Socket::receive(void * const &data, const Uint16 &num_bytes) {
+  int TCP_Socket::receive(void * const &data, const Uint32 &num_bytes) {
     const int rv = try_receive(data, num_bytes);
 
     if(rv == -1)
@@ -209,7 +230,7 @@ namespace Zeni {
     return rv;
   }
 
-  int TCP_Socket::receive(String &data, const Uint16 &num_bytes) {
+  int TCP_Socket::receive(String &data, const Uint32 &num_bytes) {
     const int rv = try_receive(data, num_bytes);
 
     if(rv == -1)
@@ -229,6 +250,117 @@ namespace Zeni {
     get_Core().remove_pre_uninit(this);
   }
 
+  TCP_Message_Socket::TCP_Message_Socket(IPaddress ip, const Uint32 &max_message_size)
+    : TCP_Socket(ip),
+    m_framing(FRAMING_32_BIT),
+    m_max_message_size(max_message_size),
+    m_compressor(0),
+    m_header_received(0u),
+    m_message_received(0u)
+  {
+  }
+
+  TCP_Message_Socket::TCP_Message_Socket(TCPsocket sock, const Uint32 &max_message_size)
+    : TCP_Socket(sock),
+    m_framing(FRAMING_32_BIT),
+    m_max_message_size(max_message_size),
+    m_compressor(0),
+    m_header_received(0u),
+    m_message_received(0u)
+  {
+  }
+
+  TCP_Message_Socket::~TCP_Message_Socket() {
+    delete m_compressor;
+  }
+
+  void TCP_Message_Socket::enable_compression(const String &dictionary, const Uint32 &threshold) {
+    Net_Compressor * const compressor = new Net_Compressor(Net_Compressor::STREAM, dictionary, threshold);
+    delete m_compressor;
+    m_compressor = compressor;
+  }
+
+  void TCP_Message_Socket::disable_compression() {
+    delete m_compressor;
+    m_compressor = 0;
+  }
+
+  void TCP_Message_Socket::send_message(const void * const &data, const Uint32 &num_bytes) {
+    if(m_compressor) {
+      const std::vector<char> &compressed = m_compressor->compress(data, num_bytes);
+      send_frame(&compressed[0], Uint32(compressed.size()));
+    }
+    else
+      send_frame(data, num_bytes);
+  }
+
+  void TCP_Message_Socket::send_message(const String &data) {
+    send_message(data.c_str(), Uint32(data.size()));
+  }
+
+  void TCP_Message_Socket::send_frame(const void * const &data, const Uint32 &num_bytes) {
+    if(num_bytes >= 0xFFFFu && m_framing == FRAMING_16_BIT)
+      throw Message_Too_Large();
+
+    char buffer[1024];
+    Byte_Writer writer(buffer, sizeof(buffer));
+    serialize_size(writer, num_bytes);
+
+    // Short messages go out in one piece with their length; Longer ones aren't worth copying
+    if(num_bytes <= writer.remaining()) {
+      writer.write(data, num_bytes);
+      send(buffer, Uint32(writer.size()));
+    }
+    else {
+      send(buffer, Uint32(writer.size()));
+      send(data, num_bytes);
+    }
+  }
+
+  bool TCP_Message_Socket::receive_message(String &data) {
+    for(;;) {
+      Uint32 size;
+      Byte_Reader header(m_header, m_header_received);
+      if(unserialize_size(header, size).fail()) {
+        // 2 bytes, or 6 once the first 2 show that the length was escaped
+        const Uint32 header_size = m_header_received < sizeof(Uint16) ? Uint32(sizeof(Uint16)) : Uint32(sizeof(m_header));
+        const int received = receive(m_header + m_header_received, header_size - m_header_received);
+        if(!received)
+          return false;
+
+        m_header_received += Uint32(received);
+        continue;
+      }
+
+      // Compressed, allowing for the prefix and for deflate's worst case
+      if(size > m_max_message_size && (!m_compressor || size - m_max_message_size > m_max_message_size / 1024u + 64u))
+        throw Message_Too_Large();
+
+      if(m_message_received != size) {
+        // Grown as the bytes arrive, so that a length alone cannot pin max_message_size
+        if(m_message.size() == m_message_received)
+          m_message.resize(std::min(size, std::max(g_tcp_message_growth, 2u * m_message_received)));
+
+        const int received = receive(&m_message[m_message_received], Uint32(m_message.size()) - m_message_received);
+        if(!received)
+          return false;
+
+        m_message_received += Uint32(received);
+        continue;
+      }
+
+      if(m_compressor)
+        m_compressor->decompress(data, m_message.c_str(), size, m_max_message_size);
+      else
+        data.swap(m_message);
+      m_message.resize(0u);
+      m_header_received = 0u;
+      m_message_received = 0u;
+
+      return true;
+    }
+  }
+
   TCP_Listener::TCP_Listener(const Uint16 &port)
     : sock(0),
 #ifdef _WINDOWS
@@ -302,14 +434,14 @@ namespace Zeni {
     return *SDLNet_UDP_GetPeerAddress(sock, -1);
   }
   
-  void UDP_Socket::send(const IPaddress &ip, const void * const &data, const Uint16 &num_bytes) {
+  void UDP_Socket::send(const IPaddress &ip, const void * const &data, const Uint32 &num_bytes) {
     if(num_bytes < 8167u) {
       UDPpacket packet =
       {
         -1,
         reinterpret_cast<Uint8 *>(const_cast<void *>(data)),
-        num_bytes,
-        num_bytes,
+        int(num_bytes),
+        int(num_bytes),
         0, // Will == -1 on error after UDP_Send, otherwise == # of bytes sent
         ip
       };
@@ -324,10 +456,10 @@ namespace Zeni {
   }
   
   void UDP_Socket::send(const IPaddress &ip, const String &data) {
-    UDP_Socket::send(ip, data.c_str(), Uint16(data.size()));
+    UDP_Socket::send(ip, data.c_str(), Uint32(data.size()));
   }
 
-  int UDP_Socket::receive(IPaddress &ip, const void * const &data, const Uint16 &num_bytes) {
+  int UDP_Socket::receive(IPaddress &ip, const void * const &data, const Uint32 &num_bytes) {
     IPaddress ipaddress = {0, 0};
 
     UDPpacket packet =
@@ -335,7 +467,7 @@ namespace Zeni {
       -1,
       reinterpret_cast<Uint8 *>(const_cast<void *>(data)),
       0,
-      num_bytes,
+      int(num_bytes),
       0,
       ipaddress
     };
@@ -354,7 +486,7 @@ namespace Zeni {
   }
   
   int UDP_Socket::receive(IPaddress &ip, String &data) {
-    int retval = UDP_Socket::receive(ip, data.c_str(), Uint16(data.size()));
+    int retval = UDP_Socket::receive(ip, data.c_str(), Uint32(data.size()));
     
     if(int(data.size()) > retval) {
       data[static_cast<unsigned int>(retval)] = '\0';
@@ -372,194 +504,540 @@ namespace Zeni {
     get_Core().remove_pre_uninit(this);
   }
 
-  Split_UDP_Socket::Chunk_Set::Chunk_Set(const IPaddress &sender,
-                                         const Nonce &incoming,
-                                         const Uint16 &num_chunks,
-                                         const Uint16 &which,
-                                         Chunk &chunk)
-    : ip(sender),
-      nonce(incoming),
-      chunks(num_chunks),
-      chunks_arrived(1u)
+  static const size_t g_receive_batch = 32u;
+
+  static Uint32 hash_chunk_set(const IPaddress &sender, const char * const &nonce, const Uint16 &nonce_size) {
+    // FNV-1a
+    Uint32 hash = 2166136261u;
+
+    const Uint8 * bytes = reinterpret_cast<const Uint8 *>(&sender);
+    for(size_t i = 0u; i != sizeof(sender.host) + sizeof(sender.port); ++i)
+      hash = (hash ^ bytes[i]) * 16777619u;
+
+    bytes = reinterpret_cast<const Uint8 *>(nonce);
+    for(Uint16 i = 0u; i != nonce_size; ++i)
+      hash = (hash ^ bytes[i]) * 16777619u;
+
+    return hash;
+  }
+
+  Split_UDP_Socket::Chunk_Set::Chunk_Set()
+    : hash(0u),
+      last_arrival(0u),
+      num_chunks(0u),
+      chunks_arrived(0u),
+      slot_size(0u),
+      split_size(0u),
+      last_size(0u)
   {
-    assert(num_chunks > which);
-    
-    if(num_chunks > which)
-      chunks[which] = chunk;
+    ip.host = 0;
+    ip.port = 0;
   }
-  
-  bool Split_UDP_Socket::Chunk_Set::add_chunk(const IPaddress &sender,
-                                              const Nonce &incoming,
-                                              const Uint16 &num_chunks,
-                                              const Uint16 &which,
-                                              Chunk &chunk) {
-    if(ip == sender &&
-       nonce == incoming &&
-       chunks.size() == num_chunks &&
-       chunks.size() > which)
-    {
-      if(!chunks[which].data)
-        chunks[which] = chunk;
-      ++chunks_arrived;
-      return true;
-    }
-    
-    return false;
+
+  size_t Split_UDP_Socket::Chunk_Set::size() const {
+    return size_t(num_chunks - 1u) * split_size + last_size;
   }
-  
-  bool Split_UDP_Socket::Chunk_Set::complete() const {
-    return chunks_arrived == chunks.size();
 
-    //for(std::vector<Chunk>::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
-    //  if(!it->data)
-    //    return false;
-    //
-    //return true;
+  Split_UDP_Socket::Chunk_Collector::Chunk_Collector(const Uint16 &size, const Uint16 &chunk_size, const Uint32 &timeout, const Uint32 &max_message_size)
+    : m_sets(size),
+      m_chunk_size(chunk_size),
+      m_timeout(timeout),
+      m_max_message_size(max_message_size),
+      m_last_expiry(0u)
+  {
+    assert(size);
+
+    // Keep the table at most half full so that probes stay short
+    size_t table_size = 1u;
+    while(table_size < 2u * size_t(size))
+      table_size <<= 1;
+    m_table.resize(table_size, 0u);
+
+    m_free.reserve(size);
+    for(size_t i = size; i; --i)
+      m_free.push_back(i - 1u);
   }
-  
-  Split_UDP_Socket::Chunk Split_UDP_Socket::Chunk_Set::receive() const {
-    Chunk packet;
-    
-    for(std::vector<Chunk>::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
-      packet.size += it->size;
-    
-    char * dst = new char [packet.size];
-    packet.data = dst;
-    
-    for(std::vector<Chunk>::const_iterator it = chunks.begin(); it != chunks.end(); ++it) {
-      memcpy(dst, it->data, it->size);
-      dst += it->size;
+
+  Split_UDP_Socket::Chunk_Set * Split_UDP_Socket::Chunk_Collector::add_chunk(const IPaddress &sender,
+                                                                             const char * const &packet,
+                                                                             const size_t &packet_size,
+                                                                             const Uint32 &now) {
+    // Read the header as unserialize would, without copying the packet into a stream
+    if(packet_size < sizeof(Uint16))
+      return 0;
+
+    const void *bp = packet;
+    const Uint16 nonce_size = SDLNet_Read16(bp);
+    size_t offset = sizeof(Uint16) + nonce_size + 2u * sizeof(Uint16);
+    if(packet_size < offset)
+      return 0;
+
+    const char * const nonce = packet + sizeof(Uint16);
+    bp = nonce + nonce_size;
+    Uint32 num_chunks = SDLNet_Read16(bp);
+    Uint32 which;
+    bp = nonce + nonce_size + sizeof(Uint16);
+    if(num_chunks != 0xFFFFu)
+      which = SDLNet_Read16(bp);
+    else {
+      // Escaped to 32 bits, as serialize_size would
+      offset += 2u * sizeof(Uint32) - sizeof(Uint16);
+      if(packet_size < offset)
+        return 0;
+
+      num_chunks = SDLNet_Read32(bp);
+      bp = nonce + nonce_size + sizeof(Uint16) + sizeof(Uint32);
+      which = SDLNet_Read32(bp);
     }
-    
-    return packet;
+
+    if(m_chunk_size <= offset || which >= num_chunks)
+      return 0;
+
+    const Uint16 payload = Uint16(packet_size - offset);
+
+    const Uint32 hash = hash_chunk_set(sender, nonce, nonce_size);
+    const size_t slot = find(sender, hash, nonce, nonce_size);
+
+    Chunk_Set * cs;
+    if(m_table[slot]) {
+      cs = &m_sets[m_table[slot] - 1u];
+      if(cs->num_chunks != num_chunks)
+        return 0;
+    }
+    else {
+      const Uint16 slot_size = Uint16(m_chunk_size - offset);
+      if(Uint64(num_chunks - 1u) * slot_size > m_max_message_size)
+        return 0;
+
+      cs = &acquire(now);
+
+      cs->ip = sender;
+      cs->hash = hash;
+      cs->num_chunks = num_chunks;
+      cs->chunks_arrived = 0u;
+      cs->slot_size = slot_size;
+      cs->split_size = 0u;
+      cs->last_size = 0u;
+      cs->nonce.assign(nonce, nonce + nonce_size);
+      cs->received.assign((num_chunks + 31u) / 32u, 0u);
+
+      const size_t capacity = size_t(num_chunks) * cs->slot_size;
+      if(cs->data.size() < capacity)
+        cs->data.resize(capacity);
+
+      // acquire() may have evicted a Chunk_Set and moved others, so look again
+      m_table[find(sender, hash, nonce, nonce_size)] = size_t(cs - &m_sets[0]) + 1u;
+    }
+
+    cs->last_arrival = now;
+
+    Uint32 &received = cs->received[which / 32u];
+    const Uint32 bit = 1u << (which % 32u);
+    if(received & bit)
+      return 0;
+
+    if(which + 1u != num_chunks) {
+      // Every chunk but the last is the same size
+      if(cs->split_size && cs->split_size != payload)
+        return 0;
+      cs->split_size = payload;
+    }
+    else
+      cs->last_size = payload;
+
+    memcpy(&cs->data[size_t(which) * cs->slot_size], packet + offset, payload);
+    received |= bit;
+
+    if(++cs->chunks_arrived != num_chunks)
+      return 0;
+
+    // Close any gaps left by a sender with smaller chunks than ours
+    if(cs->split_size != cs->slot_size) {
+      for(Uint32 i = 1u; i != num_chunks; ++i)
+        memmove(&cs->data[size_t(i) * cs->split_size],
+                &cs->data[size_t(i) * cs->slot_size],
+                i + 1u != num_chunks ? cs->split_size : cs->last_size);
+    }
+
+    return cs;
   }
-  
-  const Split_UDP_Socket::Chunk_Set * Split_UDP_Socket::Chunk_Collector::add_chunk(const IPaddress &sender,
-                                                                                   const Nonce &incoming,
-                                                                                   const Uint16 &num_chunks,
-                                                                                   const Uint16 &which,
-                                                                                   Chunk &chunk) {
-    // Attempt to complete an existing partial packet
-    for(std::list<Chunk_Set *>::iterator it = chunk_sets.begin(); it != chunk_sets.end(); ++it) {
-      if((*it)->add_chunk(sender, incoming, num_chunks, which, chunk)) {
-        if((*it)->complete())
-          return *it;
-        else
-          return 0;
+
+  void Split_UDP_Socket::Chunk_Collector::release(Chunk_Set * const &chunk_set) {
+    const size_t index = size_t(chunk_set - &m_sets[0]);
+    const size_t mask = m_table.size() - 1u;
+
+    size_t hole = chunk_set->hash & mask;
+    while(m_table[hole] != index + 1u)
+      hole = (hole + 1u) & mask;
+
+    // Shift back any entries that probed past the hole
+    for(size_t next = (hole + 1u) & mask; m_table[next]; next = (next + 1u) & mask) {
+      const size_t home = m_sets[m_table[next] - 1u].hash & mask;
+      if(((next - home) & mask) >= ((next - hole) & mask)) {
+        m_table[hole] = m_table[next];
+        hole = next;
       }
     }
-    
-    if(int(chunk_sets.size()) == m_size) // LRU Eviction
-      chunk_sets.pop_back();
-    
-    {// Receive fresh chunk
-      Chunk_Set *cs = new Chunk_Set(sender, incoming, num_chunks, which, chunk);
-      chunk_sets.push_front(cs);
-      if(cs->complete())
-        return cs;
+    m_table[hole] = 0u;
+
+    // Don't hold on to more than a message with a 16-bit length could need
+    if(chunk_set->data.size() > 0xFFFFu + size_t(m_chunk_size))
+      std::vector<char>().swap(chunk_set->data);
+
+    chunk_set->num_chunks = 0u;
+    m_free.push_back(index);
+  }
+
+  void Split_UDP_Socket::Chunk_Collector::expire(const Uint32 &now) {
+    if(now - m_last_expiry < m_timeout / 4u)
+      return;
+    m_last_expiry = now;
+
+    for(std::vector<Chunk_Set>::iterator it = m_sets.begin(); it != m_sets.end(); ++it)
+      if(it->num_chunks && now - it->last_arrival > m_timeout)
+        release(&*it);
+  }
+
+  size_t Split_UDP_Socket::Chunk_Collector::find(const IPaddress &sender, const Uint32 &hash, const char * const &nonce, const Uint16 &nonce_size) const {
+    const size_t mask = m_table.size() - 1u;
+
+    for(size_t slot = hash & mask; ; slot = (slot + 1u) & mask) {
+      if(!m_table[slot])
+        return slot;
+
+      const Chunk_Set &cs = m_sets[m_table[slot] - 1u];
+      if(cs.hash == hash &&
+         cs.ip == sender &&
+         cs.nonce.size() == nonce_size &&
+         (!nonce_size || !memcmp(&cs.nonce[0], nonce, nonce_size)))
+        return slot;
     }
-    
-    return 0;
+  }
+
+  Split_UDP_Socket::Chunk_Set & Split_UDP_Socket::Chunk_Collector::acquire(const Uint32 &now) {
+    if(m_free.empty()) {
+      // Evict whichever has waited longest for its next chunk
+      std::vector<Chunk_Set>::iterator oldest = m_sets.begin();
+      for(std::vector<Chunk_Set>::iterator it = m_sets.begin(); it != m_sets.end(); ++it)
+        if(now - it->last_arrival > now - oldest->last_arrival)
+          oldest = it;
+
+      release(&*oldest);
+    }
+
+    const size_t index = m_free.back();
+    m_free.pop_back();
+    return m_sets[index];
   }
   
-  Split_UDP_Socket::Split_UDP_Socket(const Uint16 &port, const Uint16 &chunk_sets, const Uint16 &chunk_size)
+  struct Split_UDP_Socket::Send_Buffer {
+    std::vector<char> headers; ///< One per chunk, each offset bytes long
+#if defined(_WINDOWS)
+    std::vector<WSABUF> buffers; ///< Header and payload for each chunk
+#else
+    std::vector<iovec> buffers; ///< Header and payload for each chunk
+#endif
+#if defined(__linux__)
+    std::vector<mmsghdr> messages;
+#endif
+  };
+
+  struct Split_UDP_Socket::Receive_Buffer {
+    Receive_Buffer(const Uint16 &chunk_size)
+      : packets(g_receive_batch * chunk_size),
+        addresses(g_receive_batch),
+        sizes(g_receive_batch),
+        next(0u),
+        count(0u)
+    {
+    }
+
+    std::vector<char> packets; ///< Packet i at i * chunk_size
+    std::vector<IPaddress> addresses;
+    std::vector<size_t> sizes;
+    size_t next;
+    size_t count;
+#if defined(__linux__)
+    std::vector<sockaddr_in> names;
+    std::vector<iovec> buffers;
+    std::vector<mmsghdr> messages;
+#endif
+  };
+
+  Split_UDP_Socket::Split_UDP_Socket(const Uint16 &port, const Uint16 &chunk_sets, const Uint16 &chunk_size, const Uint32 &chunk_timeout, const Uint32 &max_message_size)
     : UDP_Socket(port),
       m_chunk_size(chunk_size),
-      m_chunk_collector(chunk_sets)
+      m_framing(FRAMING_32_BIT),
+      m_compressor(0),
+      m_chunk_collector(chunk_sets, chunk_size, chunk_timeout, max_message_size),
+      m_send_buffer(new Send_Buffer),
+      m_receive_buffer(new Receive_Buffer(chunk_size))
   {
     assert(chunk_size);
+
+#if defined(__linux__)
+    Receive_Buffer &rb = *m_receive_buffer;
+    rb.names.resize(g_receive_batch);
+    rb.buffers.resize(g_receive_batch);
+    rb.messages.resize(g_receive_batch);
+
+    for(size_t i = 0u; i != g_receive_batch; ++i) {
+      rb.buffers[i].iov_base = &rb.packets[i * m_chunk_size];
+      rb.buffers[i].iov_len = m_chunk_size;
+
+      memset(&rb.messages[i], 0, sizeof(mmsghdr));
+      rb.messages[i].msg_hdr.msg_iov = &rb.buffers[i];
+      rb.messages[i].msg_hdr.msg_iovlen = 1u;
+    }
+#endif
+  }
+
+  Split_UDP_Socket::~Split_UDP_Socket() {
+    delete m_compressor;
+    delete m_send_buffer;
+    delete m_receive_buffer;
+  }
+
+  void Split_UDP_Socket::enable_compression(const String &dictionary, const Uint32 &threshold) {
+    Net_Compressor * const compressor = new Net_Compressor(Net_Compressor::MESSAGES, dictionary, threshold);
+    delete m_compressor;
+    m_compressor = compressor;
+  }
+
+  void Split_UDP_Socket::disable_compression() {
+    delete m_compressor;
+    m_compressor = 0;
+  }
+  
+  void Split_UDP_Socket::send(const IPaddress &ip, const void * const &data, const Uint32 &num_bytes) {
+    if(m_compressor) {
+      const std::vector<char> &compressed = m_compressor->compress(data, num_bytes);
+      send_chunks(ip, &compressed[0], Uint32(compressed.size()));
+    }
+    else
+      send_chunks(ip, data, num_bytes);
   }
   
-  void Split_UDP_Socket::send(const IPaddress &ip, const void * const &data, const Uint16 &num_bytes) {
+  void Split_UDP_Socket::send(const IPaddress &ip, const String &data) {
+    send(ip, data.c_str(), Uint32(data.size()));
+  }
+
+  void Split_UDP_Socket::send_chunks(const IPaddress &ip, const void * const &data, const Uint32 &num_bytes) {
     ++m_nonce_send;
     
-    const Uint16 offset = static_cast<Uint16>(m_nonce_send.size()) + 2u * sizeof(Uint16);
-    const Uint16 split_size = Uint16(m_chunk_size - offset);
-    const Uint16 num_full_chunks = Uint16(num_bytes / split_size);
+    Uint16 offset = static_cast<Uint16>(m_nonce_send.size()) + 2u * sizeof(Uint16);
+    Uint16 split_size = Uint16(m_chunk_size - offset);
+    Uint32 num_chunks = num_bytes / split_size + (num_bytes % split_size ? 1u : 0u);
+
+    // Too many chunks to count in 16 bits, so escape to 32
+    const bool escaped = num_chunks >= 0xFFFFu;
+    if(escaped) {
+      if(m_framing == FRAMING_16_BIT)
+        throw Message_Too_Large();
+
+      offset = Uint16(offset + 2u * sizeof(Uint32) - sizeof(Uint16));
+      if(m_chunk_size <= offset)
+        throw Message_Too_Large();
+
+      split_size = Uint16(m_chunk_size - offset);
+      num_chunks = num_bytes / split_size + (num_bytes % split_size ? 1u : 0u);
+    }
+
+    const Uint32 num_full_chunks = num_bytes / split_size;
     const Uint16 partial_chunk = Uint16(num_bytes % split_size);
-    const Uint16 num_chunks = num_full_chunks + (partial_chunk ? 1u : 0u);
-    
-    const char *ptr = reinterpret_cast<const char *>(data);
-    for(Uint16 chunk = 0; chunk < num_full_chunks; ++chunk, ptr += split_size) {
-      String s;
-      
-      {
-        std::ostringstream os;
-        serialize(serialize(m_nonce_send.serialize(os), num_chunks), chunk);
-        s = os.str();
-      }
-      
-      s.resize(m_chunk_size);
-      memcpy(const_cast<char *>(s.c_str()) + offset, ptr, split_size);
-      
-      UDP_Socket::send(ip, s);
+
+    if(!num_chunks)
+      return;
+    if((num_full_chunks ? m_chunk_size : offset + partial_chunk) >= 8167u)
+      throw UDP_Packet_Overflow();
+    if(!sock)
+      throw Socket_Closed();
+
+    Send_Buffer &sb = *m_send_buffer;
+    if(sb.headers.size() < size_t(num_chunks) * offset) {
+      // Grows only, so steady traffic stops allocating after the largest message
+      sb.headers.resize(size_t(num_chunks) * offset);
+      sb.buffers.resize(2u * num_chunks);
+#if defined(__linux__)
+      sb.messages.resize(num_chunks);
+#endif
     }
-    
-    if(partial_chunk) {
-      String s;
-      
-      {
-        std::ostringstream os;
-        serialize(serialize(m_nonce_send.serialize(os), num_chunks), num_full_chunks);
-        s = os.str();
+
+    {// Write the first header as serialize would, then copy it, changing only 'which'
+      void *bp = &sb.headers[0];
+      SDLNet_Write16(Uint16(m_nonce_send.size() - sizeof(Uint16)), bp);
+      for(Uint16 i = sizeof(Uint16); i != m_nonce_send.size(); ++i)
+        sb.headers[i] = char(m_nonce_send[i - sizeof(Uint16)]);
+      bp = &sb.headers[m_nonce_send.size()];
+      if(escaped) {
+        SDLNet_Write16(Uint16(0xFFFFu), bp);
+        bp = &sb.headers[m_nonce_send.size() + sizeof(Uint16)];
+        SDLNet_Write32(num_chunks, bp);
+      }
+      else
+        SDLNet_Write16(Uint16(num_chunks), bp);
+
+      for(Uint32 chunk = 0; chunk < num_chunks; ++chunk) {
+        char * const header = &sb.headers[size_t(chunk) * offset];
+        if(chunk)
+          memcpy(header, &sb.headers[0], offset);
+        if(escaped) {
+          bp = header + offset - sizeof(Uint32);
+          SDLNet_Write32(chunk, bp);
+        }
+        else {
+          bp = header + offset - sizeof(Uint16);
+          SDLNet_Write16(Uint16(chunk), bp);
+        }
       }
-      
-      s.resize(size_t(offset + partial_chunk));
-      memcpy(const_cast<char *>(s.c_str()) + offset, ptr, partial_chunk);
-      
-      UDP_Socket::send(ip, s);
     }
+
+    // Point at the caller's data rather than copying it
+    char * const payloads = reinterpret_cast<char *>(const_cast<void *>(data));
+    for(Uint32 chunk = 0; chunk < num_chunks; ++chunk) {
+      char * const ptr = payloads + size_t(chunk) * split_size;
+      const Uint16 payload = chunk < num_full_chunks ? split_size : partial_chunk;
+#if defined(_WINDOWS)
+      sb.buffers[2u * chunk].buf = &sb.headers[size_t(chunk) * offset];
+      sb.buffers[2u * chunk].len = offset;
+      sb.buffers[2u * chunk + 1u].buf = ptr;
+      sb.buffers[2u * chunk + 1u].len = payload;
+#else
+      sb.buffers[2u * chunk].iov_base = &sb.headers[size_t(chunk) * offset];
+      sb.buffers[2u * chunk].iov_len = offset;
+      sb.buffers[2u * chunk + 1u].iov_base = ptr;
+      sb.buffers[2u * chunk + 1u].iov_len = payload;
+#endif
+    }
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = ip.host;
+    address.sin_port = ip.port;
+
+    const Net::Socket_Header &header = Net::get_Socket_Header(sock);
+
+#if defined(_WINDOWS)
+    for(Uint32 chunk = 0; chunk < num_chunks; ++chunk) {
+      DWORD sent = 0;
+      if(WSASendTo(SOCKET(header.channel), &sb.buffers[2u * chunk], 2u, &sent, 0,
+                   reinterpret_cast<sockaddr *>(&address), sizeof(address), 0, 0) == SOCKET_ERROR)
+        throw Socket_Closed();
+    }
+#else
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_name = &address;
+    message.msg_namelen = sizeof(address);
+    message.msg_iovlen = 2u;
+
+#if defined(__linux__)
+    for(Uint32 chunk = 0; chunk < num_chunks; ++chunk) {
+      sb.messages[chunk].msg_hdr = message;
+      sb.messages[chunk].msg_hdr.msg_iov = &sb.buffers[2u * chunk];
+      sb.messages[chunk].msg_len = 0u;
+    }
+
+    // Every chunk of the message in as few system calls as possible
+    for(Uint32 chunk = 0; chunk < num_chunks;) {
+      const int sent = sendmmsg(header.channel, &sb.messages[chunk], num_chunks - chunk, 0);
+      if(sent < 1)
+        throw Socket_Closed();
+      chunk += Uint32(sent);
+    }
+#else
+    for(Uint32 chunk = 0; chunk < num_chunks; ++chunk) {
+      message.msg_iov = &sb.buffers[2u * chunk];
+      if(sendmsg(header.channel, &message, 0) == -1)
+        throw Socket_Closed();
+    }
+#endif
+#endif
   }
-  
-  void Split_UDP_Socket::send(const IPaddress &ip, const String &data) {
-    send(ip, data.c_str(), Uint16(data.size()));
-  }
-
-  int Split_UDP_Socket::receive(IPaddress &ip, const void * const &data, const Uint16 &num_bytes) {
-    for(int retval = -1; retval;) {
-      String s;
-      s.resize(m_chunk_size);
-      
-      retval = UDP_Socket::receive(ip, s);
-      if(retval) {
-        Nonce nonce;
-        Uint16 num_chunks;
-        Uint16 which;
-        Chunk chunk;
-        
-        {
-          std::istringstream is(s.std_str());
-          unserialize(unserialize(nonce.unserialize(is), num_chunks), which);
-
-          if(!is)
-            continue;
-
-          const Uint16 offset = static_cast<Uint16>(nonce.size()) + 2u * sizeof(Uint16);
-          
-          chunk.size = s.size() - offset;
-          chunk.data = new char [chunk.size];
-          memcpy(chunk.data, s.c_str() + offset, chunk.size);
+
+  int Split_UDP_Socket::receive(IPaddress &ip, const void * const &data, const Uint32 &num_bytes) {
+    Receive_Buffer &rb = *m_receive_buffer;
+    const Uint32 now = SDL_GetTicks();
+
+    m_chunk_collector.expire(now);
+
+    for(;;) {
+      if(rb.next == rb.count) {
+        rb.next = 0u;
+        rb.count = 0u;
+
+#if defined(__linux__)
+        if(!sock)
+          throw Socket_Closed();
+
+        for(size_t i = 0u; i != g_receive_batch; ++i) {
+          rb.messages[i].msg_hdr.msg_name = &rb.names[i];
+          rb.messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        }
+
+        // As many packets as are waiting, up to a batch, in one system call
+        const int received = recvmmsg(Net::get_Socket_Header(sock).channel, &rb.messages[0], unsigned(g_receive_batch), MSG_DONTWAIT, 0);
+        if(received == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+          throw Socket_Closed();
+
+        for(int i = 0; i < received; ++i) {
+          rb.addresses[i].host = rb.names[i].sin_addr.s_addr;
+          rb.addresses[i].port = rb.names[i].sin_port;
+          rb.sizes[i] = rb.messages[i].msg_len;
+        }
+        rb.count = received > 0 ? size_t(received) : 0u;
+#else
+        const int received = UDP_Socket::receive(rb.addresses[0], &rb.packets[0], m_chunk_size);
+        rb.sizes[0] = size_t(received);
+        rb.count = received > 0 ? 1u : 0u;
+#endif
+
+        if(!rb.count) {
+          ip.host = 0;
+          ip.port = 0;
+          return 0;
         }
-        
-        const Chunk_Set * cs = m_chunk_collector.add_chunk(ip, nonce, num_chunks, which, chunk);
-        if(!cs)
+      }
+
+      const size_t packet = rb.next++;
+      Chunk_Set * const cs = m_chunk_collector.add_chunk(rb.addresses[packet], &rb.packets[packet * m_chunk_size], rb.sizes[packet], now);
+      if(!cs)
+        continue;
+
+      if(m_compressor) {
+        try {
+          m_compressor->decompress(m_decompressed, &cs->data[0], Uint32(cs->size()), m_chunk_collector.get_max_message_size());
+        }
+        catch(Compression_Corrupt &) {
+          m_chunk_collector.release(cs);
+          continue;
+        }
+        catch(Message_Too_Large &) {
+          m_chunk_collector.release(cs);
           continue;
-        
-        Chunk packet = cs->receive();
-        if(num_bytes >= Uint16(packet.size)) {
-          memcpy(const_cast<void *>(data), packet.data, packet.size);
-          return int(packet.size);
         }
-        
-        return 0;
       }
+
+      ip = cs->ip;
+
+      const char * const message = m_compressor ? m_decompressed.c_str() : &cs->data[0];
+      const size_t message_size = m_compressor ? m_decompressed.size() : cs->size();
+
+      int retval = 0;
+      if(num_bytes >= message_size) {
+        memcpy(const_cast<void *>(data), message, message_size);
+        retval = int(message_size);
+      }
+
+      m_chunk_collector.release(cs);
+
+      return retval;
     }
-    
-    return 0;
   }
   
   int Split_UDP_Socket::receive(IPaddress &ip, String &data) {
-    int retval = receive(ip, data.c_str(), Uint16(data.size()));
+    int retval = receive(ip, data.c_str(), Uint32(data.size()));
     
     if(int(data.size()) > retval) {
       data[static_cast<unsigned int>(retval)] = '\0';
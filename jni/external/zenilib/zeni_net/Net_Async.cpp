@@ -0,0 +1,485 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_net.h>
+
+#include <SDL/SDL.h>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+
+#if defined(_WINDOWS)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#if defined(_DEBUG) && defined(_WINDOWS)
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+
+namespace Zeni {
+
+  static const size_t g_resolver_threads = 2u; ///< So that one slow lookup does not hold up every other
+
+#if defined(_WINDOWS)
+  static const uintptr_t g_invalid_channel = INVALID_SOCKET;
+#else
+  static const int g_invalid_channel = -1;
+#endif
+
+  struct Net::Lookup {
+    Lookup(const bool &reverse_)
+      : reverse(reverse_)
+    {
+      SDL_AtomicSet(&references, 2);
+      SDL_AtomicSet(&state, Host_Lookup::PENDING);
+      address.host = 0;
+      address.port = 0;
+    }
+
+    /// Free the Lookup once both the Host_Lookup and the resolver are done with it
+    void release() {
+      if(SDL_AtomicAdd(&references, -1) == 1)
+        delete this;
+    }
+
+    SDL_atomic_t references;
+    SDL_atomic_t state; ///< Left PENDING by whichever of the Host_Lookup and the resolver gets to it second
+
+    // Written by the resolver before it leaves PENDING
+    const bool reverse;
+    String host;
+    IPaddress address;
+  };
+
+  struct Net::Resolver {
+    Resolver()
+      : mutex(SDL_CreateMutex()),
+      pending(SDL_CreateSemaphore(0u)),
+      quit(false)
+    {
+      SDL_AtomicSet(&references, 1);
+    }
+
+    ~Resolver() {
+      SDL_DestroySemaphore(pending);
+      SDL_DestroyMutex(mutex);
+    }
+
+    /// Free the Resolver once Net and every thread are done with it
+    void release() {
+      if(SDL_AtomicAdd(&references, -1) == 1)
+        delete this;
+    }
+
+    static int run(void * resolver_);
+    static void resolve(Lookup &lookup);
+
+    SDL_atomic_t references;
+    SDL_mutex * mutex;
+    SDL_sem * pending; ///< Posted once per queued Lookup, and once per thread to quit
+
+    // Guarded by mutex
+    bool quit;
+    std::deque<Lookup *> queue;
+  };
+
+  int Net::Resolver::run(void * resolver_) {
+    Resolver &resolver = *reinterpret_cast<Resolver *>(resolver_);
+
+    for(;;) {
+      SDL_SemWait(resolver.pending);
+
+      SDL_LockMutex(resolver.mutex);
+      if(resolver.quit) {
+        SDL_UnlockMutex(resolver.mutex);
+        break;
+      }
+      Lookup * const lookup = resolver.queue.front();
+      resolver.queue.pop_front();
+      SDL_UnlockMutex(resolver.mutex);
+
+      // Skip those that were cancelled or timed out while queued
+      if(SDL_AtomicGet(&lookup->state) == Host_Lookup::PENDING)
+        resolve(*lookup);
+
+      lookup->release();
+    }
+
+    resolver.release();
+    return 0;
+  }
+
+  void Net::Resolver::resolve(Lookup &lookup) {
+    Host_Lookup::State state = Host_Lookup::FAILED;
+
+    if(lookup.reverse) {
+      sockaddr_in address;
+      memset(&address, 0, sizeof(address));
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = lookup.address.host;
+      address.sin_port = lookup.address.port;
+
+      char host[NI_MAXHOST];
+      if(!getnameinfo(reinterpret_cast<sockaddr *>(&address), sizeof(address), host, sizeof(host), 0, 0, NI_NAMEREQD)) {
+        lookup.host = host;
+        state = Host_Lookup::SUCCEEDED;
+      }
+    }
+    else if(lookup.host.empty()) {
+      // As SDLNet_ResolveHost would for a null host
+      lookup.address.host = INADDR_ANY;
+      state = Host_Lookup::SUCCEEDED;
+    }
+    else {
+      addrinfo hints;
+      memset(&hints, 0, sizeof(hints));
+      hints.ai_family = AF_INET;
+      hints.ai_socktype = SOCK_STREAM;
+
+      addrinfo *results = 0;
+      if(!getaddrinfo(lookup.host.c_str(), 0, &hints, &results) && results) {
+        lookup.address.host = reinterpret_cast<sockaddr_in *>(results->ai_addr)->sin_addr.s_addr;
+        state = Host_Lookup::SUCCEEDED;
+      }
+      if(results)
+        freeaddrinfo(results);
+    }
+
+    // The results are published only if the Host_Lookup is still waiting
+    SDL_AtomicCAS(&lookup.state, Host_Lookup::PENDING, state);
+  }
+
+  void Net::resolve(Lookup * const &lookup) {
+    if(!m_resolver) {
+      Resolver * const resolver = new Resolver;
+
+      for(size_t i = 0u; i != g_resolver_threads; ++i) {
+        SDL_AtomicAdd(&resolver->references, 1);
+        SDL_Thread * const thread = SDL_CreateThread(&Resolver::run, "Zeni::Net::Resolver", resolver);
+        if(thread)
+          SDL_DetachThread(thread);
+        else
+          resolver->release();
+      }
+
+      m_resolver = resolver;
+    }
+
+    SDL_LockMutex(m_resolver->mutex);
+    m_resolver->queue.push_back(lookup);
+    SDL_UnlockMutex(m_resolver->mutex);
+
+    SDL_SemPost(m_resolver->pending);
+  }
+
+  void Net::stop_resolver() {
+    if(!m_resolver)
+      return;
+
+    SDL_LockMutex(m_resolver->mutex);
+    m_resolver->quit = true;
+    for(std::deque<Lookup *>::iterator it = m_resolver->queue.begin(); it != m_resolver->queue.end(); ++it) {
+      SDL_AtomicCAS(&(*it)->state, Host_Lookup::PENDING, Host_Lookup::FAILED);
+      (*it)->release();
+    }
+    m_resolver->queue.clear();
+    SDL_UnlockMutex(m_resolver->mutex);
+
+    // Threads busy with a lookup quit once the system answers; Nothing waits for them
+    for(size_t i = 0u; i != g_resolver_threads; ++i)
+      SDL_SemPost(m_resolver->pending);
+
+    m_resolver->release();
+    m_resolver = 0;
+  }
+
+  Host_Lookup::Host_Lookup(const String &host, const Uint16 &port, const Uint32 &timeout)
+    : m_state(PENDING),
+    m_lookup(new Net::Lookup(false)),
+    m_start(SDL_GetTicks()),
+    m_timeout(timeout),
+    m_host(host)
+  {
+    m_lookup->host = host;
+    SDLNet_Write16(port, &m_lookup->address.port);
+    m_address = m_lookup->address;
+
+    get_Net().resolve(m_lookup);
+  }
+
+  Host_Lookup::Host_Lookup(const IPaddress &address, const Uint32 &timeout)
+    : m_state(PENDING),
+    m_lookup(new Net::Lookup(true)),
+    m_start(SDL_GetTicks()),
+    m_timeout(timeout),
+    m_address(address)
+  {
+    m_lookup->address = address;
+
+    get_Net().resolve(m_lookup);
+  }
+
+  Host_Lookup::~Host_Lookup() {
+    cancel();
+  }
+
+  const Host_Lookup::State & Host_Lookup::update() {
+    if(m_state != PENDING)
+      return m_state;
+
+    if(SDL_GetTicks() - m_start >= m_timeout)
+      SDL_AtomicCAS(&m_lookup->state, PENDING, TIMED_OUT);
+
+    m_state = State(SDL_AtomicGet(&m_lookup->state));
+    if(m_state == SUCCEEDED) {
+      m_address = m_lookup->address;
+      m_host = m_lookup->host;
+    }
+
+    if(m_state != PENDING) {
+      m_lookup->release();
+      m_lookup = 0;
+    }
+
+    return m_state;
+  }
+
+  void Host_Lookup::cancel() {
+    if(m_state != PENDING)
+      return;
+
+    if(SDL_AtomicCAS(&m_lookup->state, PENDING, CANCELLED))
+      m_state = CANCELLED;
+    else
+      update();
+
+    if(m_lookup) {
+      m_lookup->release();
+      m_lookup = 0;
+    }
+  }
+
+  TCP_Connector::TCP_Connector(const IPaddress &address, const Uint32 &timeout)
+    : m_state(CONNECTING),
+    m_lookup(0),
+    m_start(SDL_GetTicks()),
+    m_timeout(timeout),
+    m_address(address),
+    m_channel(g_invalid_channel),
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4355 )
+#endif
+    m_uninit(*this)
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  {
+    get_Net().lend_pre_uninit(&m_uninit);
+
+    connect();
+  }
+
+  TCP_Connector::TCP_Connector(const String &host, const Uint16 &port, const Uint32 &timeout)
+    : m_state(RESOLVING),
+    m_lookup(new Host_Lookup(host, port, timeout)),
+    m_start(SDL_GetTicks()),
+    m_timeout(timeout),
+    m_channel(g_invalid_channel),
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4355 )
+#endif
+    m_uninit(*this)
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  {
+    m_address.host = 0;
+    m_address.port = 0;
+
+    get_Net().lend_pre_uninit(&m_uninit);
+  }
+
+  TCP_Connector::~TCP_Connector() {
+    Net::remove_pre_uninit(&m_uninit);
+
+    delete m_lookup;
+    close();
+  }
+
+  const TCP_Connector::State & TCP_Connector::update() {
+    if(m_state == RESOLVING) {
+      switch(m_lookup->update()) {
+        case Host_Lookup::SUCCEEDED:
+          m_address = m_lookup->get_address();
+          delete m_lookup;
+          m_lookup = 0;
+          m_state = CONNECTING;
+          connect();
+          break;
+
+        case Host_Lookup::PENDING:
+          break;
+
+        case Host_Lookup::TIMED_OUT:
+          finish(TIMED_OUT);
+          return m_state;
+
+        default:
+          finish(FAILED);
+          return m_state;
+      }
+    }
+
+    if(m_state == CONNECTING) {
+      // Writable once connected, or once the attempt has failed
+#if defined(_WINDOWS)
+      fd_set writable, failed;
+      FD_ZERO(&writable);
+      FD_ZERO(&failed);
+      FD_SET(SOCKET(m_channel), &writable);
+      FD_SET(SOCKET(m_channel), &failed);
+      timeval immediately = {0, 0};
+      const bool done = select(0, 0, &writable, &failed, &immediately) > 0;
+#else
+      pollfd pfd;
+      pfd.fd = m_channel;
+      pfd.events = POLLOUT;
+      pfd.revents = 0;
+      const bool done = poll(&pfd, 1, 0) > 0;
+#endif
+
+      if(done) {
+        int error = 0;
+        socklen_t error_size = sizeof(error);
+        if(getsockopt(m_channel, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&error), &error_size) || error)
+          finish(FAILED);
+        else {
+          // SDL_net expects blocking sockets, with Nagle's algorithm off
+#if defined(_WINDOWS)
+          u_long mode = 0;
+          ioctlsocket(SOCKET(m_channel), FIONBIO, &mode);
+#else
+          fcntl(m_channel, F_SETFL, fcntl(m_channel, F_GETFL) & ~O_NONBLOCK);
+#endif
+          int yes = 1;
+          setsockopt(m_channel, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char *>(&yes), sizeof(yes));
+
+          m_state = CONNECTED;
+        }
+      }
+    }
+
+    if((m_state == RESOLVING || m_state == CONNECTING) && SDL_GetTicks() - m_start >= m_timeout)
+      finish(TIMED_OUT);
+
+    return m_state;
+  }
+
+  void TCP_Connector::cancel() {
+    // A released connection belongs to its TCP_Socket
+    if(m_state == RESOLVING || m_state == CONNECTING || m_channel != g_invalid_channel)
+      finish(CANCELLED);
+  }
+
+  TCPsocket TCP_Connector::release() {
+    if(m_state != CONNECTED || m_channel == g_invalid_channel)
+      return 0;
+
+    // Allocated as SDL_net allocates its own, since SDLNet_TCP_Close will free it
+    Net::TCP_Socket_Layout * const socket = reinterpret_cast<Net::TCP_Socket_Layout *>(malloc(sizeof(Net::TCP_Socket_Layout)));
+    if(!socket)
+      return 0;
+
+    memset(socket, 0, sizeof(Net::TCP_Socket_Layout));
+    socket->channel = m_channel;
+    socket->remote_address = m_address;
+    socket->sflag = 0;
+
+    m_channel = g_invalid_channel;
+
+    return reinterpret_cast<TCPsocket>(socket);
+  }
+
+  void TCP_Connector::connect() {
+    m_channel = socket(AF_INET, SOCK_STREAM, 0);
+    if(m_channel == g_invalid_channel) {
+      finish(FAILED);
+      return;
+    }
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = m_address.host;
+    address.sin_port = m_address.port;
+
+#if defined(_WINDOWS)
+    u_long mode = 1;
+    ioctlsocket(SOCKET(m_channel), FIONBIO, &mode);
+    const bool started = ::connect(SOCKET(m_channel), reinterpret_cast<sockaddr *>(&address), sizeof(address)) != SOCKET_ERROR ||
+                         WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    fcntl(m_channel, F_SETFL, fcntl(m_channel, F_GETFL) | O_NONBLOCK);
+    const bool started = ::connect(m_channel, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != -1 ||
+                         errno == EINPROGRESS;
+#endif
+
+    if(!m_address.host || !started)
+      finish(FAILED);
+  }
+
+  void TCP_Connector::close() {
+    if(m_channel == g_invalid_channel)
+      return;
+
+#if defined(_WINDOWS)
+    closesocket(SOCKET(m_channel));
+#else
+    ::close(m_channel);
+#endif
+    m_channel = g_invalid_channel;
+  }
+
+  void TCP_Connector::finish(const State &state) {
+    if(m_lookup) {
+      delete m_lookup;
+      m_lookup = 0;
+    }
+
+    close();
+    m_state = state;
+  }
+
+  void TCP_Connector::Uninit::operator()() {
+    if(m_connector.m_state == RESOLVING || m_connector.m_state == CONNECTING || m_connector.m_channel != g_invalid_channel)
+      m_connector.finish(FAILED);
+  }
+
+}
@@ -0,0 +1,868 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_net.h>
+
+#ifdef ENABLE_BENCHMARKS
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <sstream>
+
+#if defined(_DEBUG) && defined(_WINDOWS)
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+
+namespace Zeni {
+
+  /// Split_UDP_Socket::send as it was before it went zero-copy, returning the number of chunks sent
+  static Uint16 stream_split_send(UDP_Socket &socket, const IPaddress &ip, Nonce &nonce, const Uint16 &chunk_size, const char * const &data, const Uint16 &num_bytes) {
+    ++nonce;
+
+    const Uint16 offset = static_cast<Uint16>(nonce.size()) + 2u * sizeof(Uint16);
+    const Uint16 split_size = Uint16(chunk_size - offset);
+    const Uint16 num_chunks = Uint16((num_bytes + split_size - 1u) / split_size);
+
+    for(Uint16 chunk = 0; chunk < num_chunks; ++chunk) {
+      const Uint16 payload = chunk + 1u < num_chunks ? split_size : Uint16(num_bytes - chunk * split_size);
+      String s;
+
+      {
+        std::ostringstream os;
+        serialize(serialize(nonce.serialize(os), num_chunks), chunk);
+        s = os.str();
+      }
+
+      s.resize(size_t(offset + payload));
+      memcpy(const_cast<char *>(s.c_str()) + offset, data + chunk * split_size, payload);
+
+      socket.send(ip, s);
+    }
+
+    return num_chunks;
+  }
+
+  class Replication_Benchmark_Entity : public Replicated {
+  public:
+    Replication_Benchmark_Entity()
+      : x(0.0f), y(0.0f), z(0.0f), heading(0.0f), health(100u), state(0u)
+    {
+    }
+
+    Uint16 get_type() const {return 1u;}
+    Uint16 get_num_fields() const {return 7u;}
+
+    void serialize_field(Byte_Writer &writer, const Uint16 &field) const {
+      switch(field) {
+        case 0: serialize(writer, x); break;
+        case 1: serialize(writer, y); break;
+        case 2: serialize(writer, z); break;
+        case 3: serialize(writer, heading); break;
+        case 4: serialize(writer, health); break;
+        case 5: serialize(writer, state); break;
+        default: serialize(writer, name); break;
+      }
+    }
+
+    void unserialize_field(Byte_Reader &reader, const Uint16 &field) {
+      switch(field) {
+        case 0: unserialize(reader, x); break;
+        case 1: unserialize(reader, y); break;
+        case 2: unserialize(reader, z); break;
+        case 3: unserialize(reader, heading); break;
+        case 4: unserialize(reader, health); break;
+        case 5: unserialize(reader, state); break;
+        default: unserialize(reader, name); break;
+      }
+    }
+
+    /// Nearer the client (at the origin) matters more
+    float get_priority(const IPaddress &) const {
+      return 1000.0f / (1000.0f + std::sqrt(x * x + y * y));
+    }
+
+    bool operator==(const Replication_Benchmark_Entity &rhs) const {
+      return x == rhs.x && y == rhs.y && z == rhs.z && heading == rhs.heading &&
+             health == rhs.health && state == rhs.state && name == rhs.name;
+    }
+
+    float x, y, z;
+    float heading;
+    Uint16 health;
+    unsigned char state;
+    String name;
+  };
+
+  class Replication_Benchmark_Factory : public Replication_Client::Factory {
+  public:
+    Replicated * create(const Uint16 &type) {
+      return type == 1u ? new Replication_Benchmark_Entity : 0;
+    }
+  };
+
+  void Net_Benchmark::idle_connections(std::ostream &os, const Uint16 &port, const size_t &max_connections) {
+    const int ticks = 100;
+
+    Net_Poller poller;
+    TCP_Listener listener(port);
+    const IPaddress ip = get_Net().resolve_host("127.0.0.1", port);
+
+    std::vector<TCP_Socket *> clients;
+    std::vector<TCP_Socket *> servers;
+
+    try {
+      for(size_t connections = 16u; connections <= max_connections; connections *= 2u) {
+        while(servers.size() < connections) {
+          clients.push_back(0);
+          clients.back() = new TCP_Socket(ip);
+
+          TCPsocket accepted = 0;
+          for(int attempt = 0; !accepted && attempt != 100; ++attempt) {
+            accepted = listener.accept();
+            if(!accepted)
+              SDL_Delay(1);
+          }
+
+          servers.push_back(0);
+          servers.back() = new TCP_Socket(accepted);
+          poller.add(*servers.back());
+        }
+
+        Timer_HQ &thq = get_Timer_HQ();
+
+        const Time_HQ poller_start = thq.get_time();
+        for(int tick = 0; tick != ticks; ++tick)
+          poller.wait(0);
+        const double poller_seconds = double(thq.get_time().get_seconds_since(poller_start)) / ticks;
+
+        const Time_HQ check_start = thq.get_time();
+        for(int tick = 0; tick != ticks; ++tick)
+          for(std::vector<TCP_Socket *>::iterator it = servers.begin(); it != servers.end(); ++it)
+            (*it)->try_check_socket();
+        const double check_seconds = double(thq.get_time().get_seconds_since(check_start)) / ticks;
+
+        os << std::fixed << std::setprecision(1) << connections << " connections: "
+           << (Net_Poller::is_epoll() ? "epoll " : "poll ") << 1000000.0 * poller_seconds << " us per tick, "
+           << "per-socket select " << 1000000.0 * check_seconds << " us per tick\n";
+      }
+    }
+    catch(Error &error) {
+      // Most likely out of file descriptors
+      os << "Stopped at " << servers.size() << " connections: " << error.msg << '\n';
+    }
+
+    for(std::vector<TCP_Socket *>::iterator it = servers.begin(); it != servers.end(); ++it) {
+      if(*it) {
+        poller.remove(**it);
+        delete *it;
+      }
+    }
+
+    for(std::vector<TCP_Socket *>::iterator it = clients.begin(); it != clients.end(); ++it)
+      delete *it;
+  }
+
+  void Net_Benchmark::split_udp_send(std::ostream &os, const Uint16 &port, const Uint16 &chunk_size) {
+    const size_t packets = 100000u;
+    const Uint16 message_sizes[] = {1024u, 16384u, 65535u};
+
+    // Nothing reads the receiver; The kernel drops whatever overflows its buffer
+    UDP_Socket receiver(port);
+    UDP_Socket stream_sender(0);
+    Split_UDP_Socket split_sender(0, 1u, chunk_size);
+    const IPaddress ip = get_Net().resolve_host("127.0.0.1", port);
+
+    const std::vector<char> message(65535u, 'z');
+    Nonce nonce;
+
+    Timer_HQ &thq = get_Timer_HQ();
+
+    for(size_t i = 0u; i != sizeof(message_sizes) / sizeof(Uint16); ++i) {
+      const Uint16 &num_bytes = message_sizes[i];
+
+      // Both senders' Nonces advance in step, so both send the same number of chunks
+      size_t messages = 0u;
+      size_t stream_packets = 0u;
+      const Time_HQ stream_start = thq.get_time();
+      for(; stream_packets < packets; ++messages)
+        stream_packets += stream_split_send(stream_sender, ip, nonce, chunk_size, &message[0], num_bytes);
+      const double stream_seconds = double(thq.get_time().get_seconds_since(stream_start));
+
+      const Time_HQ split_start = thq.get_time();
+      for(size_t sent = 0u; sent != messages; ++sent)
+        split_sender.send(ip, &message[0], num_bytes);
+      const double split_seconds = double(thq.get_time().get_seconds_since(split_start));
+
+      os << std::fixed << std::setprecision(0) << num_bytes << " byte messages in " << chunk_size << " byte chunks: "
+         << "ostringstream " << stream_packets / stream_seconds << " packets/s, "
+         << "zero-copy " << stream_packets / split_seconds << " packets/s\n";
+    }
+  }
+
+  void Net_Benchmark::split_udp_loss(std::ostream &os, const Uint16 &port, const Uint16 &chunk_size) {
+    const size_t messages = 2000u;
+    const Uint16 message_size = Uint16(8u * chunk_size);
+    const Uint32 timeout = 50u;
+    const float loss_rates[] = {0.0f, 0.01f, 0.05f, 0.2f};
+
+    Random random(42u);
+    String message(message_size, 'z');
+    String received(message_size, '\0');
+    String packet(chunk_size, '\0');
+    String held;
+
+    for(size_t i = 0u; i != sizeof(loss_rates) / sizeof(float); ++i) {
+      const float &loss = loss_rates[i];
+
+      // The sender reaches the receiver only through the relay
+      UDP_Socket relay(port);
+      Split_UDP_Socket sender(0u, 64u, chunk_size);
+      Split_UDP_Socket receiver(Uint16(port + 1u), 64u, chunk_size, timeout);
+      const IPaddress relay_ip = get_Net().resolve_host("127.0.0.1", port);
+      const IPaddress receiver_ip = get_Net().resolve_host("127.0.0.1", Uint16(port + 1u));
+
+      size_t delivered = 0u;
+      size_t corrupt = 0u;
+      size_t most_incomplete = 0u;
+
+      Timer_HQ &thq = get_Timer_HQ();
+      const Time_HQ start = thq.get_time();
+
+      for(size_t sent = 0u; sent != messages; ++sent) {
+        // Stamp each message so that mixed up chunks would show
+        for(size_t j = 0u; j != message.size(); ++j)
+          message[j] = char('a' + (sent + j / chunk_size) % 26u);
+        sender.send(relay_ip, message);
+
+        IPaddress ip;
+        for(;;) {
+          // receive shrinks the String to fit what arrived
+          packet.resize(chunk_size);
+          if(!relay.receive(ip, packet))
+            break;
+
+          const float roll = random.frand_lt();
+          if(roll < loss)
+            continue;
+
+          if(roll < 2.0f * loss) {
+            // Duplicate
+            relay.send(receiver_ip, packet);
+          }
+          else if(roll < 3.0f * loss && held.empty()) {
+            // Reorder by holding onto this packet until after the next one
+            held = packet;
+            continue;
+          }
+
+          relay.send(receiver_ip, packet);
+
+          if(!held.empty()) {
+            relay.send(receiver_ip, held);
+            held.clear();
+          }
+        }
+
+        for(;;) {
+          received.resize(message_size);
+          const int size = receiver.receive(ip, received);
+          if(!size)
+            break;
+
+          ++delivered;
+          if(size_t(size) != message_size || received[0] < 'a' || received[0] > 'z')
+            ++corrupt;
+          else {
+            const size_t stamp = size_t(received[0] - 'a');
+            for(size_t j = 0u; j != received.size(); ++j)
+              if(received[j] != char('a' + (stamp + j / chunk_size) % 26u)) {
+                ++corrupt;
+                break;
+              }
+          }
+        }
+
+        if(receiver.get_num_incomplete() > most_incomplete)
+          most_incomplete = receiver.get_num_incomplete();
+      }
+
+      const double seconds = double(thq.get_time().get_seconds_since(start));
+
+      // Give everything still incomplete time to expire
+      SDL_Delay(2u * timeout);
+      IPaddress ip;
+      received.resize(message_size);
+      receiver.receive(ip, received);
+
+      os << std::fixed << std::setprecision(1) << 100.0f * loss << "% loss: "
+         << delivered << '/' << messages << " messages delivered, "
+         << corrupt << " corrupt, "
+         << most_incomplete << " incomplete at most, "
+         << receiver.get_num_incomplete() << " left after the timeout, "
+         << std::setprecision(0) << messages * ((message_size + chunk_size - 1u) / chunk_size) / seconds << " packets/s\n";
+    }
+  }
+
+  void Net_Benchmark::udp_channel(std::ostream &os, const Uint16 &port, const size_t &messages) {
+    struct Condition {
+      float loss;
+      Uint32 latency; ///< Milliseconds each way
+      Uint32 jitter; ///< Up to this many more milliseconds
+    };
+
+    const Condition conditions[] = {{0.0f, 0u, 0u}, {0.02f, 20u, 5u}, {0.05f, 40u, 20u}, {0.1f, 50u, 25u}};
+    const Uint16 message_size = 200u;
+    const size_t messages_per_tick = 1u;
+    const Uint32 deadline = 30000u;
+
+    Random random(42u);
+    String message(message_size, '\0');
+    String packet(1200u, '\0');
+
+    for(size_t i = 0u; i != sizeof(conditions) / sizeof(Condition); ++i) {
+      const Condition &condition = conditions[i];
+
+      // a <-> relay_a ... relay_b <-> b
+      UDP_Socket relay_a(Uint16(port + 1u));
+      UDP_Socket relay_b(Uint16(port + 2u));
+      UDP_Channel a(port, get_Net().resolve_host("127.0.0.1", Uint16(port + 1u)));
+      UDP_Channel b(Uint16(port + 3u), get_Net().resolve_host("127.0.0.1", Uint16(port + 2u)));
+      const IPaddress a_ip = get_Net().resolve_host("127.0.0.1", port);
+      const IPaddress b_ip = get_Net().resolve_host("127.0.0.1", Uint16(port + 3u));
+
+      std::multimap<Uint32, std::pair<bool, String> > delayed; ///< (release time, (to b, packet))
+      std::vector<bool> received(messages, false);
+      std::vector<Uint32> latencies;
+      latencies.reserve(messages);
+      size_t duplicates = 0u;
+      size_t out_of_order = 0u;
+      Uint32 next_ordered = 0u;
+
+      const Uint32 start = SDL_GetTicks();
+      Uint32 now = start;
+      size_t sent = 0u;
+
+      while(latencies.size() + duplicates < messages && now - start < deadline) {
+        now = SDL_GetTicks();
+
+        // Offer a steady load rather than everything at once
+        for(size_t j = 0u; j != messages_per_tick && sent != messages; ++j, ++sent) {
+          void *bp = &message[0];
+          SDLNet_Write32(Uint32(sent), bp);
+          bp = &message[4];
+          SDLNet_Write32(now, bp);
+          a.send(message, sent % 2u ? UDP_Channel::UNORDERED : UDP_Channel::ORDERED);
+        }
+
+        a.update();
+
+        for(int side = 0; side != 2; ++side) {
+          UDP_Socket &relay = side ? relay_b : relay_a;
+
+          for(;;) {
+            // receive shrinks the String to fit what arrived
+            packet.resize(1200u);
+            IPaddress ip;
+            if(!relay.receive(ip, packet))
+              break;
+
+            if(random.frand_lt() < condition.loss)
+              continue;
+
+            const Uint32 jitter = condition.jitter ? Uint32(random.rand_lte(Sint32(condition.jitter))) : 0u;
+            delayed.insert(std::make_pair(now + condition.latency + jitter, std::make_pair(!side, packet)));
+          }
+        }
+
+        while(!delayed.empty() && Sint32(delayed.begin()->first - now) <= 0) {
+          const std::pair<bool, String> &forward = delayed.begin()->second;
+          if(forward.first)
+            relay_b.send(b_ip, forward.second);
+          else
+            relay_a.send(a_ip, forward.second);
+          delayed.erase(delayed.begin());
+        }
+
+        b.update();
+
+        for(String data; b.receive(data); ) {
+          const void *bp = data.c_str();
+          const Uint32 index = SDLNet_Read32(bp);
+          bp = data.c_str() + 4;
+          const Uint32 sent_at = SDLNet_Read32(bp);
+
+          if(index >= messages || received[index]) {
+            ++duplicates;
+            continue;
+          }
+
+          received[index] = true;
+          latencies.push_back(now - sent_at);
+
+          if(!(index % 2u)) {
+            if(index != next_ordered)
+              ++out_of_order;
+            next_ordered = index + 2u;
+          }
+        }
+
+        SDL_Delay(1u);
+      }
+
+      const double seconds = (now - start) / 1000.0;
+
+      std::sort(latencies.begin(), latencies.end());
+      const size_t count = latencies.size();
+
+      os << std::fixed << std::setprecision(1) << 100.0f * condition.loss << "% loss, "
+         << condition.latency << '+' << condition.jitter << " ms: "
+         << count << '/' << messages << " delivered, "
+         << out_of_order << " out of order, "
+         << duplicates << " duplicates, "
+         << count * message_size / seconds / 1024.0 << " KB/s, latency";
+
+      if(count)
+        os << " p50 " << latencies[count / 2u]
+           << " p90 " << latencies[count * 9u / 10u]
+           << " p99 " << latencies[count * 99u / 100u]
+           << " max " << latencies.back() << " ms, ";
+      else
+        os << " n/a, ";
+
+      os << a.get_num_retransmissions() << " retransmissions, rtt " << a.get_rtt() << " ms\n";
+    }
+  }
+
+
+  void Net_Benchmark::replication(std::ostream &os, const size_t &entities, const size_t &ticks) {
+    struct Condition {
+      size_t budget; ///< Bytes per packet
+      float loss; ///< Of packets and acknowledgements alike
+      size_t ack_delay; ///< Ticks
+    };
+
+    const Condition conditions[] = {{65536u, 0.0f, 0u}, {1200u, 0.0f, 0u}, {1200u, 0.05f, 3u}, {1200u, 0.2f, 6u}};
+    const size_t settle = 200u;
+
+    IPaddress client_ip;
+    client_ip.host = 0x0100007Fu;
+    client_ip.port = 1u;
+
+    for(size_t i = 0u; i != sizeof(conditions) / sizeof(Condition); ++i) {
+      const Condition &condition = conditions[i];
+
+      Random random(42u);
+      std::vector<Replication_Benchmark_Entity> world(entities);
+      std::vector<VLUID> ids;
+      Replication_Server server;
+      server.add_client(client_ip);
+
+      size_t snapshot_bytes = 2u * sizeof(Uint32) + 2u * sizeof(Uint16);
+      for(size_t j = 0u; j != entities; ++j) {
+        Replication_Benchmark_Entity &entity = world[j];
+        entity.x = random.frand_lt() * 2000.0f - 1000.0f;
+        entity.y = random.frand_lt() * 2000.0f - 1000.0f;
+        entity.heading = random.frand_lt() * 6.2832f;
+        entity.name = "entity ";
+        entity.name += ulltoa(j);
+        ids.push_back(server.add(entity));
+
+        // What a full snapshot would take: the id and every field
+        char buffer[256];
+        Byte_Writer writer(buffer, sizeof(buffer));
+        serialize(writer, ids.back());
+        for(Uint16 field = 0u; field != entity.get_num_fields(); ++field)
+          entity.serialize_field(writer, field);
+        snapshot_bytes += writer.size();
+      }
+
+      Replication_Benchmark_Factory factory;
+      Replication_Client client(factory);
+      std::multimap<size_t, Uint32> acks; ///< (tick due, sequence)
+      std::vector<char> packet(condition.budget);
+
+      size_t arrived_by = 0u;
+      size_t steady_bytes = 0u;
+      size_t steady_ticks = 0u;
+      size_t max_bytes = 0u;
+
+      for(size_t tick = 0u; tick != ticks + settle; ++tick) {
+        // A twentieth of the entities move each tick, and a hundredth are hurt
+        if(tick < ticks) {
+          for(size_t j = 0u; j != entities / 20u; ++j) {
+            Replication_Benchmark_Entity &entity = world[size_t(random.rand_lt(Sint32(entities)))];
+            entity.heading += random.frand_lt() - 0.5f;
+            entity.x += 5.0f * std::cos(entity.heading);
+            entity.y += 5.0f * std::sin(entity.heading);
+          }
+          for(size_t j = 0u; j != entities / 100u; ++j)
+            --world[size_t(random.rand_lt(Sint32(entities)))].health;
+        }
+
+        server.update();
+
+        Byte_Writer writer(&packet[0], packet.size());
+        server.write(client_ip, writer);
+
+        if(arrived_by && tick < ticks) {
+          steady_bytes += writer.size();
+          max_bytes = std::max(max_bytes, writer.size());
+          ++steady_ticks;
+        }
+
+        if(random.frand_lt() >= condition.loss) {
+          Byte_Reader reader(&packet[0], writer.size());
+          const Uint32 sequence = client.read(reader);
+          if(sequence && random.frand_lt() >= condition.loss)
+            acks.insert(std::make_pair(tick + condition.ack_delay, sequence));
+        }
+
+        while(!acks.empty() && acks.begin()->first <= tick) {
+          server.acknowledge(client_ip, acks.begin()->second);
+          acks.erase(acks.begin());
+        }
+
+        if(!arrived_by && client.size() == entities)
+          arrived_by = tick + 1u;
+      }
+
+      size_t mismatched = 0u;
+      for(size_t j = 0u; j != entities; ++j) {
+        const Replication_Benchmark_Entity * const replica = dynamic_cast<Replication_Benchmark_Entity *>(client.get(ids[j]));
+        if(!replica || !(*replica == world[j]))
+          ++mismatched;
+      }
+
+      os << std::fixed << std::setprecision(1) << entities << " entities, "
+         << condition.budget << " byte packets, "
+         << 100.0f * condition.loss << "% loss, "
+         << condition.ack_delay << " tick ack delay: all arrived by tick " << arrived_by << ", "
+         << (steady_ticks ? double(steady_bytes) / steady_ticks : 0.0) << " bytes per tick after (max " << max_bytes
+         << ") vs " << snapshot_bytes << " for a full snapshot, "
+         << mismatched << " mismatched after settling\n";
+    }
+  }
+
+  void Net_Benchmark::compression(std::ostream &os, const size_t &messages) {
+    struct Configuration {
+      Net_Compressor::Mode mode;
+      bool dictionary;
+      Uint32 threshold;
+    };
+
+    const Configuration configurations[] = {{Net_Compressor::MESSAGES, false, 32u},
+                                            {Net_Compressor::MESSAGES, true, 0u},
+                                            {Net_Compressor::MESSAGES, true, 32u},
+                                            {Net_Compressor::MESSAGES, true, 128u},
+                                            {Net_Compressor::STREAM, false, 32u},
+                                            {Net_Compressor::STREAM, true, 32u}};
+    const char * const corpus_names[] = {"text", "replication"};
+    std::vector<String> corpora[2];
+
+    Random random(42u);
+
+    {// State and chat, as a game might send it as text
+      const char * const players[] = {"bazald", "player_2", "guest", "observer"};
+      const char * const actions[] = {"move", "fire", "reload", "jump", "use"};
+      const char * const chat[] = {"gg", "nice shot", "behind you!", "need ammo", "brb"};
+
+      for(size_t i = 0u; i != 2u * messages; ++i) {
+        std::ostringstream oss;
+        oss << "{\"player\":\"" << players[random.rand_lt(4)] << "\",\"tick\":" << i
+            << ",\"x\":" << random.rand_lt(10000) << ",\"y\":" << random.rand_lt(10000)
+            << ",\"action\":\"" << actions[random.rand_lt(5)] << '"';
+        if(!random.rand_lt(8))
+          oss << ",\"chat\":\"" << chat[random.rand_lt(5)] << '"';
+        oss << '}';
+        corpora[0].push_back(oss.str().c_str());
+      }
+    }
+
+    {// Packets from a Replication_Server, starting from nothing
+      IPaddress client_ip;
+      client_ip.host = 0x0100007Fu;
+      client_ip.port = 1u;
+
+      std::vector<Replication_Benchmark_Entity> world(200u);
+      Replication_Server server;
+      server.add_client(client_ip);
+      for(size_t j = 0u; j != world.size(); ++j) {
+        world[j].x = random.frand_lt() * 2000.0f - 1000.0f;
+        world[j].y = random.frand_lt() * 2000.0f - 1000.0f;
+        world[j].name = "entity ";
+        world[j].name += ulltoa(j);
+        server.add(world[j]);
+      }
+
+      std::vector<char> packet(1200u);
+      while(corpora[1].size() != 2u * messages) {
+        for(size_t j = 0u; j != world.size() / 20u; ++j) {
+          Replication_Benchmark_Entity &entity = world[size_t(random.rand_lt(Sint32(world.size())))];
+          entity.heading += random.frand_lt() - 0.5f;
+          entity.x += 5.0f * std::cos(entity.heading);
+          entity.y += 5.0f * std::sin(entity.heading);
+        }
+
+        server.update();
+
+        Byte_Writer writer(&packet[0], packet.size());
+        server.acknowledge(client_ip, server.write(client_ip, writer));
+        corpora[1].push_back(String(&packet[0], writer.size()));
+      }
+    }
+
+    Timer_HQ &thq = get_Timer_HQ();
+
+    for(size_t i = 0u; i != sizeof(corpus_names) / sizeof(const char *); ++i) {
+      // Train on the first half, and measure on the second
+      const std::vector<String> &corpus = corpora[i];
+      const String dictionary = Net_Compressor::train_dictionary(std::vector<String>(corpus.begin(), corpus.begin() + messages));
+
+      for(size_t j = 0u; j != sizeof(configurations) / sizeof(Configuration); ++j) {
+        const Configuration &configuration = configurations[j];
+
+        Net_Compressor sender(configuration.mode, configuration.dictionary ? dictionary : String(), configuration.threshold);
+        Net_Compressor receiver(configuration.mode, configuration.dictionary ? dictionary : String(), configuration.threshold);
+
+        size_t mismatched = 0u;
+        String message;
+        const Time_HQ start = thq.get_time();
+        for(size_t k = messages; k != corpus.size(); ++k) {
+          const std::vector<char> &compressed = sender.compress(corpus[k].c_str(), Uint32(corpus[k].size()));
+          receiver.decompress(message, &compressed[0], Uint32(compressed.size()));
+          if(message != corpus[k])
+            ++mismatched;
+        }
+        const double seconds = double(thq.get_time().get_seconds_since(start));
+
+        const Net_Compressor::Statistics &sent = sender.get_statistics();
+        const Net_Compressor::Statistics &received = receiver.get_statistics();
+
+        os << std::fixed << std::setprecision(1) << corpus_names[i] << ", "
+           << (configuration.mode == Net_Compressor::MESSAGES ? "MESSAGES" : "STREAM") << ", "
+           << (configuration.dictionary ? dictionary.size() : 0u) << " byte dictionary, threshold " << configuration.threshold << ": "
+           << double(sent.raw_bytes_sent) / messages << " bytes per message as " << double(sent.wire_bytes_sent) / messages
+           << " (" << 100.0 * double(sent.wire_bytes_sent) / double(sent.raw_bytes_sent) << "%), "
+           << 1000000.0 * sent.compress_seconds / messages << " us to compress, "
+           << 1000000.0 * received.decompress_seconds / messages << " us to decompress, "
+           << messages / seconds << " round trips/s, "
+           << mismatched << " mismatched\n";
+      }
+    }
+  }
+
+  void Net_Benchmark::async_connect(std::ostream &os, const Uint16 &port) {
+    const char * const lookup_states[] = {"PENDING", "SUCCEEDED", "FAILED", "TIMED_OUT", "CANCELLED"};
+    const char * const connector_states[] = {"RESOLVING", "CONNECTING", "CONNECTED", "FAILED", "TIMED_OUT", "CANCELLED"};
+
+    Timer_HQ &thq = get_Timer_HQ();
+
+    // Forward and reverse lookups that the hosts file answers
+    {
+      const Time_HQ start = thq.get_time();
+      Host_Lookup lookup("localhost", port);
+      while(lookup.update() == Host_Lookup::PENDING)
+        SDL_Delay(1u);
+      const double seconds = double(thq.get_time().get_seconds_since(start));
+
+      const Uint8 * const octets = reinterpret_cast<const Uint8 *>(&lookup.get_address().host);
+      os << std::fixed << std::setprecision(1) << "Host_Lookup of localhost: " << lookup_states[lookup.get_state()]
+         << " in " << 1000.0 * seconds << " ms, " << int(octets[0]) << '.' << int(octets[1]) << '.' << int(octets[2]) << '.' << int(octets[3])
+         << ':' << SDLNet_Read16(&lookup.get_address().port) << '\n';
+    }
+
+    {
+      const Time_HQ start = thq.get_time();
+      Host_Lookup lookup(get_Net().resolve_host("127.0.0.1", port));
+      while(lookup.update() == Host_Lookup::PENDING)
+        SDL_Delay(1u);
+      const double seconds = double(thq.get_time().get_seconds_since(start));
+
+      os << std::fixed << std::setprecision(1) << "Host_Lookup of 127.0.0.1: " << lookup_states[lookup.get_state()]
+         << " in " << 1000.0 * seconds << " ms, " << lookup.get_host().c_str() << '\n';
+    }
+
+    // Connect by name, then exchange a message each way over the released socket
+    {
+      TCP_Listener listener(port);
+
+      const Time_HQ start = thq.get_time();
+      TCP_Connector connector("localhost", port);
+      while(connector.update() == TCP_Connector::RESOLVING || connector.get_state() == TCP_Connector::CONNECTING)
+        SDL_Delay(1u);
+      const double seconds = double(thq.get_time().get_seconds_since(start));
+
+      TCPsocket accepted = 0;
+      for(int attempt = 0; !accepted && attempt != 100; ++attempt) {
+        accepted = listener.accept();
+        if(!accepted)
+          SDL_Delay(1u);
+      }
+
+      bool round_trip = false;
+      if(connector.get_state() == TCP_Connector::CONNECTED && accepted) {
+        TCP_Message_Socket client(connector.release());
+        TCP_Message_Socket server(accepted);
+
+        const String message("async_connect");
+        String received, echoed;
+
+        client.send_message(message);
+        for(int attempt = 0; !server.receive_message(received) && attempt != 1000; ++attempt)
+          SDL_Delay(1u);
+        server.send_message(received);
+        for(int attempt = 0; !client.receive_message(echoed) && attempt != 1000; ++attempt)
+          SDL_Delay(1u);
+
+        round_trip = echoed == message;
+      }
+      else if(accepted)
+        SDLNet_TCP_Close(accepted);
+
+      os << std::fixed << std::setprecision(1) << "TCP_Connector to a TCP_Listener: " << connector_states[connector.get_state()]
+         << " in " << 1000.0 * seconds << " ms, round trip " << (round_trip ? "matched" : "FAILED") << '\n';
+    }
+
+    // Nothing listening
+    {
+      const Time_HQ start = thq.get_time();
+      TCP_Connector connector(get_Net().resolve_host("127.0.0.1", Uint16(port + 1u)));
+      while(connector.update() == TCP_Connector::CONNECTING)
+        SDL_Delay(1u);
+      const double seconds = double(thq.get_time().get_seconds_since(start));
+
+      os << std::fixed << std::setprecision(1) << "TCP_Connector to a closed port: " << connector_states[connector.get_state()]
+         << " in " << 1000.0 * seconds << " ms\n";
+    }
+
+    // Fill a TCP_Listener's backlog without accepting, until the system holds back a handshake
+    {
+      const Uint32 timeout = 250u;
+      TCP_Listener listener(Uint16(port + 2u));
+      const IPaddress ip = get_Net().resolve_host("127.0.0.1", Uint16(port + 2u));
+
+      std::vector<TCP_Connector *> connectors;
+      TCP_Connector::State state = TCP_Connector::CONNECTED;
+      double seconds = 0.0;
+
+      while(state == TCP_Connector::CONNECTED && connectors.size() != 64u) {
+        const Time_HQ start = thq.get_time();
+        connectors.push_back(0);
+        connectors.back() = new TCP_Connector(ip, timeout);
+        while((state = connectors.back()->update()) == TCP_Connector::CONNECTING)
+          SDL_Delay(1u);
+        seconds = double(thq.get_time().get_seconds_since(start));
+      }
+
+      os << std::fixed << std::setprecision(1) << "TCP_Connector past a full backlog (" << connectors.size() - 1u << " waiting): "
+         << connector_states[state] << " in " << 1000.0 * seconds << " ms of " << timeout << '\n';
+
+      for(std::vector<TCP_Connector *>::iterator it = connectors.begin(); it != connectors.end(); ++it)
+        delete *it;
+    }
+  }
+
+  void Net_Benchmark::net_thread(std::ostream &os, const Uint16 &port, const size_t &bursts) {
+    const size_t burst_sizes[] = {16u, 256u, 1024u};
+    const String message(128u, 'z');
+    String received;
+
+    Timer_HQ &thq = get_Timer_HQ();
+
+    for(size_t i = 0u; i != sizeof(burst_sizes) / sizeof(size_t); ++i) {
+      const size_t &burst = burst_sizes[i];
+      const IPaddress ip = get_Net().resolve_host("127.0.0.1", port);
+
+      // The game thread makes every socket call itself
+      double direct_send = 0.0;
+      double direct_receive = 0.0;
+      size_t direct_received = 0u;
+      {
+        UDP_Socket sender(0u);
+        UDP_Socket receiver(port);
+
+        for(size_t b = 0u; b != bursts; ++b) {
+          const Time_HQ send_start = thq.get_time();
+          for(size_t j = 0u; j != burst; ++j)
+            sender.send(ip, message);
+          direct_send += double(thq.get_time().get_seconds_since(send_start));
+
+          // The rest of a frame, during which the datagrams arrive
+          SDL_Delay(1u);
+
+          const Time_HQ receive_start = thq.get_time();
+          IPaddress from;
+          for(;;) {
+            received.resize(8192u);
+            if(receiver.receive(from, received) <= 0)
+              break;
+            ++direct_received;
+          }
+          direct_receive += double(thq.get_time().get_seconds_since(receive_start));
+        }
+      }
+
+      // The game thread only queues and pops
+      double threaded_send = 0.0;
+      double threaded_receive = 0.0;
+      size_t threaded_received = 0u;
+      Net_Thread::Statistics statistics;
+      {
+        UDP_Socket sender(0u);
+        UDP_Socket receiver(port);
+        Net_Thread nt(Uint32(2u * burst));
+        nt.add(sender);
+        nt.add(receiver);
+
+        for(size_t b = 0u; b != bursts; ++b) {
+          const Time_HQ send_start = thq.get_time();
+          for(size_t j = 0u; j != burst; ++j)
+            nt.send(sender, ip, message);
+          threaded_send += double(thq.get_time().get_seconds_since(send_start));
+
+          SDL_Delay(1u);
+
+          const Time_HQ receive_start = thq.get_time();
+          for(Net_Thread::Packet * packet = nt.receive(); packet; packet = nt.receive()) {
+            ++threaded_received;
+            nt.release(packet);
+          }
+          threaded_receive += double(thq.get_time().get_seconds_since(receive_start));
+        }
+
+        nt.remove(receiver);
+        nt.remove(sender);
+        statistics = nt.get_statistics();
+      }
+
+      const size_t sent = bursts * burst;
+      os << std::fixed << std::setprecision(1) << "Bursts of " << burst << " datagrams, game thread microseconds per burst: "
+         << "direct " << 1000000.0 * direct_send / double(bursts) << " sending + " << 1000000.0 * direct_receive / double(bursts) << " receiving ("
+         << direct_received << '/' << sent << " arrived), "
+         << "Net_Thread " << 1000000.0 * threaded_send / double(bursts) << " + " << 1000000.0 * threaded_receive / double(bursts) << " ("
+         << threaded_received << '/' << sent << ")\n"
+         << statistics.to_string().c_str() << '\n';
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,351 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_net.h>
+
+#include <SDL/SDL.h>
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <zlib.h>
+
+#if defined(_DEBUG) && defined(_WINDOWS)
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+
+namespace Zeni {
+
+  enum Compression_Prefix {COMPRESSION_RAW = 0, COMPRESSION_DEFLATED = 1};
+
+  static const int g_compression_window_bits = -15; ///< Raw deflate, with the largest window
+  static const size_t g_compression_max_dictionary = 32768u; ///< Deflate can see no further back
+  static const char g_compression_flush_tail[] = {0, 0, char(0xFF), char(0xFF)}; ///< Ends every Z_SYNC_FLUSH, so need not be sent
+
+  /// Compressors may run on a Net_Thread, and Timer_HQ is not safe to share between threads
+  static double compression_seconds_since(const Uint64 &start) {
+    return double(SDL_GetPerformanceCounter() - start) / double(SDL_GetPerformanceFrequency());
+  }
+
+  Net_Compressor::Statistics::Statistics()
+    : messages_sent(0u),
+    messages_deflated(0u),
+    raw_bytes_sent(0u),
+    wire_bytes_sent(0u),
+    compress_seconds(0.0),
+    messages_received(0u),
+    wire_bytes_received(0u),
+    raw_bytes_received(0u),
+    decompress_seconds(0.0)
+  {
+  }
+
+  String Net_Compressor::Statistics::to_string() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << "Sent " << messages_sent << " messages (" << messages_deflated << " deflated): "
+        << raw_bytes_sent << " bytes as " << wire_bytes_sent << " ("
+        << (raw_bytes_sent ? 100.0 * double(wire_bytes_sent) / double(raw_bytes_sent) : 100.0) << "%) in "
+        << 1000.0 * compress_seconds << " ms\n"
+        << "Received " << messages_received << " messages: "
+        << wire_bytes_received << " bytes as " << raw_bytes_received << " in "
+        << 1000.0 * decompress_seconds << " ms";
+    return oss.str().c_str();
+  }
+
+  Net_Compressor::Net_Compressor(const Mode &mode, const String &dictionary, const Uint32 &threshold, const int &level)
+    : m_mode(mode),
+    m_dictionary(dictionary.size() > g_compression_max_dictionary ? dictionary.substr(dictionary.size() - g_compression_max_dictionary) : dictionary),
+    m_threshold(threshold),
+    m_deflate(new z_stream),
+    m_inflate(new z_stream)
+  {
+    memset(m_deflate, 0, sizeof(z_stream));
+    memset(m_inflate, 0, sizeof(z_stream));
+
+    if(deflateInit2(m_deflate, level, Z_DEFLATED, g_compression_window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+      delete m_deflate;
+      delete m_inflate;
+      throw Compression_Init_Failure();
+    }
+
+    if(inflateInit2(m_inflate, g_compression_window_bits) != Z_OK) {
+      deflateEnd(m_deflate);
+      delete m_deflate;
+      delete m_inflate;
+      throw Compression_Init_Failure();
+    }
+
+    start_deflate();
+    start_inflate();
+  }
+
+  Net_Compressor::~Net_Compressor() {
+    deflateEnd(m_deflate);
+    inflateEnd(m_inflate);
+    delete m_deflate;
+    delete m_inflate;
+  }
+
+  const std::vector<char> & Net_Compressor::compress(const void * const &data, const Uint32 &num_bytes) {
+    const Uint64 start = SDL_GetPerformanceCounter();
+
+    ++m_statistics.messages_sent;
+    m_statistics.raw_bytes_sent += num_bytes;
+
+    size_t compressed = 0u;
+    if(num_bytes >= m_threshold) {
+      if(m_mode == MESSAGES)
+        start_deflate();
+
+      z_stream &z = *m_deflate;
+      const int flush = m_mode == MESSAGES ? Z_FINISH : Z_SYNC_FLUSH;
+
+      // Enough for Z_FINISH, plus the Z_SYNC_FLUSH marker
+      m_buffer.resize(1u + deflateBound(&z, num_bytes) + 16u);
+      z.next_in = reinterpret_cast<Bytef *>(const_cast<void *>(data));
+      z.avail_in = num_bytes;
+      z.next_out = reinterpret_cast<Bytef *>(&m_buffer[1]);
+      z.avail_out = uInt(m_buffer.size() - 1u);
+
+      for(;;) {
+        const int result = deflate(&z, flush);
+        if(result == Z_STREAM_ERROR)
+          throw Compression_Corrupt();
+        if(flush == Z_FINISH ? result == Z_STREAM_END : !z.avail_in && z.avail_out)
+          break;
+
+        const size_t used = m_buffer.size() - z.avail_out;
+        m_buffer.resize(2u * m_buffer.size());
+        z.next_out = reinterpret_cast<Bytef *>(&m_buffer[used]);
+        z.avail_out = uInt(m_buffer.size() - used);
+      }
+
+      compressed = m_buffer.size() - z.avail_out;
+      if(flush == Z_SYNC_FLUSH) {
+        assert(compressed >= 1u + sizeof(g_compression_flush_tail) &&
+               !memcmp(&m_buffer[compressed - sizeof(g_compression_flush_tail)], g_compression_flush_tail, sizeof(g_compression_flush_tail)));
+        compressed -= sizeof(g_compression_flush_tail);
+      }
+
+      // Not worth it, and nothing depends on the deflated message in MESSAGES mode
+      if(m_mode == MESSAGES && compressed > num_bytes)
+        compressed = 0u;
+    }
+
+    if(compressed) {
+      m_buffer[0] = char(COMPRESSION_DEFLATED);
+      m_buffer.resize(compressed);
+      ++m_statistics.messages_deflated;
+    }
+    else {
+      m_buffer.resize(1u + num_bytes);
+      m_buffer[0] = char(COMPRESSION_RAW);
+      if(num_bytes)
+        memcpy(&m_buffer[1], data, num_bytes);
+    }
+
+    m_statistics.wire_bytes_sent += m_buffer.size();
+    m_statistics.compress_seconds += compression_seconds_since(start);
+
+    return m_buffer;
+  }
+
+  void Net_Compressor::decompress(String &message, const void * const &data, const Uint32 &num_bytes, const Uint32 &max_message_size) {
+    const Uint64 start = SDL_GetPerformanceCounter();
+
+    const char * const bytes = reinterpret_cast<const char *>(data);
+    if(!num_bytes || (bytes[0] != COMPRESSION_RAW && bytes[0] != COMPRESSION_DEFLATED))
+      throw Compression_Corrupt();
+
+    ++m_statistics.messages_received;
+    m_statistics.wire_bytes_received += num_bytes;
+
+    if(bytes[0] == COMPRESSION_RAW) {
+      if(num_bytes - 1u > max_message_size)
+        throw Message_Too_Large();
+
+      message.resize(num_bytes - 1u);
+      if(num_bytes > 1u)
+        memcpy(&message[0], bytes + 1, num_bytes - 1u);
+    }
+    else {
+      z_stream &z = *m_inflate;
+
+      if(m_mode == MESSAGES) {
+        start_inflate();
+        z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(bytes + 1));
+        z.avail_in = num_bytes - 1u;
+      }
+      else {
+        m_input.resize(num_bytes - 1u + sizeof(g_compression_flush_tail));
+        memcpy(&m_input[0], bytes + 1, num_bytes - 1u);
+        memcpy(&m_input[num_bytes - 1u], g_compression_flush_tail, sizeof(g_compression_flush_tail));
+        z.next_in = reinterpret_cast<Bytef *>(&m_input[0]);
+        z.avail_in = uInt(m_input.size());
+      }
+
+      // Guess that deflate saved about three quarters, growing as needed
+      size_t capacity = std::min(size_t(max_message_size), 4u * size_t(num_bytes) + 64u);
+      if(message.size() < capacity)
+        message.resize(capacity);
+      z.next_out = reinterpret_cast<Bytef *>(&message[0]);
+      z.avail_out = uInt(capacity);
+
+      for(;;) {
+        const int result = inflate(&z, m_mode == MESSAGES ? Z_FINISH : Z_SYNC_FLUSH);
+        if(result == Z_STREAM_END) {
+          if(m_mode == STREAM || z.avail_in)
+            throw Compression_Corrupt();
+          break;
+        }
+        if(result != Z_OK && result != Z_BUF_ERROR)
+          throw Compression_Corrupt();
+        if(!z.avail_in && z.avail_out) {
+          // All input consumed, so a STREAM message is complete, but a MESSAGES message never ended
+          if(m_mode == MESSAGES)
+            throw Compression_Corrupt();
+          break;
+        }
+        if(result == Z_BUF_ERROR && z.avail_out)
+          throw Compression_Corrupt();
+
+        const size_t used = capacity - z.avail_out;
+        if(capacity == max_message_size)
+          throw Message_Too_Large();
+        capacity = std::min(size_t(max_message_size), 2u * capacity);
+        message.resize(capacity);
+        z.next_out = reinterpret_cast<Bytef *>(&message[0]) + used;
+        z.avail_out = uInt(capacity - used);
+      }
+
+      message.resize(capacity - z.avail_out);
+    }
+
+    m_statistics.raw_bytes_received += message.size();
+    m_statistics.decompress_seconds += compression_seconds_since(start);
+  }
+
+  void Net_Compressor::start_deflate() {
+    deflateReset(m_deflate);
+    if(!m_dictionary.empty())
+      deflateSetDictionary(m_deflate, reinterpret_cast<const Bytef *>(m_dictionary.c_str()), uInt(m_dictionary.size()));
+  }
+
+  void Net_Compressor::start_inflate() {
+    inflateReset(m_inflate);
+    if(!m_dictionary.empty())
+      inflateSetDictionary(m_inflate, reinterpret_cast<const Bytef *>(m_dictionary.c_str()), uInt(m_dictionary.size()));
+  }
+
+  String Net_Compressor::train_dictionary(const std::vector<String> &samples, const Uint32 &size) {
+    static const size_t gram = 8u; ///< Length of the strings counted
+    static const size_t segment = 64u; ///< Length of the strings chosen
+    static const size_t table_size = 1u << 18;
+
+    const size_t dictionary_size = std::min(size_t(size), g_compression_max_dictionary);
+    if(samples.empty() || !dictionary_size)
+      return String();
+
+    // Count how many samples each gram appears in (or at least its hash)
+    std::vector<Uint32> frequency(table_size, 0u);
+    std::vector<Uint32> seen_in(table_size, 0u);
+    std::vector<std::vector<Uint32> > hashes(samples.size());
+
+    for(size_t i = 0u; i != samples.size(); ++i) {
+      const String &sample = samples[i];
+      if(sample.size() < gram)
+        continue;
+
+      hashes[i].resize(sample.size() - gram + 1u);
+      for(size_t j = 0u; j != hashes[i].size(); ++j) {
+        Uint32 hash = 2166136261u;
+        for(size_t k = 0u; k != gram; ++k)
+          hash = (hash ^ Uint8(sample[j + k])) * 16777619u;
+        hash &= Uint32(table_size - 1u);
+
+        hashes[i][j] = hash;
+        if(seen_in[hash] != i + 1u) {
+          seen_in[hash] = Uint32(i + 1u);
+          ++frequency[hash];
+        }
+      }
+    }
+
+    /*** Choose the segment covering the most common grams, forget those grams, and repeat.
+     *   Each pass looks only at one range of samples so that the chosen segments come from
+     *   across all of them.
+     */
+
+    std::vector<String> chosen;
+    size_t chosen_size = 0u;
+    const size_t passes = std::min(samples.size(), std::max(size_t(1u), dictionary_size / segment));
+
+    for(bool progress = true; progress && chosen_size < dictionary_size;) {
+      progress = false;
+
+      for(size_t pass = 0u; pass != passes && chosen_size < dictionary_size; ++pass) {
+        const size_t first = pass * samples.size() / passes;
+        const size_t last = (pass + 1u) * samples.size() / passes;
+
+        Uint32 best_score = 0u;
+        size_t best_sample = 0u;
+        size_t best_begin = 0u;
+        size_t best_end = 0u;
+
+        for(size_t i = first; i != last; ++i) {
+          const std::vector<Uint32> &h = hashes[i];
+          const size_t window = std::min(h.size(), segment - gram + 1u);
+
+          // Grams found in only one sample are worth nothing
+          Uint32 score = 0u;
+          for(size_t j = 0u; j != h.size(); ++j) {
+            score += frequency[h[j]] > 1u ? frequency[h[j]] : 0u;
+            if(j >= window)
+              score -= frequency[h[j - window]] > 1u ? frequency[h[j - window]] : 0u;
+
+            if(j + 1u >= window && score > best_score) {
+              best_score = score;
+              best_sample = i;
+              best_begin = j + 1u - window;
+              best_end = j + 1u;
+            }
+          }
+        }
+
+        if(!best_score)
+          continue;
+
+        for(size_t j = best_begin; j != best_end; ++j)
+          frequency[hashes[best_sample][j]] = 0u;
+
+        const size_t length = std::min(best_end - best_begin + gram - 1u, dictionary_size - chosen_size);
+        chosen.push_back(samples[best_sample].substr(best_begin, length));
+        chosen_size += length;
+        progress = true;
+      }
+    }
+
+    // Deflate reaches the end of the dictionary most cheaply, so the first chosen go last
+    String dictionary;
+    for(std::vector<String>::const_reverse_iterator it = chosen.rbegin(); it != chosen.rend(); ++it)
+      dictionary += *it;
+    return dictionary;
+  }
+
+}
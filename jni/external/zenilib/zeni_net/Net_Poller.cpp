@@ -0,0 +1,233 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_net.h>
+
+#if defined(_WINDOWS)
+#include <winsock2.h>
+#elif defined(__linux__)
+#include <sys/epoll.h>
+#include <unistd.h>
+#else
+#include <poll.h>
+#endif
+
+#if defined(_DEBUG) && defined(_WINDOWS)
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+
+namespace Zeni {
+
+  struct Net_Poller::Backend {
+#ifdef __linux__
+    Backend() : epoll(-1) {}
+
+    int epoll;
+    std::vector<epoll_event> events;
+#else
+    Backend() : dirty(true) {}
+
+    bool dirty;
+    std::vector<pollfd> pollfds;
+    std::vector<Entry *> polled; ///< In the order of pollfds
+#endif
+  };
+
+  Net_Poller::Net_Poller(const Trigger &trigger)
+    : m_trigger(trigger),
+    m_backend(new Backend)
+  {
+    // Ensure Net is initialized
+    get_Net();
+
+#ifdef __linux__
+    m_backend->epoll = epoll_create(1);
+    if(m_backend->epoll == -1) {
+      delete m_backend;
+      throw Net_Poller_Init_Failure();
+    }
+#endif
+  }
+
+  Net_Poller::~Net_Poller() {
+#ifdef __linux__
+    close(m_backend->epoll);
+#endif
+
+    for(std::map<void *, Entry *>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+      delete it->second;
+
+    delete m_backend;
+  }
+
+  void Net_Poller::add(TCP_Socket &socket) {
+    add(TYPE_TCP_SOCKET, &socket, socket.sock);
+  }
+
+  void Net_Poller::add(TCP_Listener &listener) {
+    add(TYPE_TCP_LISTENER, &listener, listener.sock);
+  }
+
+  void Net_Poller::add(UDP_Socket &socket) {
+    add(TYPE_UDP_SOCKET, &socket, socket.sock);
+  }
+
+  void Net_Poller::remove(TCP_Socket &socket) {
+    remove(&socket);
+  }
+
+  void Net_Poller::remove(TCP_Listener &listener) {
+    remove(&listener);
+  }
+
+  void Net_Poller::remove(UDP_Socket &socket) {
+    remove(&socket);
+  }
+
+  bool Net_Poller::is_epoll() {
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  size_t Net_Poller::wait(const int &timeout) {
+    m_ready_tcp_sockets.clear();
+    m_ready_tcp_listeners.clear();
+    m_ready_udp_sockets.clear();
+
+#ifdef __linux__
+    m_backend->events.resize(m_entries.empty() ? 1u : m_entries.size());
+
+    const int num_ready = epoll_wait(m_backend->epoll, &m_backend->events[0], int(m_backend->events.size()), timeout);
+
+    for(int i = 0; i < num_ready; ++i)
+      ready(*reinterpret_cast<Entry *>(m_backend->events[i].data.ptr));
+#else
+    if(m_backend->dirty) {
+      m_backend->pollfds.clear();
+      m_backend->polled.clear();
+
+      for(std::map<void *, Entry *>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+        pollfd pfd;
+        pfd.fd = it->second->channel;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        m_backend->pollfds.push_back(pfd);
+        m_backend->polled.push_back(it->second);
+      }
+
+      m_backend->dirty = false;
+    }
+
+    if(m_backend->pollfds.empty()) {
+      if(timeout > 0)
+        SDL_Delay(Uint32(timeout));
+      return 0u;
+    }
+
+#ifdef _WINDOWS
+    const int num_ready = WSAPoll(&m_backend->pollfds[0], ULONG(m_backend->pollfds.size()), timeout);
+#else
+    const int num_ready = poll(&m_backend->pollfds[0], nfds_t(m_backend->pollfds.size()), timeout);
+#endif
+
+    for(size_t i = 0u; num_ready > 0 && i != m_backend->pollfds.size(); ++i) {
+      Entry &entry = *m_backend->polled[i];
+      const bool is_ready = m_backend->pollfds[i].revents != 0;
+
+      // Emulate edge triggering by reporting only newly ready sockets
+      if(is_ready && (m_trigger == LEVEL || !entry.was_ready))
+        ready(entry);
+
+      entry.was_ready = is_ready;
+    }
+#endif
+
+    return m_ready_tcp_sockets.size() + m_ready_tcp_listeners.size() + m_ready_udp_sockets.size();
+  }
+
+  void Net_Poller::add(const Type &type, void * const &object, void * const &sdlnet_socket) {
+    if(!sdlnet_socket || m_entries.find(object) != m_entries.end())
+      return;
+
+    Entry * const entry = new Entry;
+    entry->type = type;
+    entry->object = object;
+    entry->channel = Net::get_Socket_Header(sdlnet_socket).channel;
+    entry->was_ready = false;
+
+#ifdef __linux__
+    epoll_event event;
+    event.events = EPOLLIN | (m_trigger == EDGE ? EPOLLET : 0u);
+    event.data.ptr = entry;
+
+    if(epoll_ctl(m_backend->epoll, EPOLL_CTL_ADD, entry->channel, &event)) {
+      delete entry;
+      throw Net_Poller_Init_Failure();
+    }
+#else
+    m_backend->dirty = true;
+#endif
+
+    m_entries[object] = entry;
+  }
+
+  void Net_Poller::remove(void * const &object) {
+    const std::map<void *, Entry *>::iterator it = m_entries.find(object);
+    if(it == m_entries.end())
+      return;
+
+#ifdef __linux__
+    // Fails harmlessly if Net has already closed the socket, which removed it from the epoll set
+    epoll_event event;
+    epoll_ctl(m_backend->epoll, EPOLL_CTL_DEL, it->second->channel, &event);
+#else
+    m_backend->dirty = true;
+#endif
+
+    delete it->second;
+    m_entries.erase(it);
+  }
+
+  void Net_Poller::ready(Entry &entry) {
+    switch(entry.type) {
+      case TYPE_TCP_SOCKET:
+        {
+          TCP_Socket * const socket = reinterpret_cast<TCP_Socket *>(entry.object);
+          socket->m_ready = true;
+          m_ready_tcp_sockets.push_back(socket);
+        }
+        break;
+
+      case TYPE_TCP_LISTENER:
+        m_ready_tcp_listeners.push_back(reinterpret_cast<TCP_Listener *>(entry.object));
+        break;
+
+      case TYPE_UDP_SOCKET:
+        m_ready_udp_sockets.push_back(reinterpret_cast<UDP_Socket *>(entry.object));
+        break;
+
+      default:
+        break;
+    }
+  }
+
+}
@@ -0,0 +1,720 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_net.h>
+
+#include <SDL/SDL.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#if defined(_DEBUG) && defined(_WINDOWS)
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+
+namespace Zeni {
+
+  static const int g_net_thread_wait = 100; ///< Milliseconds; send() and remove() wake the net thread sooner
+  static const size_t g_net_thread_batch = 64u; ///< Packets sent per round, so that receives are drained in between
+  static const char g_net_thread_wake = 0;
+
+  /// Timer_HQ is not safe to share between threads, but SDL's performance counter is
+  static double net_thread_seconds_since(const Uint64 &start) {
+    return double(SDL_GetPerformanceCounter() - start) / double(SDL_GetPerformanceFrequency());
+  }
+
+  static void net_thread_accumulate(Net_Thread::Statistics &total, const Net_Thread::Statistics &part) {
+    total.packets_received += part.packets_received;
+    total.bytes_received += part.bytes_received;
+    total.packets_dropped += part.packets_dropped;
+    total.packets_taken += part.packets_taken;
+    total.max_incoming_depth = std::max(total.max_incoming_depth, part.max_incoming_depth);
+    total.receive_latency_seconds += part.receive_latency_seconds;
+    total.max_receive_latency_seconds = std::max(total.max_receive_latency_seconds, part.max_receive_latency_seconds);
+
+    total.packets_queued += part.packets_queued;
+    total.sends_refused += part.sends_refused;
+    total.packets_sent += part.packets_sent;
+    total.bytes_sent += part.bytes_sent;
+    total.send_failures += part.send_failures;
+    total.max_outgoing_depth = std::max(total.max_outgoing_depth, part.max_outgoing_depth);
+    total.send_latency_seconds += part.send_latency_seconds;
+    total.max_send_latency_seconds = std::max(total.max_send_latency_seconds, part.max_send_latency_seconds);
+
+    total.waits += part.waits;
+    total.wakes += part.wakes;
+  }
+
+  struct Net_Thread::Ring {
+    Ring(const Uint32 &size)
+      : slots(size, static_cast<Packet *>(0)),
+      mask(size - 1u)
+    {
+      SDL_AtomicSet(&head, 0);
+      SDL_AtomicSet(&tail, 0);
+    }
+
+    /// Producer only; Returns false if full
+    bool push(Packet * const &packet) {
+      const Uint32 t = Uint32(SDL_AtomicGet(&tail));
+      if(t - Uint32(SDL_AtomicGet(&head)) == Uint32(slots.size()))
+        return false;
+
+      slots[t & mask] = packet;
+      SDL_AtomicSet(&tail, int(t + 1u)); // Publishes the slot
+      return true;
+    }
+
+    /// Consumer only; Returns 0 if empty
+    Packet * pop() {
+      const Uint32 h = Uint32(SDL_AtomicGet(&head));
+      if(h == Uint32(SDL_AtomicGet(&tail)))
+        return 0;
+
+      Packet * const packet = slots[h & mask];
+      SDL_AtomicSet(&head, int(h + 1u)); // Hands the slot back to the producer
+      return packet;
+    }
+
+    bool full() const {
+      return size() == slots.size();
+    }
+
+    size_t capacity() const {
+      return slots.size();
+    }
+
+    size_t size() const {
+      return size_t(Uint32(SDL_AtomicGet(&tail)) - Uint32(SDL_AtomicGet(&head)));
+    }
+
+    std::vector<Packet *> slots;
+    const Uint32 mask;
+
+    // Each written by one side only, and kept apart to spare them false sharing
+    mutable SDL_atomic_t head;
+    char padding[64];
+    mutable SDL_atomic_t tail;
+  };
+
+  Net_Thread::Packet::Packet()
+    : m_udp_socket(0),
+    m_tcp_socket(0),
+    m_closed(false),
+    m_queued(0u)
+  {
+    m_address.host = 0;
+    m_address.port = 0;
+  }
+
+  Net_Thread::Statistics::Statistics()
+    : packets_received(0u),
+    bytes_received(0u),
+    packets_dropped(0u),
+    packets_taken(0u),
+    max_incoming_depth(0u),
+    receive_latency_seconds(0.0),
+    max_receive_latency_seconds(0.0),
+    packets_queued(0u),
+    sends_refused(0u),
+    packets_sent(0u),
+    bytes_sent(0u),
+    send_failures(0u),
+    max_outgoing_depth(0u),
+    send_latency_seconds(0.0),
+    max_send_latency_seconds(0.0),
+    waits(0u),
+    wakes(0u)
+  {
+  }
+
+  String Net_Thread::Statistics::to_string() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3)
+        << "Received " << packets_received << " packets (" << bytes_received << " bytes), dropped "
+        << packets_dropped << ", taken " << packets_taken << "; Up to " << max_incoming_depth << " waited "
+        << (packets_taken ? 1000.0 * receive_latency_seconds / double(packets_taken) : 0.0) << " ms on average, "
+        << 1000.0 * max_receive_latency_seconds << " ms at most\n"
+        << "Queued " << packets_queued << " packets, refused " << sends_refused << ", sent "
+        << packets_sent << " (" << bytes_sent << " bytes), failed " << send_failures << "; Up to "
+        << max_outgoing_depth << " waited "
+        << (packets_sent + send_failures ? 1000.0 * send_latency_seconds / double(packets_sent + send_failures) : 0.0) << " ms on average, "
+        << 1000.0 * max_send_latency_seconds << " ms at most\n"
+        << "Slept " << waits << " times, woken " << wakes << " times";
+    return oss.str().c_str();
+  }
+
+  Net_Thread::Net_Thread(const Uint32 &queue_size)
+    : m_thread(0),
+    m_mutex(0),
+    m_removed(0),
+    m_wake(0),
+    m_waker(0),
+    m_incoming(0),
+    m_outgoing(0),
+    m_free_incoming(0),
+    m_free_outgoing(0),
+    m_spare(0),
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4355 )
+#endif
+    m_uninit(*this)
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  {
+    Net &nr = get_Net();
+
+    SDL_AtomicSet(&m_sleeping, 0);
+    SDL_AtomicSet(&m_quit, 0);
+    SDL_AtomicSet(&m_num_changes, 0);
+
+    Uint32 size = 1u;
+    while(size < queue_size && size < 0x40000000u)
+      size <<= 1;
+
+    m_incoming = new Ring(size);
+    m_outgoing = new Ring(size);
+    m_free_incoming = new Ring(size);
+    m_free_outgoing = new Ring(size);
+
+    m_mutex = SDL_CreateMutex();
+    m_removed = SDL_CreateSemaphore(0u);
+    if(!m_mutex || !m_removed) {
+      clear();
+      throw Net_Thread_Init_Failure();
+    }
+
+    try {
+      m_wake = new UDP_Socket(0u);
+      m_waker = new UDP_Socket(0u);
+    }
+    catch(UDP_Socket_Init_Failure &) {
+      clear();
+      throw Net_Thread_Init_Failure();
+    }
+
+    m_wake_address = m_wake->peer_address();
+    SDLNet_Write32(0x7F000001u, &m_wake_address.host);
+
+    nr.lend_pre_uninit(&m_uninit);
+    follow(m_wake->m_uninit);
+    follow(m_waker->m_uninit);
+
+    m_poller.add(*m_wake);
+
+    m_thread = SDL_CreateThread(&run, "Zeni::Net_Thread", this);
+    if(!m_thread) {
+      Net::remove_pre_uninit(&m_uninit);
+      clear();
+      throw Net_Thread_Init_Failure();
+    }
+  }
+
+  Net_Thread::~Net_Thread() {
+    Net::remove_pre_uninit(&m_uninit);
+
+    stop();
+    clear();
+  }
+
+  void Net_Thread::add(UDP_Socket &socket, const Uint32 &max_packet_size) {
+    follow(socket.m_uninit);
+
+    const Change added = {true, &socket, 0, max_packet_size};
+    change(added);
+  }
+
+  void Net_Thread::add(TCP_Message_Socket &socket) {
+    follow(socket.m_uninit);
+
+    const Change added = {true, 0, &socket, 0u};
+    change(added);
+  }
+
+  void Net_Thread::remove(UDP_Socket &socket) {
+    const Change removed = {false, &socket, 0, 0u};
+    change(removed);
+  }
+
+  void Net_Thread::remove(TCP_Message_Socket &socket) {
+    const Change removed = {false, 0, &socket, 0u};
+    change(removed);
+  }
+
+  bool Net_Thread::send(UDP_Socket &socket, const IPaddress &ip, const void * const &data, const Uint32 &num_bytes) {
+    Packet * const packet = prepare_send();
+    if(!packet)
+      return false;
+
+    packet->m_udp_socket = &socket;
+    packet->m_tcp_socket = 0;
+    packet->m_address = ip;
+    packet->m_data.assign(reinterpret_cast<const char *>(data), num_bytes);
+
+    queue(packet);
+    return true;
+  }
+
+  bool Net_Thread::send(UDP_Socket &socket, const IPaddress &ip, const String &data) {
+    return send(socket, ip, data.c_str(), Uint32(data.size()));
+  }
+
+  bool Net_Thread::send(TCP_Message_Socket &socket, const void * const &data, const Uint32 &num_bytes) {
+    Packet * const packet = prepare_send();
+    if(!packet)
+      return false;
+
+    packet->m_udp_socket = 0;
+    packet->m_tcp_socket = &socket;
+    packet->m_data.assign(reinterpret_cast<const char *>(data), num_bytes);
+
+    queue(packet);
+    return true;
+  }
+
+  bool Net_Thread::send(TCP_Message_Socket &socket, const String &data) {
+    return send(socket, data.c_str(), Uint32(data.size()));
+  }
+
+  Net_Thread::Packet * Net_Thread::receive() {
+    Packet * const packet = m_incoming->pop();
+
+    if(packet) {
+      const double latency = net_thread_seconds_since(packet->m_queued);
+
+      ++m_statistics.packets_taken;
+      m_statistics.receive_latency_seconds += latency;
+      m_statistics.max_receive_latency_seconds = std::max(m_statistics.max_receive_latency_seconds, latency);
+    }
+
+    return packet;
+  }
+
+  void Net_Thread::release(Packet * const &packet) {
+    if(packet && !m_free_incoming->push(packet))
+      delete packet;
+  }
+
+  size_t Net_Thread::get_incoming_depth() const {
+    return m_incoming->size();
+  }
+
+  size_t Net_Thread::get_outgoing_depth() const {
+    return m_outgoing->size();
+  }
+
+  Net_Thread::Statistics Net_Thread::get_statistics() const {
+    SDL_LockMutex(m_mutex);
+    Statistics statistics = m_shared_statistics;
+    SDL_UnlockMutex(m_mutex);
+
+    net_thread_accumulate(statistics, m_statistics);
+
+    return statistics;
+  }
+
+  void Net_Thread::reset_statistics() {
+    SDL_LockMutex(m_mutex);
+    m_shared_statistics = Statistics();
+    SDL_UnlockMutex(m_mutex);
+
+    m_statistics = Statistics();
+  }
+
+  int Net_Thread::run(void * net_thread_) {
+    Net_Thread &net_thread = *reinterpret_cast<Net_Thread *>(net_thread_);
+
+    while(!SDL_AtomicGet(&net_thread.m_quit)) {
+      const size_t removed = net_thread.apply_changes();
+      net_thread.flush();
+
+      // Sends queued before a remove() go out before it returns, however many batches they take
+      if(removed) {
+        while(net_thread.m_outgoing->size())
+          net_thread.flush();
+
+        for(size_t i = 0u; i != removed; ++i)
+          SDL_SemPost(net_thread.m_removed);
+      }
+
+      SDL_LockMutex(net_thread.m_mutex);
+      net_thread_accumulate(net_thread.m_shared_statistics, net_thread.m_net_statistics);
+      SDL_UnlockMutex(net_thread.m_mutex);
+      net_thread.m_net_statistics = Statistics();
+
+      // Announce sleep before the last look, so that a send() in between either is seen or wakes it
+      SDL_AtomicSet(&net_thread.m_sleeping, 1);
+      const bool busy = net_thread.m_outgoing->size() || SDL_AtomicGet(&net_thread.m_num_changes) || SDL_AtomicGet(&net_thread.m_quit);
+      if(busy)
+        SDL_AtomicSet(&net_thread.m_sleeping, 0);
+      else
+        ++net_thread.m_net_statistics.waits;
+
+      net_thread.m_poller.wait(busy ? 0 : g_net_thread_wait);
+      SDL_AtomicSet(&net_thread.m_sleeping, 0);
+
+      // TCP data held back for want of room keeps its socket ready, so the wait above would not rest
+      if(net_thread.m_incoming->full())
+        SDL_Delay(1u);
+
+      net_thread.drain();
+    }
+
+    return 0;
+  }
+
+  void Net_Thread::follow(Event::Handler &uninit) {
+    Net::remove_pre_uninit(&uninit);
+    get_Net().lend_pre_uninit(&uninit);
+  }
+
+  Net_Thread::Packet * Net_Thread::allocate(Ring &pool) {
+    Packet * const packet = pool.pop();
+    return packet ? packet : new Packet;
+  }
+
+  Net_Thread::Packet * Net_Thread::prepare_send() {
+    // Only this thread pushes, so the ring cannot fill up before queue()
+    if(m_outgoing->full()) {
+      ++m_statistics.sends_refused;
+      return 0;
+    }
+
+    Packet * const packet = allocate(*m_free_outgoing);
+    packet->m_closed = false;
+    return packet;
+  }
+
+  void Net_Thread::queue(Packet * const &packet) {
+    packet->m_queued = SDL_GetPerformanceCounter();
+    m_outgoing->push(packet);
+
+    ++m_statistics.packets_queued;
+    m_statistics.max_outgoing_depth = std::max(m_statistics.max_outgoing_depth, m_outgoing->size());
+
+    wake();
+  }
+
+  void Net_Thread::change(const Change &change_) {
+    // Stopped along with Net, having let go of every socket
+    if(!m_thread)
+      return;
+
+    SDL_LockMutex(m_mutex);
+    m_changes.push_back(change_);
+    SDL_AtomicAdd(&m_num_changes, 1);
+    SDL_UnlockMutex(m_mutex);
+
+    wake();
+
+    if(!change_.add)
+      SDL_SemWait(m_removed);
+  }
+
+  void Net_Thread::wake() {
+    // Only a sleeping net thread needs waking, and only once
+    if(!SDL_AtomicCAS(&m_sleeping, 1, 0))
+      return;
+
+    try {
+      m_waker->send(m_wake_address, &g_net_thread_wake, 1u);
+      ++m_statistics.wakes;
+    }
+    catch(Socket_Closed &) {
+      // The net thread will find everything when it next times out
+    }
+  }
+
+  void Net_Thread::stop() {
+    if(!m_thread)
+      return;
+
+    SDL_AtomicSet(&m_quit, 1);
+    wake();
+
+    SDL_WaitThread(m_thread, 0);
+    m_thread = 0;
+
+    // Let go of every socket while they are still open, since Net may be about to close them
+    for(std::map<UDP_Socket *, Uint32>::iterator it = m_udp_sockets.begin(); it != m_udp_sockets.end(); ++it)
+      m_poller.remove(*it->first);
+    for(std::vector<TCP_Message_Socket *>::iterator it = m_tcp_sockets.begin(); it != m_tcp_sockets.end(); ++it)
+      m_poller.remove(**it);
+    m_poller.remove(*m_wake);
+
+    m_udp_sockets.clear();
+    m_tcp_sockets.clear();
+  }
+
+  void Net_Thread::clear() {
+    Ring * const rings[] = {m_incoming, m_outgoing, m_free_incoming, m_free_outgoing};
+    for(size_t i = 0u; i != sizeof(rings) / sizeof(Ring *); ++i) {
+      if(!rings[i])
+        continue;
+      for(Packet * packet = rings[i]->pop(); packet; packet = rings[i]->pop())
+        delete packet;
+      delete rings[i];
+    }
+    m_incoming = 0;
+    m_outgoing = 0;
+    m_free_incoming = 0;
+    m_free_outgoing = 0;
+
+    for(std::vector<Packet *>::iterator it = m_closed_reports.begin(); it != m_closed_reports.end(); ++it)
+      delete *it;
+    m_closed_reports.clear();
+    delete m_spare;
+    m_spare = 0;
+
+    if(m_wake)
+      m_poller.remove(*m_wake);
+    delete m_waker;
+    delete m_wake;
+    m_waker = 0;
+    m_wake = 0;
+
+    if(m_removed)
+      SDL_DestroySemaphore(m_removed);
+    if(m_mutex)
+      SDL_DestroyMutex(m_mutex);
+    m_removed = 0;
+    m_mutex = 0;
+  }
+
+  size_t Net_Thread::apply_changes() {
+    if(!SDL_AtomicGet(&m_num_changes))
+      return 0u;
+
+    SDL_LockMutex(m_mutex);
+    std::vector<Change> changes;
+    changes.swap(m_changes);
+    SDL_AtomicSet(&m_num_changes, 0);
+    SDL_UnlockMutex(m_mutex);
+
+    size_t removed = 0u;
+
+    for(std::vector<Change>::const_iterator it = changes.begin(); it != changes.end(); ++it) {
+      if(it->udp_socket) {
+        if(it->add) {
+          const std::pair<std::map<UDP_Socket *, Uint32>::iterator, bool> inserted = m_udp_sockets.insert(std::make_pair(it->udp_socket, it->max_packet_size));
+          if(inserted.second)
+            m_poller.add(*it->udp_socket);
+          else
+            inserted.first->second = it->max_packet_size;
+        }
+        else {
+          if(m_udp_sockets.erase(it->udp_socket))
+            m_poller.remove(*it->udp_socket);
+          ++removed;
+        }
+      }
+      else {
+        const std::vector<TCP_Message_Socket *>::iterator found = std::find(m_tcp_sockets.begin(), m_tcp_sockets.end(), it->tcp_socket);
+        if(it->add) {
+          if(found == m_tcp_sockets.end()) {
+            m_tcp_sockets.push_back(it->tcp_socket);
+            m_poller.add(*it->tcp_socket);
+          }
+        }
+        else {
+          // It may already have closed
+          if(found != m_tcp_sockets.end()) {
+            m_tcp_sockets.erase(found);
+            m_poller.remove(*it->tcp_socket);
+          }
+          ++removed;
+        }
+      }
+    }
+
+    return removed;
+  }
+
+  void Net_Thread::flush() {
+    // A batch at most, so that a busy game thread cannot starve receives
+    for(size_t queued = std::min(m_outgoing->size(), g_net_thread_batch); queued; --queued) {
+      Packet * const packet = m_outgoing->pop();
+
+      try {
+        if(packet->m_udp_socket)
+          packet->m_udp_socket->send(packet->m_address, packet->m_data);
+        else
+          packet->m_tcp_socket->send_message(packet->m_data);
+
+        ++m_net_statistics.packets_sent;
+        m_net_statistics.bytes_sent += packet->m_data.size();
+      }
+      catch(Error &) {
+        // Socket_Closed, or a message too large for the socket
+        ++m_net_statistics.send_failures;
+
+        if(packet->m_tcp_socket && std::find(m_tcp_sockets.begin(), m_tcp_sockets.end(), packet->m_tcp_socket) != m_tcp_sockets.end())
+          close(*packet->m_tcp_socket);
+      }
+
+      const double latency = net_thread_seconds_since(packet->m_queued);
+      m_net_statistics.send_latency_seconds += latency;
+      m_net_statistics.max_send_latency_seconds = std::max(m_net_statistics.max_send_latency_seconds, latency);
+
+      recycle(packet);
+    }
+  }
+
+  void Net_Thread::drain() {
+    // Report closed sockets as soon as there is room
+    size_t reported = 0u;
+    while(reported != m_closed_reports.size()) {
+      m_closed_reports[reported]->m_queued = SDL_GetPerformanceCounter();
+      if(!m_incoming->push(m_closed_reports[reported]))
+        break;
+      ++reported;
+    }
+    m_closed_reports.erase(m_closed_reports.begin(), m_closed_reports.begin() + reported);
+
+    const std::vector<UDP_Socket *> &udp_sockets = m_poller.get_ready_UDP_Sockets();
+    for(std::vector<UDP_Socket *>::const_iterator it = udp_sockets.begin(); it != udp_sockets.end(); ++it) {
+      if(*it == m_wake) {
+        char discard[16];
+        IPaddress ip;
+        while(m_wake->receive(ip, discard, sizeof(discard)) > 0);
+        continue;
+      }
+
+      const std::map<UDP_Socket *, Uint32>::const_iterator found = m_udp_sockets.find(*it);
+      if(found != m_udp_sockets.end())
+        drain(**it, found->second);
+    }
+
+    const std::vector<TCP_Socket *> &tcp_sockets = m_poller.get_ready_TCP_Sockets();
+    for(std::vector<TCP_Socket *>::const_iterator it = tcp_sockets.begin(); it != tcp_sockets.end(); ++it) {
+      // Only TCP_Message_Sockets are added; Any that closed since the wait are left alone
+      TCP_Message_Socket * const socket = static_cast<TCP_Message_Socket *>(*it);
+      if(std::find(m_tcp_sockets.begin(), m_tcp_sockets.end(), socket) != m_tcp_sockets.end())
+        drain(*socket);
+    }
+  }
+
+  void Net_Thread::drain(UDP_Socket &socket, const Uint32 &max_packet_size) {
+    // A ring's worth at most, so that a flood cannot starve sends; The rest waits for the next round
+    for(size_t i = 0u; i != m_incoming->capacity(); ++i) {
+      Packet * const packet = m_spare ? m_spare : allocate(*m_free_incoming);
+      m_spare = 0;
+
+      packet->m_data.resize(max_packet_size);
+
+      int received = 0;
+      try {
+        received = socket.receive(packet->m_address, packet->m_data);
+      }
+      catch(Error &) {
+        // Closed along with Net
+      }
+
+      if(received <= 0) {
+        m_spare = packet;
+        return;
+      }
+
+      packet->m_udp_socket = &socket;
+      packet->m_tcp_socket = 0;
+      packet->m_closed = false;
+
+      ++m_net_statistics.packets_received;
+      m_net_statistics.bytes_received += Uint32(received);
+
+      deliver(packet);
+    }
+  }
+
+  void Net_Thread::drain(TCP_Message_Socket &socket) {
+    for(size_t i = 0u; i != m_incoming->capacity(); ++i) {
+      // A stream must not lose messages; The rest stays with the system, whose flow control holds the sender back
+      if(m_incoming->full())
+        return;
+
+      Packet * const packet = m_spare ? m_spare : allocate(*m_free_incoming);
+      m_spare = 0;
+
+      bool received = false;
+      try {
+        received = socket.receive_message(packet->m_data);
+      }
+      catch(Error &) {
+        m_spare = packet;
+        close(socket);
+        return;
+      }
+
+      if(!received) {
+        m_spare = packet;
+        return;
+      }
+
+      packet->m_udp_socket = 0;
+      packet->m_tcp_socket = &socket;
+      packet->m_address.host = 0;
+      packet->m_address.port = 0;
+      packet->m_closed = false;
+
+      ++m_net_statistics.packets_received;
+      m_net_statistics.bytes_received += packet->m_data.size();
+
+      deliver(packet);
+    }
+  }
+
+  void Net_Thread::deliver(Packet * const &packet) {
+    packet->m_queued = SDL_GetPerformanceCounter();
+
+    if(m_incoming->push(packet))
+      m_net_statistics.max_incoming_depth = std::max(m_net_statistics.max_incoming_depth, m_incoming->size());
+    else {
+      ++m_net_statistics.packets_dropped;
+      m_spare = packet;
+    }
+  }
+
+  void Net_Thread::close(TCP_Message_Socket &socket) {
+    m_poller.remove(socket);
+    m_tcp_sockets.erase(std::find(m_tcp_sockets.begin(), m_tcp_sockets.end(), &socket));
+
+    Packet * const packet = m_spare ? m_spare : allocate(*m_free_incoming);
+    m_spare = 0;
+
+    packet->m_udp_socket = 0;
+    packet->m_tcp_socket = &socket;
+    packet->m_address.host = 0;
+    packet->m_address.port = 0;
+    packet->m_data.clear();
+    packet->m_closed = true;
+
+    m_closed_reports.push_back(packet);
+  }
+
+  void Net_Thread::recycle(Packet * const &packet) {
+    if(!m_free_outgoing->push(packet))
+      delete packet;
+  }
+
+  void Net_Thread::Uninit::operator()() {
+    m_net_thread.stop();
+  }
+
+}
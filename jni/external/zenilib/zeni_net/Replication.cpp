@@ -0,0 +1,443 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_net.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#if defined(_DEBUG) && defined(_WINDOWS)
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+
+namespace Zeni {
+
+  static const size_t g_replication_history = 64u; ///< Packets awaiting acknowledgement per client
+
+  float Replicated::get_priority(const IPaddress &) const {
+    return 1.0f;
+  }
+
+  struct Replication_Server::Client {
+    struct Record {
+      Record()
+        : serial(0u),
+        first_sequence(0u),
+        baseline(0u),
+        priority(0.0f),
+        sent(false)
+      {
+      }
+
+      Uint32 serial; ///< The Object this describes
+      Uint32 first_sequence; ///< Acknowledgements of earlier packets no longer apply
+      Uint32 baseline; ///< The tick of the latest state acknowledged, or 0 if none has been
+      float priority; ///< Accumulated since last sent
+      bool sent; ///< The client may have it
+    };
+
+    struct Packet {
+      Packet() : sequence(0u), tick(0u) {}
+
+      Uint32 sequence; ///< 0 once acknowledged
+      Uint32 tick;
+      std::vector<std::pair<size_t, Uint32> > objects; ///< (index, serial)
+      std::vector<VLUID> removals;
+    };
+
+    Client() : sequence(0u), packets(g_replication_history) {}
+
+    Uint32 sequence;
+    std::vector<Record> records; ///< Parallel to m_objects
+    std::vector<VLUID> removals; ///< Pending until acknowledged
+    std::vector<Packet> packets; ///< By sequence, modulo g_replication_history
+    std::vector<std::pair<float, size_t> > candidates; ///< (priority, index) for write()
+  };
+
+  Replication_Server::Object::Object()
+    : object(0),
+    serial(0u),
+    last_changed(0u)
+  {
+  }
+
+  Replication_Server::Replication_Server()
+    : m_tick(1u),
+    m_serial(0u),
+    m_scratch(256u)
+  {
+  }
+
+  Replication_Server::~Replication_Server() {
+    for(std::map<IPaddress, Client *>::iterator it = m_clients.begin(); it != m_clients.end(); ++it)
+      delete it->second;
+  }
+
+  VLUID Replication_Server::add(Replicated &object) {
+    size_t index;
+    if(m_free.empty()) {
+      index = m_objects.size();
+      m_objects.push_back(Object());
+    }
+    else {
+      index = m_free.back();
+      m_free.pop_back();
+    }
+
+    Object &o = m_objects[index];
+    o.object = &object;
+    o.serial = ++m_serial;
+    o.id = m_next_id++;
+    o.changed.clear();
+    o.offsets.clear();
+    o.state.clear();
+
+    snapshot(o);
+
+    return o.id;
+  }
+
+  void Replication_Server::remove(const VLUID &id) {
+    for(size_t i = 0u; i != m_objects.size(); ++i) {
+      Object &o = m_objects[i];
+      if(!o.object || o.id != id)
+        continue;
+
+      for(std::map<IPaddress, Client *>::iterator it = m_clients.begin(); it != m_clients.end(); ++it) {
+        Client &client = *it->second;
+        if(i < client.records.size() && client.records[i].serial == o.serial && client.records[i].sent)
+          client.removals.push_back(o.id);
+      }
+
+      o.object = 0;
+      m_free.push_back(i);
+      return;
+    }
+  }
+
+  void Replication_Server::add_client(const IPaddress &client) {
+    Client * &c = m_clients[client];
+    if(!c)
+      c = new Client;
+  }
+
+  void Replication_Server::remove_client(const IPaddress &client) {
+    std::map<IPaddress, Client *>::iterator it = m_clients.find(client);
+    if(it != m_clients.end()) {
+      delete it->second;
+      m_clients.erase(it);
+    }
+  }
+
+  void Replication_Server::update() {
+    if(!++m_tick)
+      ++m_tick;
+
+    for(std::vector<Object>::iterator it = m_objects.begin(); it != m_objects.end(); ++it)
+      if(it->object)
+        snapshot(*it);
+  }
+
+  Uint32 Replication_Server::write(const IPaddress &client, Byte_Writer &packet) {
+    std::map<IPaddress, Client *>::iterator ct = m_clients.find(client);
+    if(ct == m_clients.end())
+      return 0u;
+    Client &c = *ct->second;
+
+    if(!++c.sequence)
+      ++c.sequence;
+
+    Client::Packet &sent = c.packets[c.sequence % g_replication_history];
+    sent.sequence = c.sequence;
+    sent.tick = m_tick;
+    sent.objects.clear();
+    sent.removals.clear();
+
+    // Decide what this client needs before writing anything, so that removals go out at once
+    c.records.resize(m_objects.size());
+    c.candidates.clear();
+    for(size_t i = 0u; i != m_objects.size(); ++i) {
+      const Object &o = m_objects[i];
+      if(!o.object)
+        continue;
+
+      Client::Record &record = c.records[i];
+      if(record.serial != o.serial) {
+        record = Client::Record();
+        record.serial = o.serial;
+        record.first_sequence = c.sequence;
+      }
+
+      const float priority = o.object->get_priority(client);
+      if(priority <= 0.0f) {
+        if(record.sent)
+          c.removals.push_back(o.id);
+
+        record = Client::Record();
+        record.serial = o.serial;
+        record.first_sequence = c.sequence;
+        continue;
+      }
+
+      if(!record.sent) {
+        // Relevant again before its removal was acknowledged
+        std::vector<VLUID>::iterator jt = std::find(c.removals.begin(), c.removals.end(), o.id);
+        if(jt != c.removals.end())
+          c.removals.erase(jt);
+      }
+
+      if(record.baseline && o.last_changed <= record.baseline) {
+        record.priority = 0.0f;
+        continue;
+      }
+
+      record.priority += priority;
+      c.candidates.push_back(std::make_pair(record.priority, i));
+    }
+
+    std::sort(c.candidates.begin(), c.candidates.end(), std::greater<std::pair<float, size_t> >());
+
+    serialize(packet, c.sequence);
+    serialize(packet, m_tick);
+
+    char * const num_removals = packet.write_in_place(sizeof(Uint16));
+    Uint16 removals = 0u;
+    for(std::vector<VLUID>::const_iterator it = c.removals.begin(); it != c.removals.end() && removals != 0xFFFFu; ++it) {
+      if(packet.remaining() < it->size())
+        break;
+      serialize(packet, *it);
+      sent.removals.push_back(*it);
+      ++removals;
+    }
+
+    char * const num_objects = packet.write_in_place(sizeof(Uint16));
+    if(packet.fail())
+      return 0u;
+
+    Uint16 objects = 0u;
+    for(std::vector<std::pair<float, size_t> >::const_iterator it = c.candidates.begin(); it != c.candidates.end() && objects != 0xFFFFu; ++it) {
+      const Object &o = m_objects[it->second];
+      Client::Record &record = c.records[it->second];
+      const bool is_new = !record.baseline;
+      const Uint16 num_fields = Uint16(o.changed.size());
+
+      // Write where the record would go, and keep it only if it fit
+      Byte_Writer writer(packet.write_in_place(0u), packet.remaining());
+
+      serialize(writer, o.id);
+      writer.write_bits(is_new ? 1u : 0u, 1u);
+      if(is_new)
+        writer.write_bits(o.object->get_type(), 16u);
+      else {
+        for(Uint16 field = 0u; field != num_fields; ++field)
+          writer.write_bits(o.changed[field] > record.baseline ? 1u : 0u, 1u);
+      }
+
+      for(Uint16 field = 0u; field != num_fields; ++field)
+        if(is_new || o.changed[field] > record.baseline)
+          writer.write(&o.state[0] + o.offsets[field], o.offsets[field + 1u] - o.offsets[field]);
+
+      if(writer.fail())
+        continue;
+
+      packet.write_in_place(writer.size());
+      sent.objects.push_back(std::make_pair(it->second, o.serial));
+      record.priority = 0.0f;
+      record.sent = true;
+      ++objects;
+    }
+
+    // Now that the counts are known
+    Byte_Writer removals_writer(num_removals, sizeof(Uint16));
+    serialize(removals_writer, removals);
+    Byte_Writer objects_writer(num_objects, sizeof(Uint16));
+    serialize(objects_writer, objects);
+
+    return c.sequence;
+  }
+
+  void Replication_Server::acknowledge(const IPaddress &client, const Uint32 &sequence) {
+    std::map<IPaddress, Client *>::iterator ct = m_clients.find(client);
+    if(ct == m_clients.end() || !sequence)
+      return;
+    Client &c = *ct->second;
+
+    Client::Packet &sent = c.packets[sequence % g_replication_history];
+    if(sent.sequence != sequence)
+      return;
+    sent.sequence = 0u;
+
+    for(std::vector<std::pair<size_t, Uint32> >::const_iterator it = sent.objects.begin(); it != sent.objects.end(); ++it) {
+      Client::Record &record = c.records[it->first];
+      if(record.serial == it->second && sequence >= record.first_sequence && sent.tick > record.baseline)
+        record.baseline = sent.tick;
+    }
+
+    for(std::vector<VLUID>::const_iterator it = sent.removals.begin(); it != sent.removals.end(); ++it) {
+      std::vector<VLUID>::iterator jt = std::find(c.removals.begin(), c.removals.end(), *it);
+      if(jt != c.removals.end())
+        c.removals.erase(jt);
+    }
+  }
+
+  void Replication_Server::snapshot(Object &o) {
+    const Uint16 num_fields = o.object->get_num_fields();
+    m_scratch_offsets.resize(num_fields + 1u);
+
+    for(;;) {
+      Byte_Writer writer(&m_scratch[0], m_scratch.size());
+      for(Uint16 field = 0u; field != num_fields; ++field) {
+        m_scratch_offsets[field] = Uint32(writer.size());
+        o.object->serialize_field(writer, field);
+      }
+      m_scratch_offsets[num_fields] = Uint32(writer.size());
+
+      if(writer.good())
+        break;
+
+      m_scratch.resize(2u * m_scratch.size());
+    }
+
+    if(o.changed.size() != num_fields) {
+      o.changed.assign(num_fields, m_tick);
+      o.last_changed = m_tick;
+    }
+    else {
+      for(Uint16 field = 0u; field != num_fields; ++field) {
+        const Uint32 size = m_scratch_offsets[field + 1u] - m_scratch_offsets[field];
+        if(size != o.offsets[field + 1u] - o.offsets[field] ||
+           memcmp(&m_scratch[0] + m_scratch_offsets[field], &o.state[0] + o.offsets[field], size))
+        {
+          o.changed[field] = m_tick;
+          o.last_changed = m_tick;
+        }
+      }
+    }
+
+    o.offsets.swap(m_scratch_offsets);
+    o.state.assign(m_scratch.begin(), m_scratch.begin() + o.offsets[num_fields]);
+  }
+
+  void Replication_Client::Factory::destroy(Replicated * const &object) {
+    delete object;
+  }
+
+  Replication_Client::Replication_Client(Factory &factory)
+    : m_factory(&factory),
+    m_tick(0u)
+  {
+  }
+
+  Replication_Client::~Replication_Client() {
+    for(std::map<VLUID, Replicated *>::iterator it = m_objects.begin(); it != m_objects.end(); ++it)
+      m_factory->destroy(it->second);
+  }
+
+  Uint32 Replication_Client::read(Byte_Reader &packet) {
+    Uint32 sequence, tick;
+    unserialize(unserialize(packet, sequence), tick);
+    if(packet.fail())
+      throw Replication_Corrupt();
+
+    // Acknowledging a packet older than what has been applied would mislead the server
+    if(tick < m_tick)
+      return 0u;
+    m_tick = tick;
+
+    Uint16 num_removals;
+    if(unserialize(packet, num_removals).fail())
+      throw Replication_Corrupt();
+
+    for(Uint16 i = 0u; i != num_removals; ++i) {
+      VLUID id;
+      if(unserialize(packet, id).fail())
+        throw Replication_Corrupt();
+
+      std::map<VLUID, Replicated *>::iterator it = m_objects.find(id);
+      if(it != m_objects.end()) {
+        m_factory->destroy(it->second);
+        m_objects.erase(it);
+      }
+    }
+
+    Uint16 num_objects;
+    if(unserialize(packet, num_objects).fail())
+      throw Replication_Corrupt();
+
+    for(Uint16 i = 0u; i != num_objects; ++i) {
+      VLUID id;
+      Uint32 is_new;
+      unserialize(packet, id).read_bits(is_new, 1u);
+      if(packet.fail())
+        throw Replication_Corrupt();
+
+      std::map<VLUID, Replicated *>::iterator it = m_objects.find(id);
+      Replicated *object = it != m_objects.end() ? it->second : 0;
+
+      m_fields.clear();
+      if(is_new) {
+        Uint32 type;
+        if(packet.read_bits(type, 16u).fail())
+          throw Replication_Corrupt();
+
+        if(object && object->get_type() != type) {
+          m_factory->destroy(object);
+          m_objects.erase(it);
+          object = 0;
+        }
+
+        if(!object) {
+          object = m_factory->create(Uint16(type));
+          if(!object)
+            throw Replication_Corrupt();
+          m_objects[id] = object;
+        }
+
+        for(Uint16 field = 0u; field != object->get_num_fields(); ++field)
+          m_fields.push_back(field);
+      }
+      else {
+        if(!object)
+          throw Replication_Corrupt();
+
+        for(Uint16 field = 0u; field != object->get_num_fields(); ++field) {
+          Uint32 changed;
+          if(packet.read_bits(changed, 1u).fail())
+            throw Replication_Corrupt();
+          if(changed)
+            m_fields.push_back(field);
+        }
+      }
+
+      for(std::vector<Uint16>::const_iterator jt = m_fields.begin(); jt != m_fields.end(); ++jt)
+        object->unserialize_field(packet, *jt);
+
+      if(packet.fail())
+        throw Replication_Corrupt();
+    }
+
+    return sequence;
+  }
+
+  Replicated * Replication_Client::get(const VLUID &id) const {
+    std::map<VLUID, Replicated *>::const_iterator it = m_objects.find(id);
+    return it != m_objects.end() ? it->second : 0;
+  }
+
+}
@@ -0,0 +1,432 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_net.h>
+
+#include <cmath>
+#include <cstring>
+
+#if defined(_DEBUG) && defined(_WINDOWS)
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+
+namespace Zeni {
+
+  // Packet: Uint8 flags, Uint16 sequence, Uint16 ack, Uint32 ack_bits, then messages
+  // Message: Uint8 flags, Uint16 id, Uint16 order, Uint16 size, then data
+  static const size_t g_packet_header_size = 9u;
+  static const size_t g_message_header_size = 7u;
+  static const Uint8 g_packet_ack = 0x1u; ///< The ack fields are valid
+  static const Uint8 g_message_ordered = 0x1u;
+
+  static const size_t g_sent_packets = 1024u; ///< Packets remembered until acknowledged or lost
+  static const float g_max_cwnd = 512.0f;
+  static const Uint32 g_min_rto = 50u;
+  static const Uint32 g_max_rto = 4000u;
+  static const Uint32 g_id_window = 0x8000u; ///< Ids sent past the oldest unacknowledged one; Half the 16-bit id space
+
+  /// Compare 16-bit sequence numbers that may have wrapped around
+  static bool sequence_greater(const Uint16 &lhs, const Uint16 &rhs) {
+    const Uint16 difference = Uint16(lhs - rhs);
+    return difference && difference < 0x8000u;
+  }
+
+  UDP_Channel::UDP_Channel(const Uint16 &port, const IPaddress &peer, const Uint16 &packet_size, const Uint32 &timeout)
+    : m_socket(port),
+    m_peer(peer),
+    m_has_peer(true),
+    m_packet_size(packet_size),
+    m_timeout(timeout)
+  {
+    init();
+  }
+
+  UDP_Channel::UDP_Channel(const Uint16 &port, const Uint16 &packet_size, const Uint32 &timeout)
+    : m_socket(port),
+    m_has_peer(false),
+    m_packet_size(packet_size),
+    m_timeout(timeout)
+  {
+    m_peer.host = 0;
+    m_peer.port = 0;
+
+    init();
+  }
+
+  void UDP_Channel::init() {
+    assert(m_packet_size > g_packet_header_size + g_message_header_size);
+
+    m_last_heard = SDL_GetTicks();
+
+    m_sequence = 0u;
+    m_next_id = 0u;
+    m_next_order = 0u;
+    m_in_flight = 0u;
+    m_srtt = 0.0f;
+    m_rttvar = 0.0f;
+    m_rto = 500u;
+    m_cwnd = 4.0f;
+    m_ssthresh = 64.0f;
+    m_reduction_time = m_last_heard;
+    m_has_acked = false;
+    m_acked_time = 0u;
+    m_acked_sequence = 0u;
+    m_retransmissions = 0u;
+
+    m_has_remote_sequence = false;
+    m_remote_sequence = 0u;
+    m_ack_bits = 0u;
+    m_ack_pending = false;
+    m_next_delivery = 0u;
+
+    m_sent.resize(g_sent_packets);
+    m_received_ids.resize(0x10000u / 32u, 0u);
+    m_packet.resize(m_packet_size);
+  }
+
+  void UDP_Channel::send(const void * const &data, const Uint16 &num_bytes, const Order &order) {
+    if(g_packet_header_size + g_message_header_size + num_bytes > m_packet_size)
+      throw UDP_Packet_Overflow();
+
+    Outgoing &outgoing = m_unacked[m_next_id];
+    outgoing.data = String(reinterpret_cast<const char *>(data), num_bytes);
+    outgoing.ordered = order == ORDERED;
+    outgoing.order = outgoing.ordered ? m_next_order++ : 0u;
+    outgoing.queued = true;
+
+    m_queue.push_back(m_next_id++);
+  }
+
+  void UDP_Channel::send(const String &data, const Order &order) {
+    send(data.c_str(), Uint16(data.size()), order);
+  }
+
+  bool UDP_Channel::receive(String &data) {
+    if(m_delivered.empty())
+      return false;
+
+    data.swap(m_delivered.front());
+    m_delivered.pop_front();
+    return true;
+  }
+
+  void UDP_Channel::update() {
+    const Uint32 now = SDL_GetTicks();
+
+    for(;;) {
+      IPaddress ip;
+      const int received = m_socket.receive(ip, &m_packet[0], m_packet_size);
+      if(!received)
+        break;
+
+      if(!m_has_peer) {
+        m_peer = ip;
+        m_has_peer = true;
+      }
+      else if(ip.host != m_peer.host || ip.port != m_peer.port)
+        continue;
+
+      receive_packet(&m_packet[0], size_t(received), now);
+    }
+
+    if(!m_has_peer)
+      return;
+
+    if(!m_unacked.empty() && now - m_last_heard > m_timeout)
+      throw Socket_Closed();
+
+    detect_losses(now);
+    send_packets(now);
+  }
+
+  float UDP_Channel::get_send_rate() const {
+    return m_cwnd * m_packet_size * 1000.0f / (m_srtt > 1.0f ? m_srtt : 1.0f);
+  }
+
+  void UDP_Channel::receive_packet(const char * const &packet, const size_t &packet_size, const Uint32 &now) {
+    if(packet_size < g_packet_header_size)
+      return;
+
+    m_last_heard = now;
+
+    const void *bp = packet + 1;
+    const Uint16 sequence = SDLNet_Read16(bp);
+    bp = packet + 3;
+    const Uint16 ack = SDLNet_Read16(bp);
+    bp = packet + 5;
+    const Uint32 ack_bits = SDLNet_Read32(bp);
+
+    if(Uint8(packet[0]) & g_packet_ack) {
+      acknowledge(ack, now);
+      for(Uint16 i = 0u; i != 32u; ++i)
+        if(ack_bits & (1u << i))
+          acknowledge(Uint16(ack - 1u - i), now);
+    }
+
+    // Note this packet in the next acknowledgement
+    if(!m_has_remote_sequence) {
+      m_has_remote_sequence = true;
+      m_remote_sequence = sequence;
+      m_ack_bits = 0u;
+    }
+    else if(sequence_greater(sequence, m_remote_sequence)) {
+      const Uint16 shift = Uint16(sequence - m_remote_sequence);
+      m_ack_bits = shift > 32u ? 0u : ((m_ack_bits << 1) | 1u) << (shift - 1u);
+      m_remote_sequence = sequence;
+    }
+    else if(sequence != m_remote_sequence) {
+      const Uint16 behind = Uint16(m_remote_sequence - sequence);
+      if(behind <= 32u)
+        m_ack_bits |= 1u << (behind - 1u);
+    }
+
+    for(size_t offset = g_packet_header_size; offset + g_message_header_size <= packet_size; ) {
+      const char * const message = packet + offset;
+      bp = message + 1;
+      const Uint16 id = SDLNet_Read16(bp);
+      bp = message + 3;
+      const Uint16 order = SDLNet_Read16(bp);
+      bp = message + 5;
+      const Uint16 num_bytes = SDLNet_Read16(bp);
+
+      offset += g_message_header_size + num_bytes;
+      if(offset > packet_size)
+        break;
+
+      deliver(id, (Uint8(message[0]) & g_message_ordered) != 0, order, message + g_message_header_size, num_bytes);
+      m_ack_pending = true;
+    }
+  }
+
+  void UDP_Channel::acknowledge(const Uint16 &sequence, const Uint32 &now) {
+    Sent_Packet &sent = m_sent[sequence % g_sent_packets];
+    if(!sent.in_flight || sent.sequence != sequence)
+      return;
+
+    sent.in_flight = false;
+    --m_in_flight;
+
+    if(!m_has_acked || Sint32(sent.time - m_acked_time) > 0 ||
+       (sent.time == m_acked_time && sequence_greater(sent.sequence, m_acked_sequence)))
+    {
+      m_has_acked = true;
+      m_acked_time = sent.time;
+      m_acked_sequence = sent.sequence;
+    }
+
+    // Each Sent_Packet is a single transmission, so the sample is unambiguous
+    const float rtt = float(now - sent.time);
+    if(m_srtt == 0.0f) {
+      m_srtt = rtt;
+      m_rttvar = rtt / 2.0f;
+    }
+    else {
+      m_rttvar = 0.75f * m_rttvar + 0.25f * std::fabs(m_srtt - rtt);
+      m_srtt = 0.875f * m_srtt + 0.125f * rtt;
+    }
+
+    m_rto = Uint32(m_srtt + 4.0f * m_rttvar);
+    if(m_rto < g_min_rto)
+      m_rto = g_min_rto;
+    else if(m_rto > g_max_rto)
+      m_rto = g_max_rto;
+
+    bool acked_message = false;
+    for(std::vector<Uint32>::const_iterator it = sent.messages.begin(); it != sent.messages.end(); ++it) {
+      const std::map<Uint32, Outgoing>::iterator jt = m_unacked.find(*it);
+      if(jt != m_unacked.end()) {
+        m_unacked.erase(jt);
+        acked_message = true;
+      }
+    }
+
+    if(acked_message) {
+      // Slow start, then additive increase
+      m_cwnd += m_cwnd < m_ssthresh ? 1.0f : 1.0f / m_cwnd;
+      if(m_cwnd > g_max_cwnd)
+        m_cwnd = g_max_cwnd;
+    }
+  }
+
+  void UDP_Channel::deliver(const Uint16 &id, const bool &ordered, const Uint16 &order, const char * const &data, const Uint16 &num_bytes) {
+    // The sender keeps every id it sends within g_id_window of the oldest it has yet to see acknowledged,
+    // so ids half the id space away can no longer be in flight, and their bits are reused
+    Uint32 &received = m_received_ids[id / 32u];
+    const Uint32 bit = 1u << (id % 32u);
+    if(received & bit)
+      return;
+    received |= bit;
+
+    const Uint16 stale = Uint16(id + 0x8000u);
+    m_received_ids[stale / 32u] &= ~(1u << (stale % 32u));
+
+    if(!ordered) {
+      m_delivered.push_back(String(data, num_bytes));
+      return;
+    }
+
+    const Uint16 ahead = Uint16(order - Uint16(m_next_delivery));
+    if(ahead >= 0x8000u)
+      return;
+
+    if(ahead) {
+      m_held[m_next_delivery + ahead] = String(data, num_bytes);
+      return;
+    }
+
+    m_delivered.push_back(String(data, num_bytes));
+    ++m_next_delivery;
+
+    for(std::map<Uint32, String>::iterator it = m_held.begin(); it != m_held.end() && it->first == m_next_delivery; m_held.erase(it++)) {
+      m_delivered.push_back(String());
+      m_delivered.back().swap(it->second);
+      ++m_next_delivery;
+    }
+  }
+
+  void UDP_Channel::detect_losses(const Uint32 &now) {
+    const Uint32 reordering = Uint32(1.25f * m_srtt);
+    bool timed_out = false;
+    bool reduce = false;
+
+    for(std::vector<Sent_Packet>::iterator it = m_sent.begin(); it != m_sent.end(); ++it) {
+      if(!it->in_flight)
+        continue;
+
+      // Lost if a packet sent after it was acknowledged long enough ago to rule out reordering
+      const bool overtaken = m_has_acked &&
+                             (Sint32(m_acked_time - it->time) > 0 ||
+                              (m_acked_time == it->time && sequence_greater(m_acked_sequence, it->sequence))) &&
+                             now - it->time > reordering;
+
+      if(!overtaken) {
+        if(now - it->time <= m_rto)
+          continue;
+        timed_out = true;
+      }
+
+      it->in_flight = false;
+      --m_in_flight;
+
+      if(Sint32(it->time - m_reduction_time) >= 0)
+        reduce = true;
+
+      for(std::vector<Uint32>::const_iterator jt = it->messages.begin(); jt != it->messages.end(); ++jt) {
+        const std::map<Uint32, Outgoing>::iterator kt = m_unacked.find(*jt);
+        if(kt != m_unacked.end() && !kt->second.queued) {
+          kt->second.queued = true;
+          m_queue.push_front(*jt);
+          ++m_retransmissions;
+        }
+      }
+    }
+
+    if(timed_out)
+      m_rto = m_rto * 2u > g_max_rto ? g_max_rto : m_rto * 2u;
+
+    if(reduce) {
+      // Only for packets sent since the last reduction, so once per round trip
+      m_ssthresh = 0.7f * m_cwnd > 2.0f ? 0.7f * m_cwnd : 2.0f;
+      m_cwnd = m_ssthresh;
+      m_reduction_time = now;
+    }
+  }
+
+  void UDP_Channel::send_packets(const Uint32 &now) {
+    bool sent_any = false;
+
+    while(!m_queue.empty() && m_in_flight < size_t(m_cwnd) && m_in_flight < g_sent_packets / 2u) {
+      Sent_Packet &sent = m_sent[m_sequence % g_sent_packets];
+      if(sent.in_flight)
+        break;
+
+      sent.sequence = m_sequence;
+      sent.time = now;
+      sent.messages.clear();
+
+      size_t size = g_packet_header_size;
+      while(!m_queue.empty()) {
+        const std::map<Uint32, Outgoing>::iterator it = m_unacked.find(m_queue.front());
+        if(it == m_unacked.end()) {
+          // Acknowledged while waiting to be resent
+          m_queue.pop_front();
+          continue;
+        }
+
+        // Ids and orders go out as 16 bits, so a newer one must not catch up with one still unacknowledged
+        if(it->first - m_unacked.begin()->first >= g_id_window)
+          break;
+
+        const Outgoing &outgoing = it->second;
+        if(size + g_message_header_size + outgoing.data.size() > m_packet_size)
+          break;
+
+        char * const message = &m_packet[size];
+        message[0] = char(outgoing.ordered ? g_message_ordered : 0u);
+        void *bp = message + 1;
+        SDLNet_Write16(Uint16(it->first), bp);
+        bp = message + 3;
+        SDLNet_Write16(outgoing.order, bp);
+        bp = message + 5;
+        SDLNet_Write16(Uint16(outgoing.data.size()), bp);
+        memcpy(message + g_message_header_size, outgoing.data.c_str(), outgoing.data.size());
+
+        size += g_message_header_size + outgoing.data.size();
+        sent.messages.push_back(it->first);
+        it->second.queued = false;
+        m_queue.pop_front();
+      }
+
+      if(sent.messages.empty())
+        break;
+
+      sent.in_flight = true;
+      ++m_in_flight;
+      sent_any = true;
+
+      ++m_sequence;
+      // Written last so that it can acknowledge everything received so far
+      char * const header = &m_packet[0];
+      header[0] = char(m_has_remote_sequence ? g_packet_ack : 0u);
+      void *bp = header + 1;
+      SDLNet_Write16(sent.sequence, bp);
+      bp = header + 3;
+      SDLNet_Write16(m_remote_sequence, bp);
+      bp = header + 5;
+      SDLNet_Write32(m_ack_bits, bp);
+
+      m_socket.send(m_peer, &m_packet[0], Uint16(size));
+    }
+
+    if(m_ack_pending && !sent_any) {
+      char * const header = &m_packet[0];
+      header[0] = char(g_packet_ack);
+      void *bp = header + 1;
+      SDLNet_Write16(m_sequence++, bp);
+      bp = header + 3;
+      SDLNet_Write16(m_remote_sequence, bp);
+      bp = header + 5;
+      SDLNet_Write32(m_ack_bits, bp);
+
+      m_socket.send(m_peer, &m_packet[0], Uint16(g_packet_header_size));
+    }
+
+    m_ack_pending = false;
+  }
+
+}
@@ -84,6 +84,29 @@ namespace Zeni {
     
     return is;
   }
+  
+  Byte_Writer & VLUID::serialize(Byte_Writer &writer) const {
+    return Zeni::serialize(writer, m_size).write(m_uid.c_str(), m_size);
+  }
+  
+  Byte_Reader & VLUID::unserialize(Byte_Reader &reader) {
+    Uint16 size;
+    const unsigned char *src = 0;
+    
+    if(Zeni::unserialize(reader, size).good())
+      src = reinterpret_cast<const unsigned char *>(reader.read_in_place(size));
+    
+    if(src) {
+      m_size = size;
+      m_uid.assign(src, size);
+    }
+    else {
+      m_size = 0u;
+      m_uid.clear();
+    }
+    
+    return reader;
+  }
 
 }
 
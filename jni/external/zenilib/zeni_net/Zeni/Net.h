@@ -24,6 +24,10 @@
  *
  * The Net Singleton is responsible for setting up IP sockets.
  *
+ * resolve_host and reverse_lookup block until the system answers.  A
+ * Host_Lookup asks one of Net's resolver threads instead, which are
+ * started on first use.
+ *
  * \author bazald
  *
  * Contact: bazald@zenipex.com
@@ -43,6 +47,34 @@
  * Contact: bazald@zenipex.com
  */
 
+/**
+ * \class Zeni::TCP_Message_Socket
+ *
+ * \ingroup zenilib
+ *
+ * \brief A TCP_Socket that sends and receives whole messages
+ *
+ * Each message is prefixed by its length, written as serialize_size would:
+ * 16 bits, or 65535 followed by 32 bits for longer messages.  A peer that
+ * sends a serialized String per message is therefore already speaking this
+ * framing, and FRAMING_16_BIT keeps messages short enough for such peers
+ * to read in return.  It does not cover what the message holds: a String
+ * or container of 65535 or more elements escapes its own length to 32
+ * bits whatever the framing, and such peers cannot read that.
+ *
+ * receive_message never blocks.  It gathers whatever has arrived and
+ * returns true once a whole message has.  Messages longer than
+ * max_message_size throw Message_Too_Large rather than being buffered.
+ *
+ * After enable_compression, messages are compressed by a Net_Compressor in
+ * STREAM mode.  The peer must enable it at the same point in the stream,
+ * with the same dictionary.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
 /**
  * \class Zeni::TCP_Listener
  *
@@ -87,6 +119,20 @@
  * some overhead in the process).  If you need to use this, your design is probably 
  * flawed, but it does its job as needed.
  *
+ * Up to chunk_sets incomplete messages are held at once, the one that has waited
+ * longest being dropped to make room.  Those that go chunk_timeout milliseconds
+ * without a new chunk are dropped too.  Packets may be read several at a time, so
+ * call receive until it returns 0 rather than waiting on the socket in between.
+ *
+ * Each chunk carries the number of chunks in its message.  Messages of 65535
+ * chunks or more escape it to 32 bits, which older peers cannot read, so
+ * FRAMING_16_BIT throws Message_Too_Large for them instead.  The space set
+ * aside for a message being received is limited to max_message_size.
+ *
+ * After enable_compression, messages are compressed by a Net_Compressor in
+ * MESSAGES mode before being split.  Every peer must enable it, with the
+ * same dictionary.  Messages that fail to decompress are dropped.
+ *
  * \author bazald
  *
  * Contact: bazald@zenipex.com
@@ -112,6 +158,11 @@ struct SDL_Thread;
 namespace Zeni {
 
   class ZENI_NET_DLL Net;
+  class Host_Lookup;
+  class Net_Compressor;
+  class Net_Poller;
+  class Net_Thread;
+  class TCP_Connector;
 
 #ifdef _WINDOWS
   ZENI_NET_EXT template class ZENI_NET_DLL Singleton<Net>;
@@ -144,13 +195,63 @@ namespace Zeni {
     IPaddress resolve_host(const String &host, const Uint16 &port = 0);
     /// If you want to find a URL associated with an IP address
     String reverse_lookup(IPaddress ip);
+
+  private:
+    friend class Host_Lookup;
+    friend class Net_Poller;
+    friend class Split_UDP_Socket;
+    friend class TCP_Connector;
+
+    /// The members every SDL_net socket begins with, as SDLNet_CheckSockets itself assumes
+    struct Socket_Header {
+      int ready;
+#ifdef _WINDOWS
+      uintptr_t channel; ///< SOCKET
+#else
+      int channel;
+#endif
+    };
+
+    static Socket_Header & get_Socket_Header(void * const &sdlnet_socket) {
+      return *reinterpret_cast<Socket_Header *>(sdlnet_socket);
+    }
+
+    /// All of an SDL_net TCPsocket, so that one connected elsewhere can be handed to a TCP_Socket
+    struct TCP_Socket_Layout {
+      int ready;
+#ifdef _WINDOWS
+      uintptr_t channel; ///< SOCKET
+#else
+      int channel;
+#endif
+      IPaddress remote_address;
+      IPaddress local_address;
+      int sflag;
+    };
+
+    struct Lookup; ///< Shared by a Host_Lookup and the resolver thread working on it
+    struct Resolver; ///< The resolver threads and their queue
+
+    void resolve(Lookup * const &lookup); ///< Queue a Lookup, starting the resolver threads if need be
+    void stop_resolver(); ///< Fail every queued Lookup and let the resolver threads go
+
+    Resolver * m_resolver;
   };
 
   ZENI_NET_DLL Net & get_Net(); ///< Get access to the singleton.
 
+  /// How message lengths are written; Either can be read, and neither changes how serialize writes what is inside a message
+  enum Message_Framing {
+    FRAMING_16_BIT, ///< What peers predating large messages understand; Longer messages throw Message_Too_Large
+    FRAMING_32_BIT ///< Identical to FRAMING_16_BIT for shorter messages, escaping to 32 bits for longer ones
+  };
+
   class ZENI_NET_DLL TCP_Socket {
     TCP_Socket(const TCP_Socket &);
     TCP_Socket & operator=(const TCP_Socket &);
+
+    friend class Net_Poller;
+    friend class Net_Thread;
     
   public:
     TCP_Socket(IPaddress ip); ///< For outgoing connections
@@ -162,20 +263,21 @@ namespace Zeni {
     int check_socket(); // return 0 if open, throw Socket_Closed() on socket closed
     
     /// Send data
-    int try_send(const void * const &data, const Uint16 &num_bytes); // send, returning 0 on success, -1 on socket closed
+    int try_send(const void * const &data, const Uint32 &num_bytes); // send, returning 0 on success, -1 on socket closed
     int try_send(const String &data); // send, returning 0 on success, -1 on socket closed
-    void send(const void * const &data, const Uint16 &num_bytes); // send, returning 0 on success, throw Socket_Closed() on socket closed
+    void send(const void * const &data, const Uint32 &num_bytes); // send, returning 0 on success, throw Socket_Closed() on socket closed
     void send(const String &data); // send, returning 0 on success, throw Socket_Closed() on socket closed
 
     /// Receive up to num_bytes
-    int try_receive(void * const &data, const Uint16 &num_bytes); // receive, returning 0 on success, -1 on socket closed
-    int try_receive(String &data, const Uint16 &num_bytes); // receive, returning 0 on success, -1 on socket closed
-    int receive(void * const &data, const Uint16 &num_bytes); // receive, returning 0 on success, throw Socket_Closed() on socket closed
-    int receive(String &data, const Uint16 &num_bytes); // receive, returning 0 on success, throw Socket_Closed() on socket closed
+    int try_receive(void * const &data, const Uint32 &num_bytes); // receive, returning 0 on success, -1 on socket closed
+    int try_receive(String &data, const Uint32 &num_bytes); // receive, returning 0 on success, -1 on socket closed
+    int receive(void * const &data, const Uint32 &num_bytes); // receive, returning 0 on success, throw Socket_Closed() on socket closed
+    int receive(String &data, const Uint32 &num_bytes); // receive, returning 0 on success, throw Socket_Closed() on socket closed
 
   private:
     TCPsocket sock;
     SDLNet_SocketSet sockset;
+    bool m_ready; ///< Set by a Net_Poller; The next receive need not check the socket
 
     class ZENI_NET_DLL Uninit : public Event::Handler {
       void operator()();
@@ -199,9 +301,48 @@ namespace Zeni {
     } m_uninit;
   };
 
+  class ZENI_NET_DLL TCP_Message_Socket : public TCP_Socket {
+    TCP_Message_Socket(const TCP_Message_Socket &);
+    TCP_Message_Socket & operator=(const TCP_Message_Socket &);
+
+  public:
+    TCP_Message_Socket(IPaddress ip, const Uint32 &max_message_size = ZENI_DEFAULT_MAX_MESSAGE_SIZE); ///< For outgoing connections
+    TCP_Message_Socket(TCPsocket sock, const Uint32 &max_message_size = ZENI_DEFAULT_MAX_MESSAGE_SIZE); ///< For incoming connections
+    ~TCP_Message_Socket();
+
+    const Message_Framing & get_framing() const {return m_framing;}
+    void set_framing(const Message_Framing &framing) {m_framing = framing;} ///< FRAMING_32_BIT by default
+
+    /// Compress messages of at least threshold bytes from here on
+    void enable_compression(const String &dictionary = String(), const Uint32 &threshold = ZENI_DEFAULT_COMPRESSION_THRESHOLD);
+    void disable_compression();
+    Net_Compressor * get_compressor() const {return m_compressor;} ///< 0 unless compression is enabled; Holds the Statistics
+
+    /// Send one message, throwing Socket_Closed() or Message_Too_Large()
+    void send_message(const void * const &data, const Uint32 &num_bytes);
+    void send_message(const String &data);
+
+    /// Returns true once a whole message has arrived, throwing Socket_Closed() or Message_Too_Large()
+    bool receive_message(String &data);
+
+  private:
+    void send_frame(const void * const &data, const Uint32 &num_bytes);
+
+    Message_Framing m_framing;
+    Uint32 m_max_message_size;
+    Net_Compressor * m_compressor;
+
+    char m_header[6]; ///< The length, as far as it has arrived
+    Uint32 m_header_received;
+    String m_message; ///< The message, as far as it has arrived
+    Uint32 m_message_received;
+  };
+
   class ZENI_NET_DLL TCP_Listener {
     TCP_Listener(const TCP_Listener &);
     TCP_Listener & operator=(const TCP_Listener &);
+
+    friend class Net_Poller;
     
   public:
     TCP_Listener(const Uint16 &port);
@@ -237,6 +378,10 @@ namespace Zeni {
   class ZENI_NET_DLL UDP_Socket {
     UDP_Socket(const UDP_Socket &);
     UDP_Socket & operator=(const UDP_Socket &);
+
+    friend class Net_Poller;
+    friend class Net_Thread;
+    friend class Split_UDP_Socket;
     
   public:
     UDP_Socket(const Uint16 &port);
@@ -245,11 +390,11 @@ namespace Zeni {
     IPaddress peer_address() const; ///< Apparently only works if the port was explicitly specified
 
     /// Send data to an IPaddress
-    virtual void send(const IPaddress &ip, const void * const &data, const Uint16 &num_bytes);
+    virtual void send(const IPaddress &ip, const void * const &data, const Uint32 &num_bytes);
     virtual void send(const IPaddress &ip, const String &data);
     
     /// Receive data of up to data.size() from the returned IPaddress; Will error if num_bytes/data.size() is too low
-    virtual int receive(IPaddress &ip, const void * const &data, const Uint16 &num_bytes);
+    virtual int receive(IPaddress &ip, const void * const &data, const Uint32 &num_bytes);
     virtual int receive(IPaddress &ip, String &data); ///<
     
   private:
@@ -281,58 +426,31 @@ namespace Zeni {
     Split_UDP_Socket(const Split_UDP_Socket &);
     Split_UDP_Socket & operator=(const Split_UDP_Socket &);
     
-    struct ZENI_NET_DLL Chunk {
-      Chunk() : size(0), data(0) {}
-      ~Chunk() {delete [] data;}
-      
-      Chunk(const Chunk &rhs)
-        : size(rhs.size),
-          data(rhs.data)
-      {
-        rhs.size = 0;
-        rhs.data = 0;
-      }
-      
-      Chunk & operator=(const Chunk &rhs) {
-        size = rhs.size;
-        data = rhs.data;
-        
-        rhs.size = 0;
-        rhs.data = 0;
-        
-        return *this;
-      }
-      
-      mutable size_t size;
-      mutable char * data;
-    };
-    
-    class ZENI_NET_DLL Chunk_Set {
-      Chunk_Set(const Chunk_Set &);
-      Chunk_Set operator=(const Chunk_Set &);
-    
-    public:
+    /// A message being put back together
+    struct ZENI_NET_DLL Chunk_Set {
+      Chunk_Set();
+
+      size_t size() const; ///< Valid once complete
+
       IPaddress ip;
-      Nonce nonce;
+      Uint32 hash;
+      Uint32 last_arrival; ///< SDL_GetTicks() when the latest chunk arrived
+      Uint32 num_chunks; ///< 0 if unused
+      Uint32 chunks_arrived;
+      Uint16 slot_size; ///< Space set aside for each chunk in data
+      Uint16 split_size; ///< Size of every chunk but the last, once one has arrived
+      Uint16 last_size; ///< Size of the last chunk, once it has arrived
 
 #ifdef _WINDOWS
 #pragma warning( push )
 #pragma warning( disable : 4251 )
 #endif
-      std::vector<Chunk> chunks;
+      std::vector<char> nonce; ///< As serialized
+      std::vector<Uint32> received; ///< One bit per chunk
+      std::vector<char> data; ///< Chunk 'which' at which * slot_size until complete, then contiguous
 #ifdef _WINDOWS
 #pragma warning( pop )
 #endif
-      Uint16 chunks_arrived;
-      
-      Chunk_Set() : chunks_arrived(0u) {}
-      
-      Chunk_Set(const IPaddress &sender, const Nonce &incoming, const Uint16 &num_chunks, const Uint16 &which, Chunk &chunk);
-      
-      bool add_chunk(const IPaddress &sender, const Nonce &incoming, const Uint16 &num_chunks, const Uint16 &which, Chunk &chunk);
-      bool complete() const;
-      
-      Chunk receive() const;
     };
     
     class ZENI_NET_DLL Chunk_Collector {
@@ -340,46 +458,74 @@ namespace Zeni {
       Chunk_Collector operator=(const Chunk_Collector &);
       
     public:
-      Chunk_Collector(const Uint16 &size = ZENI_DEFAULT_CHUNK_SIZE)
-        : m_size(size)
-      {
-        assert(m_size);
-      }
-      
-      ~Chunk_Collector() {
-        for(std::list<Chunk_Set *>::iterator it = chunk_sets.begin(); it != chunk_sets.end(); ++it)
-          delete *it;
-      }
+      Chunk_Collector(const Uint16 &size, const Uint16 &chunk_size, const Uint32 &timeout, const Uint32 &max_message_size);
+
+      const Uint32 & get_max_message_size() const {return m_max_message_size;}
       
-      const Chunk_Set * add_chunk(const IPaddress &sender, const Nonce &incoming, const Uint16 &num_chunks, const Uint16 &which, Chunk &chunk);
+      /// Returns the Chunk_Set this chunk completes, if any; Call release() once done with it
+      Chunk_Set * add_chunk(const IPaddress &sender, const char * const &packet, const size_t &packet_size, const Uint32 &now);
+      void release(Chunk_Set * const &chunk_set);
+      void expire(const Uint32 &now); ///< Drop every Chunk_Set that has gone without a chunk for longer than the timeout
+
+      size_t size() const {return m_sets.size() - m_free.size();} ///< Get the number of incomplete Chunk_Sets
       
     private:
+      size_t find(const IPaddress &sender, const Uint32 &hash, const char * const &nonce, const Uint16 &nonce_size) const; ///< Returns a slot in m_table
+      Chunk_Set & acquire(const Uint32 &now);
+
 #ifdef _WINDOWS
 #pragma warning( push )
 #pragma warning( disable : 4251 )
 #endif
-      std::list<Chunk_Set *> chunk_sets;
+      std::vector<Chunk_Set> m_sets;
+      std::vector<size_t> m_free; ///< Indices of unused Chunk_Sets
+      std::vector<size_t> m_table; ///< Open addressing by hash; Index into m_sets plus one, or 0 if empty
 #ifdef _WINDOWS
 #pragma warning( pop )
 #endif
-      Uint16 m_size;
+      Uint16 m_chunk_size;
+      Uint32 m_timeout;
+      Uint32 m_max_message_size;
+      Uint32 m_last_expiry;
     };
     
   public:
-    Split_UDP_Socket(const Uint16 &port, const Uint16 &chunk_sets = ZENI_DEFAULT_CHUNK_SETS, const Uint16 &chunk_size = ZENI_DEFAULT_CHUNK_SIZE);
+    /// chunk_timeout is in milliseconds
+    Split_UDP_Socket(const Uint16 &port, const Uint16 &chunk_sets = ZENI_DEFAULT_CHUNK_SETS, const Uint16 &chunk_size = ZENI_DEFAULT_CHUNK_SIZE, const Uint32 &chunk_timeout = ZENI_DEFAULT_CHUNK_TIMEOUT, const Uint32 &max_message_size = ZENI_DEFAULT_MAX_MESSAGE_SIZE);
+    ~Split_UDP_Socket();
 
-    /// Send data to an IPaddress
-    virtual void send(const IPaddress &ip, const void * const &data, const Uint16 &num_bytes);
+    const Message_Framing & get_framing() const {return m_framing;}
+    void set_framing(const Message_Framing &framing) {m_framing = framing;} ///< FRAMING_32_BIT by default
+
+    /// Compress messages of at least threshold bytes from here on
+    void enable_compression(const String &dictionary = String(), const Uint32 &threshold = ZENI_DEFAULT_COMPRESSION_THRESHOLD);
+    void disable_compression();
+    Net_Compressor * get_compressor() const {return m_compressor;} ///< 0 unless compression is enabled; Holds the Statistics
+
+    /// Send data to an IPaddress, all chunks at once where the platform allows
+    virtual void send(const IPaddress &ip, const void * const &data, const Uint32 &num_bytes);
     virtual void send(const IPaddress &ip, const String &data);
     
     /// Receive data of up to data.size() from the returned IPaddress; Will error if num_bytes/data.size() is too low
-    virtual int receive(IPaddress &ip, const void * const &data, const Uint16 &num_bytes);
+    virtual int receive(IPaddress &ip, const void * const &data, const Uint32 &num_bytes);
     virtual int receive(IPaddress &ip, String &data);
+
+    size_t get_num_incomplete() const {return m_chunk_collector.size();} ///< Get the number of messages still missing chunks
     
   private:
+    struct Send_Buffer; ///< Chunk headers and scatter/gather lists, kept between sends
+    struct Receive_Buffer; ///< Packets read in one batch, not yet collected
+
+    void send_chunks(const IPaddress &ip, const void * const &data, const Uint32 &num_bytes);
+
     Uint16 m_chunk_size;
+    Message_Framing m_framing;
+    Net_Compressor * m_compressor;
+    String m_decompressed;
     
     Chunk_Collector m_chunk_collector;
+    Send_Buffer * m_send_buffer;
+    Receive_Buffer * m_receive_buffer;
     
     Nonce m_nonce_send;
   };
@@ -400,6 +546,10 @@ namespace Zeni {
     UDP_Packet_Overflow() : Error("Zeni UDP Packet Too Large") {}
   };
 
+  struct ZENI_NET_DLL Message_Too_Large : public Error {
+    Message_Too_Large() : Error("Zeni Message Too Large") {}
+  };
+
   struct ZENI_NET_DLL Socket_Closed : public Error {
     Socket_Closed() : Error("Zeni Socket Unexpectedly Closed") {}
   };
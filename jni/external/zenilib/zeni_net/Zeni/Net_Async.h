@@ -0,0 +1,163 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Host_Lookup
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Host Name Resolution That Does Not Block
+ *
+ * Construction queues the lookup for one of Net's resolver threads, which
+ * use getaddrinfo (or getnameinfo, for a reverse lookup), and so consult
+ * /etc/hosts as the system would.  update() never blocks.  It reports
+ * whether the lookup has finished, failed, or outlived its timeout.
+ *
+ * A lookup cannot be interrupted once a thread has started on it, so
+ * cancel() and timeouts simply stop waiting for it.  Its thread carries
+ * on until the system gives up, and only then moves on to other lookups.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+/**
+ * \class Zeni::TCP_Connector
+ *
+ * \ingroup zenilib
+ *
+ * \brief A TCP Connection Made Without Blocking
+ *
+ * A TCP_Connector given a host name resolves it with a Host_Lookup, then
+ * connects without blocking.  Call update() every frame until it returns
+ * CONNECTED, then pass release() to the TCPsocket constructor of a
+ * TCP_Socket or TCP_Message_Socket.  The timeout covers both steps.
+ *
+ * Destroying a TCP_Connector, or calling cancel(), abandons the
+ * connection unless it has already been released.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_NET_ASYNC_H
+#define ZENI_NET_ASYNC_H
+
+#include <Zeni/Net.h>
+
+#include <Zeni/Define.h>
+
+namespace Zeni {
+
+  class ZENI_NET_DLL Host_Lookup {
+    Host_Lookup(const Host_Lookup &);
+    Host_Lookup & operator=(const Host_Lookup &);
+
+  public:
+    enum State {PENDING, SUCCEEDED, FAILED, TIMED_OUT, CANCELLED};
+
+    /// Find the address of host; timeout is in milliseconds
+    Host_Lookup(const String &host, const Uint16 &port = 0, const Uint32 &timeout = ZENI_DEFAULT_LOOKUP_TIMEOUT);
+    /// Find the name of address, as Net::reverse_lookup would
+    Host_Lookup(const IPaddress &address, const Uint32 &timeout = ZENI_DEFAULT_LOOKUP_TIMEOUT);
+    ~Host_Lookup(); ///< Cancels the lookup if it has yet to finish
+
+    const State & update(); ///< Check whether the lookup has finished or timed out
+    const State & get_state() const {return m_state;} ///< As of the last update()
+    void cancel();
+
+    const IPaddress & get_address() const {return m_address;} ///< Valid once SUCCEEDED
+    const String & get_host() const {return m_host;} ///< Valid once SUCCEEDED
+
+  private:
+    State m_state;
+    Net::Lookup * m_lookup;
+    Uint32 m_start;
+    Uint32 m_timeout;
+
+    IPaddress m_address;
+    String m_host;
+  };
+
+  class ZENI_NET_DLL TCP_Connector {
+    TCP_Connector(const TCP_Connector &);
+    TCP_Connector & operator=(const TCP_Connector &);
+
+  public:
+    enum State {RESOLVING, CONNECTING, CONNECTED, FAILED, TIMED_OUT, CANCELLED};
+
+    /// Connect to address; timeout is in milliseconds
+    TCP_Connector(const IPaddress &address, const Uint32 &timeout = ZENI_DEFAULT_CONNECT_TIMEOUT);
+    /// Look up host, then connect to it
+    TCP_Connector(const String &host, const Uint16 &port, const Uint32 &timeout = ZENI_DEFAULT_CONNECT_TIMEOUT);
+    ~TCP_Connector(); ///< Closes the connection unless it has been released
+
+    const State & update(); ///< Check whether the connection has been made, has failed, or has timed out
+    const State & get_state() const {return m_state;} ///< As of the last update()
+    void cancel();
+
+    const IPaddress & get_address() const {return m_address;} ///< Valid once CONNECTING
+
+    /// Give up the connection once CONNECTED, for a TCP_Socket to take over; Returns 0 otherwise
+    TCPsocket release();
+
+  private:
+    void connect();
+    void close();
+    void finish(const State &state); ///< Close the connection and settle on state
+
+    State m_state;
+    Host_Lookup * m_lookup;
+    Uint32 m_start;
+    Uint32 m_timeout;
+
+    IPaddress m_address;
+#ifdef _WINDOWS
+    uintptr_t m_channel; ///< SOCKET
+#else
+    int m_channel;
+#endif
+
+    class ZENI_NET_DLL Uninit : public Event::Handler {
+      void operator()();
+
+      Uninit * duplicate() const {
+        return new Uninit(m_connector);
+      }
+
+      // Undefined
+      Uninit(const Uninit &);
+      Uninit operator=(const Uninit &);
+
+    public:
+      Uninit(TCP_Connector &connector_)
+        : m_connector(connector_)
+      {
+      }
+
+    private:
+      TCP_Connector &m_connector;
+    } m_uninit;
+  };
+
+}
+
+#include <Zeni/Undefine.h>
+
+#endif
@@ -0,0 +1,81 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Net_Benchmark
+ *
+ * \ingroup zenilib
+ *
+ * \brief Loopback Benchmarks for zeni_net
+ *
+ * Each benchmark that takes a port opens its own sockets on the loopback
+ * interface at that port (and those just above it).  Nothing else should
+ * be using those ports.  Every benchmark writes one line of results per
+ * configuration it tries.
+ *
+ * \note Only built when ENABLE_BENCHMARKS is defined
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_NET_BENCHMARK_H
+#define ZENI_NET_BENCHMARK_H
+
+#include <Zeni/Net.h>
+
+#ifdef ENABLE_BENCHMARKS
+
+/* \cond */
+#include <iosfwd>
+/* \endcond */
+
+namespace Zeni {
+
+  class ZENI_NET_DLL Net_Benchmark {
+  public:
+    /// Time a Net_Poller::wait against TCP_Socket::try_check_socket on each of 16 to max_connections idle connections
+    static void idle_connections(std::ostream &os, const Uint16 &port = 19000u, const size_t &max_connections = 4096u);
+
+    /// Compare Split_UDP_Socket::send against building each chunk with an ostringstream, in packets per second
+    static void split_udp_send(std::ostream &os, const Uint16 &port = 19000u, const Uint16 &chunk_size = 1200u);
+
+    /// Relay Split_UDP_Socket traffic through a socket that drops, duplicates and reorders packets, checking what arrives
+    static void split_udp_loss(std::ostream &os, const Uint16 &port = 19000u, const Uint16 &chunk_size = 1200u);
+
+    /// Stream messages over a UDP_Channel through a relay that adds loss, latency and jitter (and so reordering)
+    static void udp_channel(std::ostream &os, const Uint16 &port = 19000u, const size_t &messages = 4000u);
+
+    /// Replicate moving entities from a Replication_Server to a Replication_Client in memory, in bytes per tick
+    static void replication(std::ostream &os, const size_t &entities = 1000u, const size_t &ticks = 600u);
+
+    /// Compress text and replication messages with a Net_Compressor in each mode, with and without a trained dictionary
+    static void compression(std::ostream &os, const size_t &messages = 2000u);
+
+    /// Resolve localhost both ways, then connect with TCP_Connector to a listener, to a closed port, and past a full backlog
+    static void async_connect(std::ostream &os, const Uint16 &port = 19000u);
+
+    /// Time the game thread's share of sending and receiving bursts of datagrams, directly and through a Net_Thread
+    static void net_thread(std::ostream &os, const Uint16 &port = 19000u, const size_t &bursts = 200u);
+  };
+
+}
+
+#endif
+
+#endif
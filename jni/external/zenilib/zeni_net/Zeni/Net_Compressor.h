@@ -0,0 +1,141 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Net_Compressor
+ *
+ * \ingroup zenilib
+ *
+ * \brief Raw Deflate Compression of Messages
+ *
+ * Each message gains a 1 byte prefix saying whether the rest is deflated.
+ * Messages shorter than the threshold are sent as they are, since deflate
+ * has little to work with there.
+ *
+ * In MESSAGES mode, every message is compressed on its own, so any of them
+ * may be lost, and one that would not shrink is sent as it is.  In STREAM
+ * mode, each message is compressed with those before it as context, which
+ * suits a reliable, ordered transport such as TCP.
+ *
+ * A preset dictionary primes deflate with strings common in typical
+ * messages.  train_dictionary() picks one from sample messages.  Both ends
+ * must use the same dictionary, and the same mode.
+ *
+ * TCP_Message_Socket and Split_UDP_Socket each own one once compression
+ * is enabled, and count what it has done in its Statistics.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_NET_COMPRESSOR_H
+#define ZENI_NET_COMPRESSOR_H
+
+#include <Zeni/Net.h>
+
+/* \cond */
+#include <vector>
+/* \endcond */
+
+#include <Zeni/Define.h>
+
+struct z_stream_s;
+
+namespace Zeni {
+
+  class ZENI_NET_DLL Net_Compressor {
+    Net_Compressor(const Net_Compressor &);
+    Net_Compressor & operator=(const Net_Compressor &);
+
+  public:
+    enum Mode {
+      MESSAGES, ///< Each message on its own, for transports that may lose them
+      STREAM ///< Each message in the context of those before it, for reliable, ordered transports
+    };
+
+    struct ZENI_NET_DLL Statistics {
+      Statistics();
+
+      unsigned long messages_sent;
+      unsigned long messages_deflated; ///< Of messages_sent, those sent compressed
+      Uint64 raw_bytes_sent; ///< Before compression
+      Uint64 wire_bytes_sent; ///< After compression, prefixes included
+      double compress_seconds;
+
+      unsigned long messages_received;
+      Uint64 wire_bytes_received;
+      Uint64 raw_bytes_received;
+      double decompress_seconds;
+
+      String to_string() const;
+    };
+
+    Net_Compressor(const Mode &mode, const String &dictionary = String(), const Uint32 &threshold = ZENI_DEFAULT_COMPRESSION_THRESHOLD, const int &level = ZENI_DEFAULT_COMPRESSION_LEVEL);
+    ~Net_Compressor();
+
+    const Mode & get_mode() const {return m_mode;}
+    const Uint32 & get_threshold() const {return m_threshold;}
+    void set_threshold(const Uint32 &threshold) {m_threshold = threshold;} ///< Changes nothing the peer need know about
+
+    /// Get a message as it should be sent; Valid until the next call
+    const std::vector<char> & compress(const void * const &data, const Uint32 &num_bytes);
+    /// Recover a message as it was before compress(); Throws Compression_Corrupt or Message_Too_Large
+    void decompress(String &message, const void * const &data, const Uint32 &num_bytes, const Uint32 &max_message_size = ZENI_DEFAULT_MAX_MESSAGE_SIZE);
+
+    const Statistics & get_statistics() const {return m_statistics;}
+    void reset_statistics() {m_statistics = Statistics();}
+
+    /// Choose strings that recur across samples, most common last, as a dictionary of up to size bytes
+    static String train_dictionary(const std::vector<String> &samples, const Uint32 &size = 4096u);
+
+  private:
+    void start_deflate();
+    void start_inflate();
+
+    Mode m_mode;
+    String m_dictionary;
+    Uint32 m_threshold;
+    z_stream_s * m_deflate;
+    z_stream_s * m_inflate;
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::vector<char> m_buffer;
+    std::vector<char> m_input; ///< For STREAM mode, where the end of each message must be restored
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+
+    Statistics m_statistics;
+  };
+
+  struct ZENI_NET_DLL Compression_Corrupt : public Error {
+    Compression_Corrupt() : Error("Zeni Compressed Message Corrupt") {}
+  };
+
+  struct ZENI_NET_DLL Compression_Init_Failure : public Error {
+    Compression_Init_Failure() : Error("Zeni Compression Failed to Initialize Correctly") {}
+  };
+
+}
+
+#include <Zeni/Undefine.h>
+
+#endif
@@ -0,0 +1,128 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Net_Poller
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Set of Sockets to Wait on Together
+ *
+ * A Net_Poller waits on every TCP_Socket, TCP_Listener and UDP_Socket
+ * added to it with a single call to epoll on Linux, or to poll elsewhere,
+ * rather than the one select per TCP_Socket::try_receive it would
+ * otherwise take.  A TCP_Socket reported ready receives its next data
+ * without checking again, and a TCP_Listener reported ready has a
+ * connection to accept.
+ *
+ * Level triggering reports a socket after every wait() for as long as it
+ * has data.  Edge triggering reports it only when data arrives, so it must
+ * be drained.  Where poll stands in for epoll, edge triggering reports a
+ * socket only when it becomes ready after a wait() in which it was not.
+ *
+ * Sockets must be removed before they are destroyed.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_NET_POLLER_H
+#define ZENI_NET_POLLER_H
+
+#include <Zeni/Net.h>
+
+/* \cond */
+#include <map>
+#include <vector>
+/* \endcond */
+
+namespace Zeni {
+
+  class ZENI_NET_DLL Net_Poller {
+    Net_Poller(const Net_Poller &);
+    Net_Poller & operator=(const Net_Poller &);
+
+  public:
+    enum Trigger {LEVEL, EDGE};
+
+    Net_Poller(const Trigger &trigger = LEVEL); ///< Throws Net_Poller_Init_Failure
+    ~Net_Poller();
+
+    void add(TCP_Socket &socket);
+    void add(TCP_Listener &listener);
+    void add(UDP_Socket &socket);
+    void remove(TCP_Socket &socket);
+    void remove(TCP_Listener &listener);
+    void remove(UDP_Socket &socket);
+
+    size_t size() const {return m_entries.size();}
+    const Trigger & get_trigger() const {return m_trigger;}
+    static bool is_epoll(); ///< Check to see if epoll is in use rather than poll
+
+    /// Wait up to timeout milliseconds (forever if negative) for registered sockets to become ready, returning how many are
+    size_t wait(const int &timeout = 0);
+
+    // Sockets found ready by the last wait()
+    const std::vector<TCP_Socket *> & get_ready_TCP_Sockets() const {return m_ready_tcp_sockets;}
+    const std::vector<TCP_Listener *> & get_ready_TCP_Listeners() const {return m_ready_tcp_listeners;}
+    const std::vector<UDP_Socket *> & get_ready_UDP_Sockets() const {return m_ready_udp_sockets;}
+
+  private:
+    enum Type {TYPE_TCP_SOCKET, TYPE_TCP_LISTENER, TYPE_UDP_SOCKET};
+
+    struct Entry {
+      Type type;
+      void * object;
+#ifdef _WINDOWS
+      uintptr_t channel; ///< SOCKET, kept from add() since Net may free the SDL_net socket first
+#else
+      int channel; ///< Kept from add() since Net may free the SDL_net socket first
+#endif
+      bool was_ready;
+    };
+
+    struct Backend; ///< epoll or poll state
+
+    void add(const Type &type, void * const &object, void * const &sdlnet_socket);
+    void remove(void * const &object);
+    void ready(Entry &entry);
+
+    Trigger m_trigger;
+    Backend * m_backend;
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::map<void *, Entry *> m_entries;
+
+    std::vector<TCP_Socket *> m_ready_tcp_sockets;
+    std::vector<TCP_Listener *> m_ready_tcp_listeners;
+    std::vector<UDP_Socket *> m_ready_udp_sockets;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  };
+
+  struct ZENI_NET_DLL Net_Poller_Init_Failure : public Error {
+    Net_Poller_Init_Failure() : Error("Zeni Net Poller Failed to Initialize Correctly") {}
+  };
+
+}
+
+#endif
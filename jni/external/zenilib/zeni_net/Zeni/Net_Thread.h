@@ -0,0 +1,250 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Net_Thread
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Thread That Does the Network I/O
+ *
+ * A Net_Thread makes every socket call for the UDP_Sockets and
+ * TCP_Message_Sockets added to it.  Its thread waits on them with a
+ * Net_Poller, drains whatever arrives into pooled Packets, and sends
+ * whatever has been queued with send().  The game thread takes Packets
+ * that are ready with receive() and gives them back with release(), so a
+ * burst of datagrams costs it nothing until it asks for them.
+ *
+ * Packets pass between the two threads through bounded rings that take
+ * no locks.  Each ring has a single producer and a single consumer, so a
+ * Net_Thread must only be used from one thread other than its own.  When
+ * the incoming ring is full, datagrams are dropped as the system would
+ * drop them, while TCP messages are left with the system until there is
+ * room.  When the outgoing ring is full, send() returns false.  The net
+ * thread sleeps while there is nothing to do.  send() wakes it with a
+ * datagram to a loopback UDP_Socket, but only if it is sleeping.
+ *
+ * Once added, a socket belongs to the net thread until remove() returns.
+ * It must not be used directly, or destroyed, in between.  A
+ * TCP_Message_Socket that closes is removed by the net thread, which
+ * reports it with a Packet for which is_closed() is true.
+ *
+ * get_statistics() reports how deep each ring has grown and how long
+ * Packets have waited in them.
+ *
+ * The net thread is stopped, for good, along with Net.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_NET_THREAD_H
+#define ZENI_NET_THREAD_H
+
+#include <Zeni/Net.h>
+#include <Zeni/Net_Poller.h>
+
+/* \cond */
+#include <map>
+#include <vector>
+/* \endcond */
+
+#include <Zeni/Define.h>
+
+namespace Zeni {
+
+  class ZENI_NET_DLL Net_Thread {
+    Net_Thread(const Net_Thread &);
+    Net_Thread & operator=(const Net_Thread &);
+
+  public:
+    class ZENI_NET_DLL Packet {
+      friend class Net_Thread;
+
+      Packet();
+
+      // Undefined
+      Packet(const Packet &);
+      Packet & operator=(const Packet &);
+
+    public:
+      UDP_Socket * get_UDP_Socket() const {return m_udp_socket;} ///< 0 for a TCP_Message_Socket
+      TCP_Message_Socket * get_TCP_Message_Socket() const {return m_tcp_socket;} ///< 0 for a UDP_Socket
+      const IPaddress & get_address() const {return m_address;} ///< The sender, for a UDP_Socket
+      const String & get_data() const {return m_data;}
+      bool is_closed() const {return m_closed;} ///< The socket closed and has been removed; There is no data
+
+    private:
+      UDP_Socket * m_udp_socket;
+      TCP_Message_Socket * m_tcp_socket;
+      IPaddress m_address;
+      String m_data; ///< Keeps its capacity from one use to the next
+      bool m_closed;
+      Uint64 m_queued; ///< SDL_GetPerformanceCounter() as it entered a ring
+    };
+
+    struct ZENI_NET_DLL Statistics {
+      Statistics();
+
+      unsigned long packets_received;
+      Uint64 bytes_received;
+      unsigned long packets_dropped; ///< Datagrams received while the incoming ring was full
+      unsigned long packets_taken; ///< Returned by receive()
+      size_t max_incoming_depth;
+      double receive_latency_seconds; ///< In total, from the net thread receiving each Packet to receive() returning it
+      double max_receive_latency_seconds;
+
+      unsigned long packets_queued; ///< Accepted by send()
+      unsigned long sends_refused; ///< Made while the outgoing ring was full
+      unsigned long packets_sent;
+      Uint64 bytes_sent;
+      unsigned long send_failures; ///< Sockets that closed or overflowed
+      size_t max_outgoing_depth;
+      double send_latency_seconds; ///< In total, from send() to the socket
+      double max_send_latency_seconds;
+
+      unsigned long waits; ///< Times the net thread went to sleep
+      unsigned long wakes; ///< Datagrams sent to wake it
+
+      String to_string() const;
+    };
+
+    Net_Thread(const Uint32 &queue_size = ZENI_DEFAULT_NET_THREAD_QUEUE_SIZE); ///< queue_size is rounded up to a power of 2; Throws Net_Thread_Init_Failure
+    ~Net_Thread();
+
+    /// Hand a socket over to the net thread; Messages larger than max_packet_size are lost
+    void add(UDP_Socket &socket, const Uint32 &max_packet_size = ZENI_DEFAULT_NET_THREAD_PACKET_SIZE);
+    void add(TCP_Message_Socket &socket);
+    /// Take a socket back once the net thread has sent whatever was queued for it
+    void remove(UDP_Socket &socket);
+    void remove(TCP_Message_Socket &socket);
+
+    /// Queue a message for the net thread to send; Returns false if the outgoing ring is full
+    bool send(UDP_Socket &socket, const IPaddress &ip, const void * const &data, const Uint32 &num_bytes);
+    bool send(UDP_Socket &socket, const IPaddress &ip, const String &data);
+    bool send(TCP_Message_Socket &socket, const void * const &data, const Uint32 &num_bytes);
+    bool send(TCP_Message_Socket &socket, const String &data);
+
+    Packet * receive(); ///< Take the next Packet to arrive, or 0 if there is none; Give it back with release()
+    void release(Packet * const &packet);
+
+    size_t get_incoming_depth() const; ///< Packets waiting for receive()
+    size_t get_outgoing_depth() const; ///< Packets waiting to be sent
+
+    Statistics get_statistics() const;
+    void reset_statistics();
+
+  private:
+    struct Ring; ///< A bounded single-producer, single-consumer queue of Packets
+
+    struct Change {
+      bool add;
+      UDP_Socket * udp_socket;
+      TCP_Message_Socket * tcp_socket;
+      Uint32 max_packet_size;
+    };
+
+    static int run(void * net_thread);
+    static void follow(Event::Handler &uninit); ///< Move a socket's Uninit after the Net_Thread's, so the thread stops before the socket closes
+
+    static Packet * allocate(Ring &pool); ///< Take a Packet from a pool, or make a new one
+
+    Packet * prepare_send(); ///< Returns 0 if the outgoing ring is full
+    void queue(Packet * const &packet);
+    void change(const Change &change_);
+    void wake();
+    void stop();
+    void clear(); ///< Free everything once the net thread has stopped
+
+    // Run on the net thread
+    size_t apply_changes();
+    void flush();
+    void drain();
+    void drain(UDP_Socket &socket, const Uint32 &max_packet_size);
+    void drain(TCP_Message_Socket &socket);
+    void deliver(Packet * const &packet); ///< Push onto the incoming ring, or drop
+    void close(TCP_Message_Socket &socket);
+    void recycle(Packet * const &packet); ///< Return a sent Packet to the game thread's pool
+
+    SDL_Thread * m_thread;
+    SDL_mutex * m_mutex;
+    SDL_sem * m_removed; ///< Posted by the net thread once per remove() it has carried out
+    SDL_atomic_t m_sleeping;
+    SDL_atomic_t m_quit;
+    SDL_atomic_t m_num_changes;
+
+    UDP_Socket * m_wake; ///< The net thread waits on it along with everything else
+    UDP_Socket * m_waker;
+    IPaddress m_wake_address;
+
+    Ring * m_incoming;
+    Ring * m_outgoing;
+    Ring * m_free_incoming; ///< Released by the game thread for the net thread to receive into
+    Ring * m_free_outgoing; ///< Sent by the net thread for the game thread to send from again
+
+    Statistics m_statistics; ///< Kept by the game thread
+    Statistics m_net_statistics; ///< Kept by the net thread during a round
+    Statistics m_shared_statistics; ///< Guarded by m_mutex; m_net_statistics merged at the end of each round
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::vector<Change> m_changes; ///< Guarded by m_mutex
+
+    // Used only by the net thread while it runs
+    Net_Poller m_poller;
+    std::map<UDP_Socket *, Uint32> m_udp_sockets; ///< To max_packet_size
+    std::vector<TCP_Message_Socket *> m_tcp_sockets;
+    std::vector<Packet *> m_closed_reports; ///< Packets reporting closed sockets, for when the incoming ring has room
+    Packet * m_spare; ///< Left over from a receive that found nothing
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+
+    class ZENI_NET_DLL Uninit : public Event::Handler {
+      void operator()();
+
+      Uninit * duplicate() const {
+        return new Uninit(m_net_thread);
+      }
+
+      // Undefined
+      Uninit(const Uninit &);
+      Uninit operator=(const Uninit &);
+
+    public:
+      Uninit(Net_Thread &net_thread_)
+        : m_net_thread(net_thread_)
+      {
+      }
+
+    private:
+      Net_Thread &m_net_thread;
+    } m_uninit;
+  };
+
+  struct ZENI_NET_DLL Net_Thread_Init_Failure : public Error {
+    Net_Thread_Init_Failure() : Error("Zeni Net Thread Failed to Initialize Correctly") {}
+  };
+
+}
+
+#include <Zeni/Undefine.h>
+
+#endif
@@ -0,0 +1,203 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Replicated
+ *
+ * \ingroup zenilib
+ *
+ * \brief An object whose state a Replication_Server keeps up to date on its clients
+ *
+ * State is divided into fields, each serialized on its own, so that only
+ * those that have changed need to be sent.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+/**
+ * \class Zeni::Replication_Server
+ *
+ * \ingroup zenilib
+ *
+ * \brief Delta-compressed replication of Replicated objects
+ *
+ * Each object added is tagged with a VLUID.  Call update() once per tick
+ * to note which fields have changed, then write() a packet for each client
+ * and pass the sequence numbers clients acknowledge to acknowledge().
+ *
+ * A field is sent only if it has changed since the last state that client
+ * acknowledged for that object.  Objects are packed in order of priority,
+ * accumulated over the ticks they have waited, until the packet is full.
+ * Objects with a priority of 0 are removed from that client until it rises
+ * again.
+ *
+ * How packets and acknowledgements get there is up to the caller.  They
+ * may be lost, duplicated or reordered.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+/**
+ * \class Zeni::Replication_Client
+ *
+ * \ingroup zenilib
+ *
+ * \brief The receiving end of a Replication_Server
+ *
+ * read() applies a packet written by Replication_Server::write, creating
+ * and destroying objects through the Factory as needed, and returns the
+ * sequence number to acknowledge.  Packets older than one already read are
+ * ignored, and read() returns 0 for them so that nothing is acknowledged.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_REPLICATION_H
+#define ZENI_REPLICATION_H
+
+#include <Zeni/VLUID.h>
+
+/* \cond */
+#include <map>
+#include <vector>
+/* \endcond */
+
+namespace Zeni {
+
+  class ZENI_NET_DLL Replicated {
+  public:
+    virtual ~Replicated() {}
+
+    virtual Uint16 get_type() const = 0; ///< Passed to Replication_Client::Factory::create
+    virtual Uint16 get_num_fields() const = 0;
+
+    virtual void serialize_field(Byte_Writer &writer, const Uint16 &field) const = 0;
+    virtual void unserialize_field(Byte_Reader &reader, const Uint16 &field) = 0;
+
+    /// How much the client needs this object, relative to others; 0 if not at all
+    virtual float get_priority(const IPaddress &client) const;
+  };
+
+  class ZENI_NET_DLL Replication_Server {
+    Replication_Server(const Replication_Server &);
+    Replication_Server & operator=(const Replication_Server &);
+
+  public:
+    Replication_Server();
+    ~Replication_Server();
+
+    VLUID add(Replicated &object); ///< Start replicating an object, which must outlive its removal
+    void remove(const VLUID &id);
+
+    void add_client(const IPaddress &client);
+    void remove_client(const IPaddress &client);
+
+    void update(); ///< Begin a new tick, noting every field that has changed since the last
+
+    /// Write as much as fits for a client, returning the sequence number the client will acknowledge
+    Uint32 write(const IPaddress &client, Byte_Writer &packet);
+    void acknowledge(const IPaddress &client, const Uint32 &sequence);
+
+    const Uint32 & get_tick() const {return m_tick;}
+    size_t size() const {return m_objects.size() - m_free.size();} ///< Get the number of objects being replicated
+
+  private:
+    struct Object {
+      Object();
+
+      Replicated * object; ///< 0 if unused
+      Uint32 serial; ///< Distinguishes the objects that have used this slot
+      VLUID id;
+      Uint32 last_changed; ///< The latest of changed
+      std::vector<Uint32> changed; ///< The tick each field last changed
+      std::vector<Uint32> offsets; ///< Where each field starts in state, with the end last
+      std::vector<char> state; ///< Every field, as of the last update()
+    };
+
+    struct Client;
+
+    void snapshot(Object &object); ///< Serialize every field, noting those that have changed
+
+    Uint32 m_tick;
+    Uint32 m_serial;
+    VLUID m_next_id;
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::vector<Object> m_objects;
+    std::vector<size_t> m_free; ///< Indices of unused Objects
+    std::map<IPaddress, Client *> m_clients;
+    std::vector<char> m_scratch; ///< One object's fields at a time, for update()
+    std::vector<Uint32> m_scratch_offsets;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  };
+
+  class ZENI_NET_DLL Replication_Client {
+    Replication_Client(const Replication_Client &);
+    Replication_Client & operator=(const Replication_Client &);
+
+  public:
+    class ZENI_NET_DLL Factory {
+    public:
+      virtual ~Factory() {}
+
+      virtual Replicated * create(const Uint16 &type) = 0; ///< Return 0 for unknown types
+      virtual void destroy(Replicated * const &object);
+    };
+
+    Replication_Client(Factory &factory);
+    ~Replication_Client();
+
+    /// Apply a packet, returning the sequence number to acknowledge, or 0 for a stale one; Throws Replication_Corrupt if it cannot be read
+    Uint32 read(Byte_Reader &packet);
+
+    Replicated * get(const VLUID &id) const; ///< Returns 0 if the object is not replicated here
+    size_t size() const {return m_objects.size();}
+    const Uint32 & get_tick() const {return m_tick;} ///< Get the tick of the latest packet read
+
+  private:
+    Factory * m_factory;
+    Uint32 m_tick;
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::map<VLUID, Replicated *> m_objects;
+    std::vector<Uint16> m_fields; ///< Those sent for the object being read
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  };
+
+  struct ZENI_NET_DLL Replication_Corrupt : public Error {
+    Replication_Corrupt() : Error("Zeni Replication Packet Corrupt") {}
+  };
+
+}
+
+#endif
@@ -0,0 +1,178 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::UDP_Channel
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Reliable Connection to One Peer over UDP
+ *
+ * Every message sent on a UDP_Channel arrives exactly once.  Messages sent
+ * ORDERED arrive in the order they were sent, while UNORDERED messages are
+ * delivered as soon as they arrive, so a lost packet holds up only the
+ * ORDERED messages behind it rather than everything, as it would over TCP.
+ *
+ * Each packet carries a sequence number and acknowledges the latest packet
+ * received along with the 32 before it.  A packet is resent once one sent
+ * after it has been acknowledged and a quarter of a round trip has passed
+ * to allow for reordering, or once the retransmission timeout expires.
+ * Round trip times measured from the acknowledgements set that timeout,
+ * which doubles each time it expires.  A congestion window limits the
+ * packets in flight, growing as they are acknowledged and shrinking by 30%
+ * at most once per round trip when they are lost.  Messages are numbered
+ * in 16 bits, so no more than 32768 are sent past the oldest one not yet
+ * acknowledged; The rest wait their turn.
+ *
+ * update() does all of the sending and receiving, so call it every frame.
+ * A UDP_Channel constructed without a peer adopts the first one it hears
+ * from.  If the peer acknowledges nothing for the timeout while messages
+ * are waiting, update() throws Socket_Closed.
+ *
+ * \note Messages must fit in a single packet; Use Split_UDP_Socket for larger ones.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_UDP_CHANNEL_H
+#define ZENI_UDP_CHANNEL_H
+
+#include <Zeni/Net.h>
+
+/* \cond */
+#include <list>
+#include <map>
+#include <vector>
+/* \endcond */
+
+namespace Zeni {
+
+  class ZENI_NET_DLL UDP_Channel {
+    UDP_Channel(const UDP_Channel &);
+    UDP_Channel & operator=(const UDP_Channel &);
+
+  public:
+    enum Order {ORDERED, UNORDERED};
+
+    /// Packets are at most packet_size bytes; timeout is in milliseconds
+    UDP_Channel(const Uint16 &port, const IPaddress &peer, const Uint16 &packet_size = 1200u, const Uint32 &timeout = 10000u);
+    UDP_Channel(const Uint16 &port, const Uint16 &packet_size = 1200u, const Uint32 &timeout = 10000u); ///< Adopt the first peer heard from
+
+    const IPaddress & get_peer() const {return m_peer;}
+    bool has_peer() const {return m_has_peer;}
+
+    /// Queue a message; Throws UDP_Packet_Overflow if it will not fit in a packet
+    void send(const void * const &data, const Uint16 &num_bytes, const Order &order = ORDERED);
+    void send(const String &data, const Order &order = ORDERED);
+
+    /// Take the next message to have arrived, returning false if there is none
+    bool receive(String &data);
+
+    /// Receive packets, acknowledge them, and send or resend what the congestion window allows
+    void update();
+
+    // Connection statistics
+    float get_rtt() const {return m_srtt;} ///< Smoothed round trip time in milliseconds
+    Uint32 get_rto() const {return m_rto;} ///< Retransmission timeout in milliseconds
+    float get_congestion_window() const {return m_cwnd;} ///< Packets allowed in flight
+    float get_send_rate() const; ///< Bytes per second the congestion window allows at the current round trip time
+    size_t get_num_unacknowledged() const {return m_unacked.size();} ///< Messages sent or queued but not yet acknowledged
+    size_t get_num_retransmissions() const {return m_retransmissions;}
+
+  private:
+    struct Outgoing {
+      String data;
+      Uint16 order;
+      bool ordered;
+      bool queued;
+    };
+
+    struct Sent_Packet {
+      Sent_Packet() : sequence(0u), time(0u), in_flight(false) {}
+
+      Uint16 sequence;
+      Uint32 time;
+      bool in_flight;
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+      std::vector<Uint32> messages;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+    };
+
+    void init();
+
+    void receive_packet(const char * const &packet, const size_t &packet_size, const Uint32 &now);
+    void acknowledge(const Uint16 &sequence, const Uint32 &now);
+    void deliver(const Uint16 &id, const bool &ordered, const Uint16 &order, const char * const &data, const Uint16 &num_bytes);
+    void detect_losses(const Uint32 &now);
+    void send_packets(const Uint32 &now);
+
+    UDP_Socket m_socket;
+    IPaddress m_peer;
+    bool m_has_peer;
+    Uint16 m_packet_size;
+    Uint32 m_timeout;
+    Uint32 m_last_heard;
+
+    // Sending
+    Uint16 m_sequence;
+    Uint32 m_next_id;
+    Uint16 m_next_order;
+    size_t m_in_flight;
+    float m_srtt;
+    float m_rttvar;
+    Uint32 m_rto;
+    float m_cwnd;
+    float m_ssthresh;
+    Uint32 m_reduction_time; ///< When m_cwnd was last reduced; Later losses within the round trip don't count again
+    bool m_has_acked;
+    Uint32 m_acked_time; ///< When the most recently sent packet that was acknowledged was sent
+    Uint16 m_acked_sequence; ///< And its sequence
+    size_t m_retransmissions;
+
+    // Receiving
+    bool m_has_remote_sequence;
+    Uint16 m_remote_sequence;
+    Uint32 m_ack_bits;
+    bool m_ack_pending;
+    Uint32 m_next_delivery; ///< Unwrapped order of the next ORDERED message to deliver
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::map<Uint32, Outgoing> m_unacked; ///< By id
+    std::list<Uint32> m_queue; ///< Ids waiting to be sent, resends first
+    std::vector<Sent_Packet> m_sent; ///< By sequence modulo its size
+    std::vector<Uint32> m_received_ids; ///< One bit per 16-bit message id
+    std::map<Uint32, String> m_held; ///< ORDERED messages waiting on earlier ones, by unwrapped order
+    std::list<String> m_delivered;
+    std::vector<char> m_packet;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  };
+
+}
+
+#endif
@@ -33,6 +33,7 @@
 #ifndef ZENI_VLUID_H
 #define ZENI_VLUID_H
 
+#include <Zeni/Byte_Writer.h>
 #include <Zeni/Error.h>
 #include <Zeni/Serialization.h>
 
@@ -64,6 +65,9 @@ namespace Zeni {
     virtual std::ostream & serialize(std::ostream &os) const;
     virtual std::istream & unserialize(std::istream &is);
     
+    Byte_Writer & serialize(Byte_Writer &writer) const;
+    Byte_Reader & unserialize(Byte_Reader &reader);
+    
   private:
 #ifdef _WINDOWS
 #pragma warning( push )
@@ -76,78 +80,9 @@ namespace Zeni {
   };
 
   typedef VLUID Nonce;
-  
-  /*** VLUID Based Datatypes ***/
-
-  //template <typename TYPE>
-  //class Net_Datum {
-  //public:
-  //  Net_Datum(const TYPE &rhs = TYPE()) : m_datum(rhs) {}
-  //  Net_Datum(const VLUID &sauid, const TYPE &rhs = TYPE()) : m_sauid(sauid), m_datum(rhs) {}
-
-  //  /**  This recv function assumes that
-  //    *    -the size has already been read in
-  //    *    -sauid has already been read in
-  //    *    -sauid has been verified to correspond to this Net_Datum
-  //    **/
-  //  virtual std::istream & recv(std::istream &is) = 0;
-  //  
-  //  virtual std::ostream & send(std::ostream &os) const = 0;
-  //  
-  //  operator const TYPE & () const {return this->m_datum;}
-  //  operator TYPE & () {return this->m_datum;}
-  //  
-  //protected:
-  //  VLUID m_sauid; // server assigned unique identifier
-  //  
-  //  VLUID m_nonce; // so old packets don't supercede newer ones
-  //  
-  //  TYPE m_datum;
-  //};
-
-  //template <typename TYPE>
-  //class Local_Datum : public Net_Datum<TYPE> {
-  //public:
-  //  Local_Datum(const TYPE &rhs = TYPE()) : Net_Datum<TYPE>(rhs) {}
-  //  Local_Datum(const VLUID &sauid, const TYPE &rhs = TYPE()) : Net_Datum<TYPE>(sauid, rhs) {}
-
-  //  virtual std::istream & recv(std::istream &is) {return is;}
-  //  
-  //  virtual std::ostream & send(std::ostream &os) const {
-  //    std::ostringstream oss;
-  //    oss << this->m_sauid << this->m_nonce << this->m_datum;
-  //    const String &str = oss.str();
-  //    Uint16 size = str.size();
-  //    return serialize(os, size) << str;
-  //  }
-  //};
-
-  //template <typename TYPE>
-  //class Remote_Datum : public Net_Datum<TYPE> {
-  //public:
-  //  Remote_Datum(const TYPE &rhs = TYPE()) : Net_Datum<TYPE>(rhs) {}
-  //  Remote_Datum(const VLUID &sauid, const TYPE &rhs = TYPE()) : Net_Datum<TYPE>(sauid, rhs) {}
 
-  //  /**  This recv function assumes that
-  //    *    -the size has already been read in
-  //    *    -sauid has already been read in
-  //    *    -sauid has been verified to correspond to this Net_Datum
-  //    **/
-  //  virtual std::istream & recv(std::istream &is) {
-  //    VLUID nonce(is);
-  //    
-  //    if(this->m_nonce > nonce) {
-  //      TYPE datum;
-  //      is >> datum;
-  //    }
-  //    else
-  //      is >> this->m_datum;
-  //    
-  //    return is;
-  //  }
-  //  
-  //  virtual std::ostream & send(std::ostream &os) const {return os;}
-  //};
+  inline Byte_Writer & serialize(Byte_Writer &writer, const VLUID &value) {return value.serialize(writer);}
+  inline Byte_Reader & unserialize(Byte_Reader &reader, VLUID &value) {return value.unserialize(reader);}
 
 }
 
@@ -15,10 +15,10 @@ project "zeni_net"
 
   configuration "*"
     flags { "ExtraWarnings" }
-    includedirs { ".", "../zeni_core", "../zeni", "../../sdl_net", "../../sdl", "../../tinyxml" }
+    includedirs { ".", "../zeni_core", "../zeni", "../../sdl_net", "../../sdl", "../../tinyxml", "../../zlib" }
 
 --     pchheader "jni/external/zenilib/zeni_net/zeni_net.h"
 --     pchsource "jni/external/zenilib/zeni_net/Net.cpp"
 
     files { "**.h", "**.hxx", "**.cpp" }
-    links { "zeni_core", "zeni", "local_SDL_net", "local_SDL" }
+    links { "zeni_core", "zeni", "local_SDL_net", "local_SDL", "local_z" }
@@ -18,4 +18,11 @@
 #include <zeni_net.h>
 
 #include "Zeni/Net.cpp"
+#include "Zeni/Net_Async.cpp"
+#include "Zeni/Net_Benchmark.cpp"
+#include "Zeni/Net_Compressor.cpp"
+#include "Zeni/Net_Poller.cpp"
+#include "Zeni/Net_Thread.cpp"
+#include "Zeni/Replication.cpp"
+#include "Zeni/UDP_Channel.cpp"
 #include "Zeni/VLUID.cpp"
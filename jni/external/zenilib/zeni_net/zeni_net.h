@@ -28,6 +28,13 @@
 #include <zeni_core.h>
 
 #include <Zeni/Net.h>
+#include <Zeni/Net_Async.h>
+#include <Zeni/Net_Benchmark.h>
+#include <Zeni/Net_Compressor.h>
+#include <Zeni/Net_Poller.h>
+#include <Zeni/Net_Thread.h>
+#include <Zeni/Replication.h>
+#include <Zeni/UDP_Channel.h>
 #include <Zeni/VLUID.h>
 
 #endif
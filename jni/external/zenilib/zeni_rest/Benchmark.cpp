@@ -0,0 +1,249 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_rest.h>
+
+#ifndef ANDROID
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+#if defined(_DEBUG) && defined(_WINDOWS)
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+
+namespace Zeni {
+
+  Benchmark::Statistics::Statistics()
+    : total(0.0),
+    mean(0.0),
+    min(0.0),
+    p50(0.0),
+    p90(0.0),
+    p99(0.0),
+    max(0.0)
+  {
+  }
+
+  Benchmark::Statistics::Statistics(std::vector<double> seconds)
+    : total(0.0),
+    mean(0.0),
+    min(0.0),
+    p50(0.0),
+    p90(0.0),
+    p99(0.0),
+    max(0.0)
+  {
+    if(seconds.empty())
+      return;
+
+    for(std::vector<double>::const_iterator it = seconds.begin(); it != seconds.end(); ++it)
+      total += *it;
+
+    // Nearest-rank percentiles, as in Game
+    std::sort(seconds.begin(), seconds.end());
+    const size_t count = seconds.size();
+    mean = total / count;
+    min = seconds[0];
+    p50 = seconds[(count * 50u + 99u) / 100u - 1u];
+    p90 = seconds[(count * 90u + 99u) / 100u - 1u];
+    p99 = seconds[(count * 99u + 99u) / 100u - 1u];
+    max = seconds[count - 1u];
+  }
+
+  Benchmark::Benchmark(const size_t &frames, const double &time_step)
+    : m_frames(frames),
+    m_time_step(time_step),
+    m_render(false)
+  {
+  }
+
+  void Benchmark::add_event(const size_t &frame, const SDL_Event &event) {
+    m_input.add_event(frame, event);
+  }
+
+  void Benchmark::load_script(const String &filename) {
+    std::ifstream script(filename.c_str());
+    if(!script)
+      throw Benchmark_Script_Error("Benchmark script '" + filename + "' could not be opened");
+
+    std::string line;
+    for(size_t line_number = 1u; std::getline(script, line); ++line_number) {
+      const std::string::size_type comment = line.find('#');
+      if(comment != std::string::npos)
+        line.erase(comment);
+
+      std::istringstream iss(line);
+      size_t frame;
+      std::string type;
+      if(!(iss >> frame))
+        continue;
+
+      SDL_Event event;
+      memset(&event, 0, sizeof(event));
+      event.common.timestamp = Uint32(frame * m_time_step * 1000.0);
+
+      bool valid = bool(iss >> type);
+
+      if(type == "key_down" || type == "key_up") {
+        std::string name;
+        valid = valid && bool(iss >> name);
+
+        const SDL_Keycode key = valid ? SDL_GetKeyFromName(name.c_str()) : SDLK_UNKNOWN;
+        valid = valid && key != SDLK_UNKNOWN;
+
+        event.type = type == "key_down" ? SDL_KEYDOWN : SDL_KEYUP;
+        event.key.state = Uint8(type == "key_down" ? SDL_PRESSED : SDL_RELEASED);
+        event.key.keysym.sym = key;
+        event.key.keysym.scancode = SDL_GetScancodeFromKey(key);
+      }
+      else if(type == "mouse_motion") {
+        event.type = SDL_MOUSEMOTION;
+        valid = valid && bool(iss >> event.motion.x >> event.motion.y);
+        if(!(iss >> event.motion.xrel >> event.motion.yrel))
+          event.motion.xrel = event.motion.yrel = 0;
+      }
+      else if(type == "mouse_button_down" || type == "mouse_button_up") {
+        int button;
+        valid = valid && bool(iss >> button >> event.button.x >> event.button.y);
+
+        event.type = type == "mouse_button_down" ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+        event.button.state = Uint8(type == "mouse_button_down" ? SDL_PRESSED : SDL_RELEASED);
+        event.button.button = Uint8(button);
+      }
+      else if(type == "mouse_wheel") {
+        event.type = SDL_MOUSEWHEEL;
+        valid = valid && bool(iss >> event.wheel.x >> event.wheel.y);
+      }
+      else if(type == "quit")
+        event.type = SDL_QUIT;
+      else
+        valid = false;
+
+      if(!valid) {
+        std::ostringstream oss;
+        oss << "Benchmark script '" << filename.std_str() << "' line " << line_number << " is invalid";
+        throw Benchmark_Script_Error(oss.str().c_str());
+      }
+
+      add_event(frame, event);
+    }
+  }
+
+  void Benchmark::load_recording(const String &filename) {
+    Input_Recording recording;
+    recording.load(filename);
+
+    const std::vector<Input_Recording::Recorded_Event> &events = recording.get_events();
+    for(std::vector<Input_Recording::Recorded_Event>::const_iterator it = events.begin(); it != events.end(); ++it)
+      m_input.add_event(it->frame, it->event);
+
+    for(size_t frame = m_input.get_num_frames(); frame < recording.get_num_frames(); ++frame)
+      m_input.add_frame(recording.get_time_step(frame));
+
+    m_frames = m_input.get_num_frames();
+  }
+
+  void Benchmark::run() {
+    Game &gr = get_Game();
+    Timer_HQ &thq = get_Timer_HQ();
+
+    const std::vector<Input_Recording::Recorded_Event> &events = m_input.get_events();
+    std::vector<Input_Recording::Recorded_Event>::const_iterator next_event = events.begin();
+
+    m_frame_times.clear();
+    m_logic_times.clear();
+    m_render_times.clear();
+    m_frame_times.reserve(m_frames);
+    m_logic_times.reserve(m_frames);
+    m_render_times.reserve(m_frames);
+
+    try {
+      for(size_t frame = 0u; frame != m_frames; ++frame) {
+        const Time_HQ frame_start = thq.get_time();
+
+        for(; next_event != events.end() && next_event->frame <= frame; ++next_event) {
+          gr.on_event(next_event->event);
+
+          if(next_event->event.type == SDL_QUIT)
+            throw Quit_Event();
+        }
+
+        // Recorded time steps stand in for the clock, as does get_time_step() past their end
+        gr.step_logic(frame < m_input.get_num_frames() ? m_input.get_time_step(frame) : m_time_step);
+
+        if(Job_System::is_initialized())
+          get_Job_System().run_main_thread_jobs();
+
+        const Time_HQ logic_end = thq.get_time();
+
+        if(m_render)
+          gr.render_frame();
+
+        const Time_HQ frame_end = thq.get_time();
+
+        m_logic_times.push_back(double(logic_end.get_seconds_since(frame_start)));
+        m_render_times.push_back(double(frame_end.get_seconds_since(logic_end)));
+        m_frame_times.push_back(double(frame_end.get_seconds_since(frame_start)));
+
+        gr.end_frame();
+      }
+    }
+    catch(Quit_Event &) {
+    }
+  }
+
+  static void write_json_Statistics(std::ostream &os, const char * const name, const Benchmark::Statistics &statistics) {
+    os << "  \"" << name << "\": {"
+       << "\"total\": " << statistics.total
+       << ", \"mean\": " << statistics.mean
+       << ", \"min\": " << statistics.min
+       << ", \"p50\": " << statistics.p50
+       << ", \"p90\": " << statistics.p90
+       << ", \"p99\": " << statistics.p99
+       << ", \"max\": " << statistics.max << "},\n";
+  }
+
+  void Benchmark::write_json(std::ostream &os) const {
+    const std::streamsize precision = os.precision(9);
+
+    os << "{\n"
+       << "  \"frames\": " << m_frames << ",\n"
+       << "  \"frames_run\": " << get_frames_run() << ",\n"
+       << "  \"time_step\": " << m_time_step << ",\n"
+       << "  \"rendering\": " << (m_render ? "true" : "false") << ",\n";
+
+    write_json_Statistics(os, "frame", get_frame_statistics());
+    write_json_Statistics(os, "logic", get_logic_statistics());
+    write_json_Statistics(os, "render", get_render_statistics());
+
+    os << "  \"frame_times\": [";
+    for(std::vector<double>::const_iterator it = m_frame_times.begin(); it != m_frame_times.end(); ++it)
+      os << (it == m_frame_times.begin() ? "" : ", ") << *it;
+    os << "]\n}\n";
+
+    os.precision(precision);
+  }
+
+}
+
+#endif
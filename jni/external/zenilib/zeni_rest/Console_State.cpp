@@ -17,6 +17,20 @@
 
 #include <zeni_rest.h>
 
+#ifdef ENABLE_BENCHMARKS
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#endif
+
+#if defined(ENABLE_COLLISION_STATISTICS) || defined(ENABLE_PROFILER)
+#include <fstream>
+#endif
+
+#include <Zeni/Define.h>
+
 #if defined(_DEBUG) && defined(_WINDOWS)
 #define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
 #define new DEBUG_NEW
@@ -24,6 +38,499 @@
 
 namespace Zeni {
 
+#ifdef ENABLE_BENCHMARKS
+  /// 'allocation_statistics' logs the last frame's Allocation_Statistics
+  struct Console_Allocation_Statistics : public Console_Function {
+    void operator()(Console_State &console,
+                    const String &,
+                    const std::vector<String> &)
+    {
+      console.write_to_log(Allocation_Statistics::get_last_frame().to_string());
+    }
+  };
+
+  struct Console_Job_Scaling_Work {
+    Console_Job_Scaling_Work(std::vector<float> &results_) : results(results_) {}
+
+    void operator()(const size_t &begin, const size_t &end) {
+      for(size_t i = begin; i != end; ++i) {
+        float x = float(i);
+        for(int j = 0; j != 64; ++j)
+          x = std::sqrt(x + 1.0f);
+        results[i] = x;
+      }
+    }
+
+    std::vector<float> &results;
+  };
+
+  /// 'job_scaling' times Job_System::parallel_for with 1 to N threads; The Job_System is restarted for each, and restored afterward
+  struct Console_Job_Scaling : public Console_Function {
+    void operator()(Console_State &console,
+                    const String &,
+                    const std::vector<String> &)
+    {
+      const bool initialized = Job_System::is_initialized();
+      const size_t num_workers = Job_System::get_preinit_num_workers();
+      const size_t max_threads = get_Job_System().get_num_threads();
+      const int repetitions = 8;
+
+      std::vector<float> results(1u << 18);
+      Console_Job_Scaling_Work work(results);
+      double baseline = 0.0;
+
+      for(size_t threads = 1u; threads <= max_threads; ++threads) {
+        Job_System::destroy();
+        Job_System::preinit_num_workers(threads - 1u);
+        Job_System &js = get_Job_System();
+
+        // Warm up the workers before timing them
+        js.parallel_for(0u, results.size(), work, 256u);
+
+        const Time_HQ start = get_Timer_HQ().get_time();
+        for(int i = 0; i != repetitions; ++i)
+          js.parallel_for(0u, results.size(), work, 256u);
+        const double seconds = double(get_Timer_HQ().get_time().get_seconds_since(start)) / repetitions;
+
+        if(threads == 1u)
+          baseline = seconds;
+
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(3) << threads << " threads: "
+            << 1000.0 * seconds << " ms, " << baseline / seconds << "x";
+        console.write_to_log(oss.str().c_str());
+      }
+
+      Job_System::destroy();
+      Job_System::preinit_num_workers(num_workers);
+      if(initialized)
+        get_Job_System();
+    }
+  };
+
+  struct Console_Event_Benchmark_Handler : public Event::Handler {
+    Console_Event_Benchmark_Handler(size_t &calls_) : calls(calls_) {}
+
+    void operator()() {
+      ++calls;
+    }
+
+    Console_Event_Benchmark_Handler * duplicate() const {
+      return new Console_Event_Benchmark_Handler(calls);
+    }
+
+    size_t &calls;
+  };
+
+  /// 'event_benchmark' times Event::fire with 1, 10 and 100 Handlers
+  struct Console_Event_Benchmark : public Console_Function {
+    void operator()(Console_State &console,
+                    const String &,
+                    const std::vector<String> &)
+    {
+      const size_t handler_counts[] = {1u, 10u, 100u};
+      const size_t calls_per_run = 1u << 20;
+
+      for(int i = 0; i != 3; ++i) {
+        const size_t handlers = handler_counts[i];
+        const size_t repetitions = calls_per_run / handlers;
+
+        size_t calls = 0u;
+        Event event;
+        for(size_t j = 0u; j != handlers; ++j)
+          event.give_Handler(new Console_Event_Benchmark_Handler(calls));
+
+        const Time_HQ start = get_Timer_HQ().get_time();
+        for(size_t j = 0u; j != repetitions; ++j)
+          event.fire();
+        const double seconds = double(get_Timer_HQ().get_time().get_seconds_since(start));
+
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << handlers << " handlers: "
+            << 1000000000.0 * seconds / repetitions << " ns per fire, "
+            << 1000000000.0 * seconds / calls << " ns per call";
+        console.write_to_log(oss.str().c_str());
+      }
+    }
+  };
+
+  struct Console_Serialization_Benchmark_Record {
+    Console_Serialization_Benchmark_Record() : id(0u), team(0), health(0.0f), time(0.0) {}
+
+    Uint32 id;
+    Sint16 team;
+    float health;
+    double time;
+    String name;
+    std::vector<Uint16> items;
+  };
+
+  /// 'serialization_benchmark' times the std::stream and Byte_Writer/Byte_Reader paths on the same records
+  struct Console_Serialization_Benchmark : public Console_Function {
+    void operator()(Console_State &console,
+                    const String &,
+                    const std::vector<String> &)
+    {
+      const size_t records = 1u << 18;
+
+      Console_Serialization_Benchmark_Record record, result;
+      record.id = 0xDEADBEEFu;
+      record.team = -3;
+      record.health = 87.5f;
+      record.time = 1234.5678;
+      record.name = "serialization_benchmark";
+      for(Uint16 i = 0u; i != 8u; ++i)
+        record.items.push_back(Uint16(i * 1000u));
+
+      std::string stream_bytes;
+
+      Time_HQ start = get_Timer_HQ().get_time();
+      for(size_t i = 0u; i != records; ++i) {
+        std::ostringstream os;
+        serialize(os, record.id);
+        serialize(os, record.team);
+        serialize(os, record.health);
+        serialize(os, record.time);
+        serialize(os, record.name);
+        serialize(os, record.items);
+        if(!i)
+          stream_bytes = os.str();
+      }
+      const double stream_write = double(get_Timer_HQ().get_time().get_seconds_since(start));
+
+      start = get_Timer_HQ().get_time();
+      for(size_t i = 0u; i != records; ++i) {
+        std::istringstream is(stream_bytes);
+        unserialize(is, result.id);
+        unserialize(is, result.team);
+        unserialize(is, result.health);
+        unserialize(is, result.time);
+        unserialize(is, result.name);
+        unserialize(is, result.items);
+      }
+      const double stream_read = double(get_Timer_HQ().get_time().get_seconds_since(start));
+
+      char buffer[256];
+      size_t buffer_size = 0u;
+
+      start = get_Timer_HQ().get_time();
+      for(size_t i = 0u; i != records; ++i) {
+        Byte_Writer writer(buffer, sizeof(buffer));
+        serialize(writer, record.id);
+        serialize(writer, record.team);
+        serialize(writer, record.health);
+        serialize(writer, record.time);
+        serialize(writer, record.name);
+        serialize(writer, record.items);
+        buffer_size = writer.size();
+      }
+      const double byte_write = double(get_Timer_HQ().get_time().get_seconds_since(start));
+
+      bool matched = true;
+      start = get_Timer_HQ().get_time();
+      for(size_t i = 0u; i != records; ++i) {
+        Byte_Reader reader(buffer, buffer_size);
+        unserialize(reader, result.id);
+        unserialize(reader, result.team);
+        unserialize(reader, result.health);
+        unserialize(reader, result.time);
+        unserialize(reader, result.name);
+        unserialize(reader, result.items);
+        matched &= reader.good();
+      }
+      const double byte_read = double(get_Timer_HQ().get_time().get_seconds_since(start));
+
+      matched &= stream_bytes.size() == buffer_size && !memcmp(stream_bytes.data(), buffer, buffer_size) &&
+                 result.id == record.id && result.team == record.team && result.health == record.health &&
+                 result.time == record.time && result.name == record.name && result.items == record.items;
+
+      std::ostringstream oss;
+      oss << std::fixed << std::setprecision(1) << buffer_size << " byte records"
+          << (matched ? ", identical bytes" : ", MISMATCHED bytes")
+          << "\nstream: " << 1000000000.0 * stream_write / records << " ns per write, "
+          << 1000000000.0 * stream_read / records << " ns per read"
+          << "\nByte_Writer/Byte_Reader: " << 1000000000.0 * byte_write / records << " ns per write, "
+          << 1000000000.0 * byte_read / records << " ns per read";
+      console.write_to_log(oss.str().c_str());
+    }
+  };
+
+  /// 'matrix_benchmark' times the Matrix4f kernels against scalar versions written out below and checks that they agree
+  struct Console_Matrix_Benchmark : public Console_Function {
+    static Matrix4f multiply(const Matrix4f &lhs, const Matrix4f &rhs) {
+      Matrix4f matrix;
+      for(int i = 0; i < 4; ++i)
+        for(int j = 0; j < 4; ++j)
+          matrix[i][j] = lhs[i][0] * rhs[0][j] + lhs[i][1] * rhs[1][j] + lhs[i][2] * rhs[2][j] + lhs[i][3] * rhs[3][j];
+      return matrix;
+    }
+
+    static Matrix4f transpose(const Matrix4f &rhs) {
+      Matrix4f matrix;
+      for(int i = 0; i < 4; ++i)
+        for(int j = 0; j < 4; ++j)
+          matrix[i][j] = rhs[j][i];
+      return matrix;
+    }
+
+    /// Cofactor expansion by 2x2 minors
+    static Matrix4f invert(const Matrix4f &m) {
+      const float s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+      const float s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+      const float s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+      const float s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+      const float s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+      const float s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+      const float c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+      const float c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+      const float c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+      const float c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+      const float c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+      const float c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+      const float r = 1.0f / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+      return Matrix4f(
+        ( m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3) * r, (-m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3) * r,
+        ( m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3) * r, (-m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3) * r,
+        (-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1) * r, ( m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1) * r,
+        (-m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1) * r, ( m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1) * r,
+        ( m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0) * r, (-m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0) * r,
+        ( m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0) * r, (-m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0) * r,
+        (-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0) * r, ( m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0) * r,
+        (-m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0) * r, ( m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0) * r);
+    }
+
+    /// Largest difference between two entries, relative to the entry when it exceeds 1
+    static float error(const float &lhs, const float &rhs) {
+      return float(fabs(lhs - rhs)) / std::max(1.0f, float(fabs(rhs)));
+    }
+
+    static float error(const Matrix4f &lhs, const Matrix4f &rhs) {
+      float worst = 0.0f;
+      for(int i = 0; i < 4; ++i)
+        for(int j = 0; j < 4; ++j)
+          worst = std::max(worst, error(lhs[i][j], rhs[i][j]));
+      return worst;
+    }
+
+    void operator()(Console_State &console,
+                    const String &,
+                    const std::vector<String> &)
+    {
+      const size_t count = 256u;
+      const size_t repetitions = 1u << 12;
+      const size_t operations = count * repetitions;
+
+      // Diagonally dominant, so every matrix is comfortably invertible
+      Random random(0x5EEDu);
+      std::vector<Matrix4f> lhs(count), rhs(count), simd(count), scalar(count);
+      std::vector<Point3f> points(count), simd_points(count), scalar_points(count);
+      for(size_t n = 0u; n != count; ++n) {
+        for(int i = 0; i < 4; ++i)
+          for(int j = 0; j < 4; ++j) {
+            lhs[n][i][j] = 2.0f * random.frand_lt() - 1.0f + (i == j ? 4.0f : 0.0f);
+            rhs[n][i][j] = 2.0f * random.frand_lt() - 1.0f + (i == j ? 4.0f : 0.0f);
+          }
+        points[n] = Point3f(100.0f * random.frand_lt() - 50.0f, 100.0f * random.frand_lt() - 50.0f, 100.0f * random.frand_lt() - 50.0f);
+      }
+
+      const char * const names[] = {"multiply", "invert", "transpose", "transform_points"};
+      double simd_seconds[4], scalar_seconds[4];
+      float errors[4];
+
+      for(int op = 0; op != 4; ++op) {
+        Time_HQ start = get_Timer_HQ().get_time();
+        for(size_t r = 0u; r != repetitions; ++r) {
+          switch(op) {
+            case 0: for(size_t n = 0u; n != count; ++n) simd[n] = lhs[n] * rhs[n]; break;
+            case 1: for(size_t n = 0u; n != count; ++n) simd[n] = lhs[n].inverted(); break;
+            case 2: for(size_t n = 0u; n != count; ++n) simd[n] = lhs[n].transposed(); break;
+            default: lhs[r % count].transform_points(&simd_points[0], &points[0], count); break;
+          }
+        }
+        simd_seconds[op] = double(get_Timer_HQ().get_time().get_seconds_since(start));
+
+        start = get_Timer_HQ().get_time();
+        for(size_t r = 0u; r != repetitions; ++r) {
+          switch(op) {
+            case 0: for(size_t n = 0u; n != count; ++n) scalar[n] = multiply(lhs[n], rhs[n]); break;
+            case 1: for(size_t n = 0u; n != count; ++n) scalar[n] = invert(lhs[n]); break;
+            case 2: for(size_t n = 0u; n != count; ++n) scalar[n] = transpose(lhs[n]); break;
+            default:
+            {
+              const Matrix4f &matrix = lhs[r % count];
+              for(size_t n = 0u; n != count; ++n) {
+                const Point3f &p = points[n];
+                scalar_points[n] = Point3f(matrix[0][0] * p.x + matrix[0][1] * p.y + matrix[0][2] * p.z + matrix[0][3],
+                                           matrix[1][0] * p.x + matrix[1][1] * p.y + matrix[1][2] * p.z + matrix[1][3],
+                                           matrix[2][0] * p.x + matrix[2][1] * p.y + matrix[2][2] * p.z + matrix[2][3]);
+              }
+              break;
+            }
+          }
+        }
+        scalar_seconds[op] = double(get_Timer_HQ().get_time().get_seconds_since(start));
+
+        errors[op] = 0.0f;
+        for(size_t n = 0u; n != count; ++n) {
+          if(op == 3) {
+            errors[op] = std::max(errors[op], error(simd_points[n].x, scalar_points[n].x));
+            errors[op] = std::max(errors[op], error(simd_points[n].y, scalar_points[n].y));
+            errors[op] = std::max(errors[op], error(simd_points[n].z, scalar_points[n].z));
+          }
+          else
+            errors[op] = std::max(errors[op], error(simd[n], scalar[n]));
+        }
+      }
+
+      std::ostringstream oss;
+      oss << std::fixed << operations << " operations each"
+#if defined(ZENI_SIMD_SSE)
+          << ", SSE";
+#elif defined(ZENI_SIMD_NEON)
+          << ", NEON";
+#else
+          << ", no SIMD";
+#endif
+      for(int op = 0; op != 4; ++op)
+        oss << '\n' << names[op] << ": " << std::fixed << std::setprecision(1)
+            << 1000000000.0 * simd_seconds[op] / operations << " ns vs "
+            << 1000000000.0 * scalar_seconds[op] / operations << " ns scalar, "
+            << (errors[op] < 0.0001f ? "matching" : "MISMATCHED") << " (" << std::scientific << std::setprecision(2) << errors[op] << ')';
+      console.write_to_log(oss.str().c_str());
+    }
+  };
+
+  class Console_Input_Benchmark_State : public Gamestate_II {
+  public:
+    Console_Input_Benchmark_State() : actions(0u) {}
+
+    using Gamestate_II::on_event;
+
+    void on_event(const Zeni_Input_ID &, const float &, const int &action) {
+      if(action)
+        ++actions;
+    }
+
+    size_t actions;
+  };
+
+  /// 'input_benchmark' times key events through a Key_Table and a Gamestate_II with bound actions
+  struct Console_Input_Benchmark : public Console_Function {
+    void operator()(Console_State &console,
+                    const String &,
+                    const std::vector<String> &)
+    {
+      const int keys[] = {SDLK_w, SDLK_a, SDLK_s, SDLK_d, SDLK_SPACE, SDLK_LSHIFT, SDLK_UP, SDLK_DOWN, SDLK_LEFT, SDLK_RIGHT, SDLK_F1, SDLK_RETURN};
+      const int num_keys = int(sizeof(keys) / sizeof(*keys));
+      const size_t events = 1u << 20;
+
+      Console_Input_Benchmark_State state;
+      for(int i = 0; i != num_keys; ++i)
+        state.set_action(Zeni_Input_ID(SDL_KEYDOWN, keys[i]), i + 1);
+
+      Key_Table table;
+      size_t modifiers = 0u;
+
+      SDL_Event event;
+      memset(&event, 0, sizeof(event));
+
+      const Time_HQ start = get_Timer_HQ().get_time();
+      for(size_t i = 0u; i != events; ++i) {
+        // Press and release every key in turn, as Game::run and Game::on_event would
+        const bool down = !(i & 1u);
+        event.type = down ? SDL_KEYDOWN : SDL_KEYUP;
+        event.key.state = Uint8(down ? SDL_PRESSED : SDL_RELEASED);
+        event.key.keysym.sym = keys[(i >> 1) % num_keys];
+
+        if(table.get(SDLK_LALT) || table.get(SDLK_RALT) || table.get(SDLK_LCTRL) || table.get(SDLK_RCTRL) ||
+           table.get(SDLK_LSHIFT) || table.get(SDLK_RSHIFT) || table.get(SDLK_LGUI) || table.get(SDLK_RGUI))
+        {
+          ++modifiers;
+        }
+
+        table.set(event.key.keysym.sym, down);
+        state.on_event(event);
+      }
+      const double seconds = double(get_Timer_HQ().get_time().get_seconds_since(start));
+
+      std::ostringstream oss;
+      oss << std::fixed << std::setprecision(1) << events << " key events: "
+          << 1000000000.0 * seconds / events << " ns per event, "
+          << state.actions << " actions, " << modifiers << " with modifiers";
+      console.write_to_log(oss.str().c_str());
+    }
+  };
+#endif
+
+#ifdef ENABLE_COLLISION_STATISTICS
+  /// 'collision_statistics' logs the last frame's Collision::Statistics; 'collision_statistics file.csv' writes them out instead
+  struct Console_Collision_Statistics : public Console_Function {
+    void operator()(Console_State &console,
+                    const String &,
+                    const std::vector<String> &args)
+    {
+      const Collision::Statistics &statistics = Collision::Statistics::get_last_frame();
+
+      if(args.empty()) {
+        console.write_to_log(statistics.to_string());
+        return;
+      }
+
+      std::ofstream csv(args[0].c_str());
+      statistics.write_csv(csv);
+
+      if(csv)
+        console.write_to_log("Wrote '" + args[0] + "'");
+      else
+        console.write_to_log("Failed to write '" + args[0] + "'");
+    }
+  };
+#endif
+
+#ifdef ENABLE_PROFILER
+  /// 'profile' logs the last frame's Profiler scopes
+  struct Console_Profile : public Console_Function {
+    void operator()(Console_State &console,
+                    const String &,
+                    const std::vector<String> &)
+    {
+      console.write_to_log(Profiler::to_string());
+    }
+  };
+
+  /// 'profile_capture' starts capturing from all threads; 'profile_capture file.json' stops and writes a Chrome trace
+  struct Console_Profile_Capture : public Console_Function {
+    void operator()(Console_State &console,
+                    const String &,
+                    const std::vector<String> &args)
+    {
+      if(args.empty()) {
+        Profiler::start_capture();
+        console.write_to_log("Capturing");
+        return;
+      }
+
+      if(!Profiler::is_capturing()) {
+        console.write_to_log("Not capturing");
+        return;
+      }
+
+      Profiler::stop_capture();
+
+      std::ofstream json(args[0].c_str());
+      Profiler::write_chrome_trace(json);
+
+      if(json)
+        console.write_to_log("Wrote " + ulltoa(Profiler::get_num_captured()) + " events to '" + args[0] + "' (" + ulltoa(Profiler::get_num_dropped()) + " dropped)");
+      else
+        console.write_to_log("Failed to write '" + args[0] + "'");
+    }
+  };
+#endif
+
   Console_State::Console_State()
     : m_virtual_screen(Point2f(0.0f, 0.0f), Point2f(float(get_Window().get_width() * 600.0f / get_Window().get_height()), 600.0f)),
     m_projector(m_virtual_screen),
@@ -49,6 +556,21 @@ namespace Zeni {
     m_child(0)
   {
     m_functions["args"] = new Console_Function;
+#ifdef ENABLE_BENCHMARKS
+    m_functions["allocation_statistics"] = new Console_Allocation_Statistics;
+    m_functions["job_scaling"] = new Console_Job_Scaling;
+    m_functions["event_benchmark"] = new Console_Event_Benchmark;
+    m_functions["input_benchmark"] = new Console_Input_Benchmark;
+    m_functions["serialization_benchmark"] = new Console_Serialization_Benchmark;
+    m_functions["matrix_benchmark"] = new Console_Matrix_Benchmark;
+#endif
+#ifdef ENABLE_COLLISION_STATISTICS
+    m_functions["collision_statistics"] = new Console_Collision_Statistics;
+#endif
+#ifdef ENABLE_PROFILER
+    m_functions["profile"] = new Console_Profile;
+    m_functions["profile_capture"] = new Console_Profile_Capture;
+#endif
 
     m_log.give_BG_Renderer(new Widget_Renderer_Color(get_Colors()["console_background"]));
     m_prompt.give_BG_Renderer(new Widget_Renderer_Color(get_Colors()["console_background"]));
@@ -296,3 +818,5 @@ namespace Zeni {
   }
 
 }
+
+#include <Zeni/Undefine.h>
@@ -17,6 +17,10 @@
 
 #include <zeni_rest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
 #include <Zeni/Define.h>
 
 #if defined(_DEBUG) && defined(_WINDOWS)
@@ -39,11 +43,25 @@ namespace Zeni {
 
   Game::Game()
     : time(get_Timer().get_time()),
-    ticks_passed(0),
     fps(END_OF_TIME),
-    fps_next(0),
+    m_frame_end(time),
+    m_frame_time(0.0),
+    m_frame_time_p50(0.0),
+    m_frame_time_p99(0.0),
+    m_frame_time_max(0.0),
+    m_target_fps(0.0),
+    m_background_fps(30.0),
+    m_fixed_time_step(0.0),
+    m_max_logic_steps(1u),
+    m_time_accumulated(0.0),
+    m_time_step(0.0),
+    m_interpolation(1.0f),
+    m_logic_steps(0u),
     m_popup_menu_state_factory(new Popup_Menu_State_Factory),
     m_popup_pause_state_factory(new Popup_Pause_State_Factory)
+#ifndef ANDROID
+    , m_recording(0)
+#endif
 #if !defined(ANDROID) && !defined(NDEBUG)
     , m_console_active(false)
 #endif
@@ -51,6 +69,10 @@ namespace Zeni {
   }
 
   Game::~Game() {
+#ifndef ANDROID
+    stop_recording();
+#endif
+
     delete m_popup_menu_state_factory;
     delete m_popup_pause_state_factory;
   }
@@ -119,26 +141,40 @@ namespace Zeni {
 
 #ifdef ANDROID
   void Game::on_event(android_app &app, const AInputEvent &event) {
+    ZENI_PROFILE_SCOPE("Game::on_event");
 #else
   void Game::on_event(const SDL_Event &event) {
+    ZENI_PROFILE_SCOPE("Game::on_event");
+
+    if(m_recording)
+      Input_Recording::serialize_event(*m_recording, event);
+
     SDL_Event event2;
     memcpy(&event2, &event, sizeof(SDL_Event));
 
     switch(event.type) {
       case SDL_KEYDOWN:
-        m_keys[event.key.keysym.sym] = true;
+        if(!m_keys.get(event.key.keysym.sym))
+          m_keys_pressed.set(event.key.keysym.sym, true);
+        m_keys.set(event.key.keysym.sym, true);
         break;
 
       case SDL_KEYUP:
-        m_keys[event.key.keysym.sym] = false;
+        if(m_keys.get(event.key.keysym.sym))
+          m_keys_released.set(event.key.keysym.sym, true);
+        m_keys.set(event.key.keysym.sym, false);
         break;
 
       case SDL_MOUSEBUTTONDOWN:
-        m_mouse_buttons[event.button.button] = true;
+        if(!m_mouse_buttons.get(event.button.button))
+          m_mouse_buttons_pressed.set(event.button.button, true);
+        m_mouse_buttons.set(event.button.button, true);
         break;
 
       case SDL_MOUSEBUTTONUP:
-        m_mouse_buttons[event.button.button] = false;
+        if(m_mouse_buttons.get(event.button.button))
+          m_mouse_buttons_released.set(event.button.button, true);
+        m_mouse_buttons.set(event.button.button, false);
         break;
 
       case SDL_CONTROLLERAXISMOTION:
@@ -208,6 +244,8 @@ namespace Zeni {
   }
 
   void Game::perform_logic() {
+    ZENI_PROFILE_SCOPE("Game::perform_logic");
+
     Gamestate gs;
 #if !defined(ANDROID) && !defined(NDEBUG)
     Gamestate console_child;
@@ -233,6 +271,8 @@ namespace Zeni {
   }
 
   void Game::prerender() {
+    ZENI_PROFILE_SCOPE("Game::prerender");
+
     Gamestate gs;
 #if !defined(ANDROID) && !defined(NDEBUG)
     Gamestate console_child;
@@ -258,6 +298,8 @@ namespace Zeni {
   }
 
   void Game::render() {
+    ZENI_PROFILE_SCOPE("Game::render");
+
     Gamestate gs;
 #if !defined(ANDROID) && !defined(NDEBUG)
     Gamestate console_child;
@@ -284,18 +326,28 @@ namespace Zeni {
     calculate_fps();
   }
 
-  bool Game::get_key_state(const int &button) const {
-    const Unordered_Map<int, bool>::const_iterator it = m_keys.find(button);
-    if(it != m_keys.end())
-      return it->second;
-    return false;
+  bool Game::get_key_state(const int &key) const {
+    return m_keys.get(key);
   }
 
   bool Game::get_mouse_button_state(const int &button) const {
-    const Unordered_Map<int, bool>::const_iterator it = m_mouse_buttons.find(button);
-    if(it != m_mouse_buttons.end())
-      return it->second;
-    return false;
+    return m_mouse_buttons.get(button);
+  }
+
+  bool Game::was_key_pressed(const int &key) const {
+    return m_keys_pressed.get(key);
+  }
+
+  bool Game::was_key_released(const int &key) const {
+    return m_keys_released.get(key);
+  }
+
+  bool Game::was_mouse_button_pressed(const int &button) const {
+    return m_mouse_buttons_pressed.get(button);
+  }
+
+  bool Game::was_mouse_button_released(const int &button) const {
+    return m_mouse_buttons_released.get(button);
   }
   
   Sint16 Game::get_controller_axis_state(const int &which, const SDL_GameControllerAxis &axis) const {
@@ -334,10 +386,13 @@ namespace Zeni {
 
     for(;;) {
       const Time time_passed;
-      float time_step = time_passed.get_seconds_since(time_processed);
+      const double time_step = time_passed.get_seconds_since(time_processed);
       time_processed = time_passed;
 
 #ifndef ANDROID
+      if(m_recording)
+        Input_Recording::serialize_frame(*m_recording, time_step);
+
       if(controller_mouse.enabled && (controller_mouse.velocity.x != 0 || controller_mouse.velocity.y != 0)) {
         Point2f adjusted_vel(controller_mouse.velocity.x + 0.5f, controller_mouse.velocity.y + 0.5f);
         if(adjusted_vel.x < 0.0f)
@@ -493,55 +548,174 @@ namespace Zeni {
 
 #ifdef TEST_NASTY_CONDITIONS
       {
+        // Scaled time, at most NASTY_RATE_CUTOFF sixtieths of a second per frame
         const Time current_time;
         const Time::Second_Type time_passed = time_scale * current_time.get_seconds_since(start_time);
-        size_t step_count = 0u;
-        while(time_used + (1 / 60.0f) < time_passed) {
-          time_used += (1 / 60.0f);
+        step_logic(std::min(time_passed - time_used, Time::Second_Type(NASTY_RATE_CUTOFF / 60.0)));
+        time_used = time_passed;
+
+        // And the occasional step of no time at all, which a fixed timestep never takes
+        if(!is_fixed_timestep() && !random.rand_lt(NASTY_ZERO_STEP_FREQUENCY)) {
+          m_time_step = 0.0;
+          ++m_logic_steps;
           perform_logic();
-          if(++step_count == NASTY_RATE_CUTOFF)
-            time_used = time_passed;
         }
-        if(!random.rand_lt(NASTY_ZERO_STEP_FREQUENCY))
-          perform_logic();
       }
 #else
+      step_logic(time_step);
+#endif
+
+      {
+        ZENI_PROFILE_SCOPE("Game::update_sound");
+
+        get_Sound().update();
+        get_Sound_Source_Pool().update();
+      }
+
+      if(Job_System::is_initialized())
+        get_Job_System().run_main_thread_jobs();
+
+      render_frame();
+
+      m_frame_limiter.wait(get_fps_limit());
+
+      end_frame();
+    }
+  }
+
+  void Game::step_logic(const double &time_step) {
+    if(is_fixed_timestep()) {
+      m_time_step = m_fixed_time_step;
+      m_time_accumulated += time_step;
+
+      for(m_logic_steps = 0u; m_time_accumulated >= m_fixed_time_step; ++m_logic_steps) {
+        if(m_logic_steps == m_max_logic_steps) {
+          m_time_accumulated = std::fmod(m_time_accumulated, m_fixed_time_step);
+          break;
+        }
+
+        m_time_accumulated -= m_fixed_time_step;
+        perform_logic();
+      }
+
+      m_interpolation = float(m_time_accumulated / m_fixed_time_step);
+    }
+    else {
+      m_time_step = time_step;
+      m_logic_steps = 1u;
       perform_logic();
+    }
+  }
+
+#ifndef ANDROID
+  void Game::start_recording(const String &filename) {
+    stop_recording();
+
+    std::ofstream * const file = new std::ofstream(filename.c_str(), std::ios::binary);
+    if(!*file || !Input_Recording::serialize_header(*file)) {
+      delete file;
+      throw Input_Recording_Error("Input recording '" + filename + "' could not be written");
+    }
+
+    m_recording = file;
+  }
+
+  void Game::stop_recording() {
+    delete m_recording;
+    m_recording = 0;
+  }
+#endif
+
+  bool Game::records_render_commands() {
+    if(m_states.empty())
+      throw Zero_Gamestate();
+
+#if !defined(ANDROID) && !defined(NDEBUG)
+    if(m_console_active)
+      return get_console_instance().records_render_commands();
 #endif
 
-      get_Sound().update();
-      get_Sound_Source_Pool().update();
+    return m_states.top().records_render_commands();
+  }
+
+  void Game::render_frame() {
+    if(!Window::is_enabled())
+      return;
+
+    if(!Render_Thread::is_initialized()) {
+      render_directly();
+      return;
+    }
+
+    Render_Thread &rt = get_Render_Thread();
+
+    if(records_render_commands()) {
+      // Gamestates record Render_Commands for the render thread to replay
+      prerender();
+      render();
+
+      rt.submit();
+      return;
+    }
 
-      if(Window::is_enabled()) {
-        Video &vr = get_Video();
+    rt.begin_direct();
+
+    try {
+      render_directly();
+    }
+    catch(...) {
+      rt.end_direct();
+      throw;
+    }
+
+    rt.end_direct();
+  }
+
+  void Game::render_directly() {
+    Video &vr = get_Video();
 
 #ifndef DISABLE_DX9
-        try
+    try
 #endif
-        {
-          if(vr.begin_prerender()) {
-            prerender();
-
-            if(vr.begin_render()) {
-              try {
-                render();
-              }
-              catch(...) {
-                vr.end_render();
-                throw;
-              }
-
-              vr.end_render();
-            }
+    {
+      if(vr.begin_prerender()) {
+        prerender();
+
+        if(vr.begin_render()) {
+          try {
+            render();
           }
+          catch(...) {
+            vr.end_render();
+            throw;
+          }
+
+          vr.end_render();
         }
-#ifndef DISABLE_DX9
-        catch(Video_Device_Failure &) {
-          Video::destroy();
-        }
-#endif
       }
     }
+#ifndef DISABLE_DX9
+    catch(Video_Device_Failure &) {
+      Video::destroy();
+    }
+#endif
+  }
+
+  void Game::end_frame() {
+    m_keys_pressed.clear();
+    m_keys_released.clear();
+    m_mouse_buttons_pressed.clear();
+    m_mouse_buttons_released.clear();
+
+    Allocation_Statistics::end_frame();
+
+#ifdef ENABLE_COLLISION_STATISTICS
+    Collision::Statistics::end_frame();
+#endif
+
+#ifdef ENABLE_PROFILER
+    Profiler::end_frame();
+#endif
   }
 
   void Game::push_Popup_Menu_State() {
@@ -564,14 +738,56 @@ namespace Zeni {
     m_popup_pause_state_factory = popup_pause_state_factory;
   }
 
+  void Game::set_fixed_timestep(const float &logic_hz, const size_t &max_logic_steps) {
+    assert(logic_hz > 0.0f);
+    assert(max_logic_steps > 0u);
+
+    m_fixed_time_step = 1.0 / logic_hz;
+    m_max_logic_steps = max_logic_steps;
+    m_time_accumulated = 0.0;
+    m_interpolation = 0.0f;
+  }
+
+  void Game::set_variable_timestep() {
+    m_fixed_time_step = 0.0;
+    m_max_logic_steps = 1u;
+    m_time_accumulated = 0.0;
+    m_interpolation = 1.0f;
+  }
+
+  double Game::get_fps_limit() const {
+#ifndef ANDROID
+    if(m_background_fps > 0.0 && Window::is_enabled() && Window::is_initialized()) {
+      const Window &wr = get_Window();
+
+      if(wr.is_minimized() || !wr.has_focus())
+        return m_target_fps > 0.0 && m_target_fps < m_background_fps ? m_target_fps : m_background_fps;
+    }
+#endif
+
+    return m_target_fps;
+  }
+
   void Game::calculate_fps() {
-    ++fps_next;
-    const Time::Tick_Type tp = time.get_ticks_passed();
-    if(tp < ticks_passed)
+    const Time current_time;
+    m_frame_time = current_time.get_seconds_since(m_frame_end);
+    m_frame_end = current_time;
+    m_frame_times.push_back(m_frame_time);
+
+    const double seconds = current_time.get_seconds_since(time);
+    if(seconds < 1.0)
       return;
-    ticks_passed = tp + 1000;
-    fps = fps_next;
-    fps_next = 0;
+    time = current_time;
+
+    fps = size_t(m_frame_times.size() / seconds + 0.5);
+
+    // Nearest-rank percentiles over the frames of the last second
+    std::sort(m_frame_times.begin(), m_frame_times.end());
+    const size_t count = m_frame_times.size();
+    m_frame_time_p50 = m_frame_times[(count * 50u + 99u) / 100u - 1u];
+    m_frame_time_p99 = m_frame_times[(count * 99u + 99u) / 100u - 1u];
+    m_frame_time_max = m_frame_times[count - 1u];
+    m_frame_times.clear();
   }
 
 #if !defined(ANDROID) && !defined(NDEBUG)
@@ -45,6 +45,18 @@ namespace Zeni {
            (subid == rhs.subid && which < rhs.which)));
   }
 
+#ifndef ANDROID
+  // Each range of slots starts where the one before it ends
+  static const size_t g_ii_key_slots = 0u;
+  static const size_t g_ii_mouse_button_slots = g_ii_key_slots + Key_Table::DENSE_SIZE;
+  static const size_t g_ii_mouse_motion_slots = g_ii_mouse_button_slots + 256u;
+  static const size_t g_ii_controller_button_slots = g_ii_mouse_motion_slots + 2u;
+  static const size_t g_ii_controller_axis_slots = g_ii_controller_button_slots + ZENI_II_DENSE_CONTROLLERS * SDL_CONTROLLER_BUTTON_MAX;
+  static const size_t g_ii_slots = g_ii_controller_axis_slots + ZENI_II_DENSE_CONTROLLERS * SDL_CONTROLLER_AXIS_MAX;
+#else
+  static const size_t g_ii_slots = 0u;
+#endif
+
   Gamestate_II::Gamestate_II()
     : m_joyball_min(ZENI_DEFAULT_II_JOYBALL_MIN),
     m_joyball_max(ZENI_DEFAULT_II_JOYBALL_MAX),
@@ -132,10 +144,8 @@ namespace Zeni {
   }
 
   int Gamestate_II::get_action(const Zeni_Input_ID &event) {
-    std::map<Zeni_Input_ID, int>::const_iterator it = m_ii.find(event);
-    if(it != m_ii.end())
-      return it->second;
-    return 0;
+    const Binding * const binding = find_binding(event);
+    return binding ? binding->action : 0;
   }
 
   Zeni_Input_ID Gamestate_II::get_event(const int &action) {
@@ -146,46 +156,112 @@ namespace Zeni {
   }
 
   void Gamestate_II::set_action(const Zeni_Input_ID &event, const int &action) {
-    m_ii[event] = action;
     m_rii[action] = event;
+
+    Binding * const binding = find_binding(event);
+    if(binding) {
+      binding->action = action;
+      return;
+    }
+
+    const Binding added = {event, action};
+    m_bindings.push_back(added);
+
+    const size_t slot = get_slot(event);
+    if(slot != g_ii_slots) {
+      assert(slot < g_ii_slots);
+      if(m_slots.empty())
+        m_slots.resize(g_ii_slots, 0u);
+      m_slots[slot] = m_bindings.size();
+    }
+    else
+      m_unslotted[event] = m_bindings.size() - 1u;
+  }
+
+  size_t Gamestate_II::get_slot(const Zeni_Input_ID &id) {
+#ifndef ANDROID
+    switch(id.type) {
+    case SDL_KEYDOWN:
+      {
+        const int index = Key_Table::index(id.subid);
+        if(index != Key_Table::DENSE_SIZE && !id.which)
+          return g_ii_key_slots + size_t(index);
+      }
+      break;
+    case SDL_MOUSEBUTTONDOWN:
+      if(id.subid >= 0 && id.subid < 256 && !id.which)
+        return g_ii_mouse_button_slots + size_t(id.subid);
+      break;
+    case SDL_MOUSEMOTION:
+      if(id.subid >= 0 && id.subid < 2 && !id.which)
+        return g_ii_mouse_motion_slots + size_t(id.subid);
+      break;
+    case SDL_CONTROLLERBUTTONDOWN:
+      if(id.subid >= 0 && id.subid < SDL_CONTROLLER_BUTTON_MAX && id.which >= 0 && id.which < ZENI_II_DENSE_CONTROLLERS)
+        return g_ii_controller_button_slots + size_t(id.which * SDL_CONTROLLER_BUTTON_MAX + id.subid);
+      break;
+    case SDL_CONTROLLERAXISMOTION:
+      if(id.subid >= 0 && id.subid < SDL_CONTROLLER_AXIS_MAX && id.which >= 0 && id.which < ZENI_II_DENSE_CONTROLLERS)
+        return g_ii_controller_axis_slots + size_t(id.which * SDL_CONTROLLER_AXIS_MAX + id.subid);
+      break;
+    default:
+      break;
+    }
+#endif
+
+    return g_ii_slots;
+  }
+
+  Gamestate_II::Binding * Gamestate_II::find_binding(const Zeni_Input_ID &id) {
+    const size_t slot = get_slot(id);
+
+    if(slot != g_ii_slots) {
+      assert(slot < g_ii_slots);
+      if(m_slots.empty() || !m_slots[slot])
+        return 0;
+      return &m_bindings[m_slots[slot] - 1u];
+    }
+
+    const std::map<Zeni_Input_ID, size_t>::const_iterator it = m_unslotted.find(id);
+    return it != m_unslotted.end() ? &m_bindings[it->second] : 0;
   }
 
   void Gamestate_II::fire_missed_events() {
     Game &gr = get_Game();
 
-    for(std::map<Zeni_Input_ID, int>::iterator it = m_ii.begin(), iend = m_ii.end(); it != iend; ++it) {
-      switch(it->first.type) {
+    for(std::vector<Binding>::iterator it = m_bindings.begin(), iend = m_bindings.end(); it != iend; ++it) {
+      switch(it->id.type) {
 #ifndef ANDROID
       case SDL_KEYDOWN:
         {
-          const float confidence = gr.get_key_state(it->first.subid) ? 1.0f : 0.0f;
+          const float confidence = gr.get_key_state(it->id.subid) ? 1.0f : 0.0f;
 
-          if(m_firing_missed_events && it->first.previous_confidence != confidence)
-            on_event(it->first, confidence, it->second);
+          if(m_firing_missed_events && it->id.previous_confidence != confidence)
+            on_event(it->id, confidence, it->action);
 
-          it->first.previous_confidence = confidence;
+          it->id.previous_confidence = confidence;
         }
         break;
 
       case SDL_MOUSEBUTTONDOWN:
         {
-          const float confidence = gr.get_mouse_button_state(it->first.subid) ? 1.0f : 0.0f;
+          const float confidence = gr.get_mouse_button_state(it->id.subid) ? 1.0f : 0.0f;
 
-          if(m_firing_missed_events && it->first.previous_confidence != confidence)
-            on_event(it->first, confidence, it->second);
+          if(m_firing_missed_events && it->id.previous_confidence != confidence)
+            on_event(it->id, confidence, it->action);
 
-          it->first.previous_confidence = confidence;
+          it->id.previous_confidence = confidence;
         }
         break;
 
       case SDL_CONTROLLERBUTTONDOWN:
         {
-          const float confidence = gr.get_controller_button_state(it->first.which, SDL_GameControllerButton(it->first.subid)) ? 1.0f : 0.0f;
+          const float confidence = gr.get_controller_button_state(it->id.which, SDL_GameControllerButton(it->id.subid)) ? 1.0f : 0.0f;
 
-          if(m_firing_missed_events && it->first.previous_confidence != confidence)
-            on_event(it->first, confidence, it->second);
+          if(m_firing_missed_events && it->id.previous_confidence != confidence)
+            on_event(it->id, confidence, it->action);
 
-          it->first.previous_confidence = confidence;
+          it->id.previous_confidence = confidence;
         }
         break;
 #endif
@@ -197,12 +273,12 @@ namespace Zeni {
   }
 
   void Gamestate_II::fire_event(const Zeni_Input_ID &id, const float &confidence) {
-    std::map<Zeni_Input_ID, int>::iterator it = m_ii.find(id);
-    if(it != m_ii.end()) {
-      float &pc = it->first.previous_confidence;
+    Binding * const binding = find_binding(id);
+    if(binding) {
+      float &pc = binding->id.previous_confidence;
       if(pc != confidence) {
         pc = confidence;
-        on_event(id, confidence, it->second);
+        on_event(id, confidence, binding->action);
       }
     }
     else
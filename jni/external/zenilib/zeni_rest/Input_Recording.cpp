@@ -0,0 +1,341 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zeni_rest.h>
+
+#ifndef ANDROID
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if defined(_DEBUG) && defined(_WINDOWS)
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+
+namespace Zeni {
+
+  static const char g_input_recording_magic[4] = {'Z', 'R', 'E', 'C'};
+  static const Uint16 g_input_recording_version = 1u;
+
+  /// Whether serialize_event() writes events of this type; The rest carry pointers or nothing a Gamestate replays
+  static bool input_recording_encodes(const Uint32 &type) {
+    switch(type) {
+      case SDL_KEYDOWN:
+      case SDL_KEYUP:
+      case SDL_TEXTINPUT:
+      case SDL_MOUSEMOTION:
+      case SDL_MOUSEBUTTONDOWN:
+      case SDL_MOUSEBUTTONUP:
+      case SDL_MOUSEWHEEL:
+      case SDL_CONTROLLERAXISMOTION:
+      case SDL_CONTROLLERBUTTONDOWN:
+      case SDL_CONTROLLERBUTTONUP:
+      case SDL_CONTROLLERDEVICEADDED:
+      case SDL_CONTROLLERDEVICEREMOVED:
+      case SDL_CONTROLLERDEVICEREMAPPED:
+      case SDL_WINDOWEVENT:
+      case SDL_QUIT:
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+  struct Recorded_Event_Order {
+    bool operator()(const Input_Recording::Recorded_Event &lhs, const Input_Recording::Recorded_Event &rhs) const {
+      return lhs.frame < rhs.frame;
+    }
+  };
+
+  void Input_Recording::add_frame(const double &time_step) {
+    m_time_steps.push_back(time_step);
+  }
+
+  void Input_Recording::add_event(const size_t &frame, const SDL_Event &event) {
+    Recorded_Event recorded;
+    recorded.frame = frame;
+    recorded.event = event;
+
+    m_events.insert(std::upper_bound(m_events.begin(), m_events.end(), recorded, Recorded_Event_Order()), recorded);
+  }
+
+  void Input_Recording::clear() {
+    m_time_steps.clear();
+    m_events.clear();
+  }
+
+  std::ostream & Input_Recording::serialize(std::ostream &os) const {
+    serialize_header(os);
+
+    std::vector<Recorded_Event>::const_iterator it = m_events.begin();
+    for(size_t frame = 0u; frame != m_time_steps.size(); ++frame) {
+      serialize_frame(os, m_time_steps[frame]);
+
+      for(; it != m_events.end() && it->frame <= frame; ++it)
+        serialize_event(os, it->event);
+    }
+
+    // Events past the last frame stay with it
+    for(; it != m_events.end(); ++it)
+      serialize_event(os, it->event);
+
+    return os;
+  }
+
+  std::istream & Input_Recording::unserialize(std::istream &is) {
+    clear();
+
+    char magic[4];
+    Uint16 version;
+    if(!is.read(magic, 4) || memcmp(magic, g_input_recording_magic, 4) ||
+       !Zeni::unserialize(is, version) || version != g_input_recording_version)
+    {
+      is.setstate(std::ios::failbit);
+      return is;
+    }
+
+    for(char tag; is.get(tag);) {
+      if(tag == 'F') {
+        Uint32 useconds;
+        if(!Zeni::unserialize(is, useconds))
+          return is;
+
+        add_frame(useconds * 0.000001);
+      }
+      else if(tag == 'E') {
+        SDL_Event event;
+        memset(&event, 0, sizeof(event));
+
+        if(!Zeni::unserialize(is, event.common.type) || !Zeni::unserialize(is, event.common.timestamp))
+          return is;
+
+        switch(event.type) {
+          case SDL_KEYDOWN:
+          case SDL_KEYUP:
+            {
+              Uint16 scancode;
+              Zeni::unserialize(is, event.key.state);
+              Zeni::unserialize(is, event.key.repeat);
+              Zeni::unserialize(is, scancode);
+              Zeni::unserialize(is, event.key.keysym.sym);
+              Zeni::unserialize(is, event.key.keysym.mod);
+              event.key.keysym.scancode = SDL_Scancode(scancode);
+            }
+            break;
+
+          case SDL_TEXTINPUT:
+            {
+              String text;
+              Zeni::unserialize(is, event.text.windowID);
+              Zeni::unserialize(is, text);
+              memcpy(event.text.text, text.c_str(), std::min(text.size(), sizeof(event.text.text) - 1u));
+            }
+            break;
+
+          case SDL_MOUSEMOTION:
+            Zeni::unserialize(is, event.motion.which);
+            Zeni::unserialize(is, event.motion.state);
+            Zeni::unserialize(is, event.motion.x);
+            Zeni::unserialize(is, event.motion.y);
+            Zeni::unserialize(is, event.motion.xrel);
+            Zeni::unserialize(is, event.motion.yrel);
+            break;
+
+          case SDL_MOUSEBUTTONDOWN:
+          case SDL_MOUSEBUTTONUP:
+            Zeni::unserialize(is, event.button.which);
+            Zeni::unserialize(is, event.button.button);
+            Zeni::unserialize(is, event.button.state);
+            Zeni::unserialize(is, event.button.clicks);
+            Zeni::unserialize(is, event.button.x);
+            Zeni::unserialize(is, event.button.y);
+            break;
+
+          case SDL_MOUSEWHEEL:
+            Zeni::unserialize(is, event.wheel.which);
+            Zeni::unserialize(is, event.wheel.x);
+            Zeni::unserialize(is, event.wheel.y);
+            break;
+
+          case SDL_CONTROLLERAXISMOTION:
+            Zeni::unserialize(is, event.caxis.which);
+            Zeni::unserialize(is, event.caxis.axis);
+            Zeni::unserialize(is, event.caxis.value);
+            break;
+
+          case SDL_CONTROLLERBUTTONDOWN:
+          case SDL_CONTROLLERBUTTONUP:
+            Zeni::unserialize(is, event.cbutton.which);
+            Zeni::unserialize(is, event.cbutton.button);
+            Zeni::unserialize(is, event.cbutton.state);
+            break;
+
+          case SDL_CONTROLLERDEVICEADDED:
+          case SDL_CONTROLLERDEVICEREMOVED:
+          case SDL_CONTROLLERDEVICEREMAPPED:
+            Zeni::unserialize(is, event.cdevice.which);
+            break;
+
+          case SDL_WINDOWEVENT:
+            Zeni::unserialize(is, event.window.windowID);
+            Zeni::unserialize(is, event.window.event);
+            Zeni::unserialize(is, event.window.data1);
+            Zeni::unserialize(is, event.window.data2);
+            break;
+
+          case SDL_QUIT:
+            break;
+
+          default:
+            is.setstate(std::ios::failbit);
+            break;
+        }
+
+        if(!is)
+          return is;
+
+        add_event(m_time_steps.empty() ? 0u : m_time_steps.size() - 1u, event);
+      }
+      else {
+        is.setstate(std::ios::failbit);
+        return is;
+      }
+    }
+
+    // Running out of tags is the expected end
+    if(is.eof() && !is.bad())
+      is.clear(std::ios::eofbit);
+
+    return is;
+  }
+
+  void Input_Recording::load(const String &filename) {
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    if(!file)
+      throw Input_Recording_Error("Input recording '" + filename + "' could not be opened");
+
+    if(!unserialize(file))
+      throw Input_Recording_Error("Input recording '" + filename + "' is invalid");
+  }
+
+  void Input_Recording::save(const String &filename) const {
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    if(!file || !serialize(file))
+      throw Input_Recording_Error("Input recording '" + filename + "' could not be written");
+  }
+
+  std::ostream & Input_Recording::serialize_header(std::ostream &os) {
+    os.write(g_input_recording_magic, 4);
+    return Zeni::serialize(os, g_input_recording_version);
+  }
+
+  std::ostream & Input_Recording::serialize_frame(std::ostream &os, const double &time_step) {
+    const double useconds = time_step > 0.0 ? std::floor(time_step * 1000000.0 + 0.5) : 0.0;
+
+    os.put('F');
+    return Zeni::serialize(os, Uint32(useconds < 4294967295.0 ? useconds : 4294967295.0));
+  }
+
+  std::ostream & Input_Recording::serialize_event(std::ostream &os, const SDL_Event &event) {
+    if(!input_recording_encodes(event.type))
+      return os;
+
+    os.put('E');
+    Zeni::serialize(os, event.common.type);
+    Zeni::serialize(os, event.common.timestamp);
+
+    switch(event.type) {
+      case SDL_KEYDOWN:
+      case SDL_KEYUP:
+        Zeni::serialize(os, event.key.state);
+        Zeni::serialize(os, event.key.repeat);
+        Zeni::serialize(os, Uint16(event.key.keysym.scancode));
+        Zeni::serialize(os, event.key.keysym.sym);
+        Zeni::serialize(os, event.key.keysym.mod);
+        break;
+
+      case SDL_TEXTINPUT:
+        Zeni::serialize(os, event.text.windowID);
+        Zeni::serialize(os, String(event.text.text));
+        break;
+
+      case SDL_MOUSEMOTION:
+        Zeni::serialize(os, event.motion.which);
+        Zeni::serialize(os, event.motion.state);
+        Zeni::serialize(os, event.motion.x);
+        Zeni::serialize(os, event.motion.y);
+        Zeni::serialize(os, event.motion.xrel);
+        Zeni::serialize(os, event.motion.yrel);
+        break;
+
+      case SDL_MOUSEBUTTONDOWN:
+      case SDL_MOUSEBUTTONUP:
+        Zeni::serialize(os, event.button.which);
+        Zeni::serialize(os, event.button.button);
+        Zeni::serialize(os, event.button.state);
+        Zeni::serialize(os, event.button.clicks);
+        Zeni::serialize(os, event.button.x);
+        Zeni::serialize(os, event.button.y);
+        break;
+
+      case SDL_MOUSEWHEEL:
+        Zeni::serialize(os, event.wheel.which);
+        Zeni::serialize(os, event.wheel.x);
+        Zeni::serialize(os, event.wheel.y);
+        break;
+
+      case SDL_CONTROLLERAXISMOTION:
+        Zeni::serialize(os, event.caxis.which);
+        Zeni::serialize(os, event.caxis.axis);
+        Zeni::serialize(os, event.caxis.value);
+        break;
+
+      case SDL_CONTROLLERBUTTONDOWN:
+      case SDL_CONTROLLERBUTTONUP:
+        Zeni::serialize(os, event.cbutton.which);
+        Zeni::serialize(os, event.cbutton.button);
+        Zeni::serialize(os, event.cbutton.state);
+        break;
+
+      case SDL_CONTROLLERDEVICEADDED:
+      case SDL_CONTROLLERDEVICEREMOVED:
+      case SDL_CONTROLLERDEVICEREMAPPED:
+        Zeni::serialize(os, event.cdevice.which);
+        break;
+
+      case SDL_WINDOWEVENT:
+        Zeni::serialize(os, event.window.windowID);
+        Zeni::serialize(os, event.window.event);
+        Zeni::serialize(os, event.window.data1);
+        Zeni::serialize(os, event.window.data2);
+        break;
+
+      case SDL_QUIT:
+      default:
+        break;
+    }
+
+    return os;
+  }
+
+}
+
+#endif
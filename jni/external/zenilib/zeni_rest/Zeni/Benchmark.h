@@ -0,0 +1,149 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Benchmark
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Headless Benchmark Runner for Gamestates
+ *
+ * A Benchmark drives the Gamestate on top of the Game for a fixed number
+ * of frames.  Each frame delivers that frame's scripted events through
+ * Game::on_event, advances the logic by get_time_step() (or by the time
+ * step recorded for that frame), and optionally renders.  Nothing waits on
+ * the clock or polls SDL for input, so runs are repeatable and need no
+ * display unless rendering.
+ *
+ * Run any zenilib application with '--benchmark' to benchmark Gamestate
+ * Zero instead of playing it:
+ *
+ *   game --benchmark [--frames N] [--dt SECONDS] [--script FILE]
+ *                    [--replay FILE] [--output FILE] [--render]
+ *
+ * Relative paths are relative to the assets directory.  Without
+ * '--render', the Window is disabled.  Results are written as JSON.
+ *
+ * A script has one event per line, and '#' starts a comment:
+ *
+ *   FRAME key_down KEY_NAME
+ *   FRAME key_up KEY_NAME
+ *   FRAME mouse_motion X Y [XREL YREL]
+ *   FRAME mouse_button_down BUTTON X Y
+ *   FRAME mouse_button_up BUTTON X Y
+ *   FRAME mouse_wheel X Y
+ *   FRAME quit
+ *
+ * Key names are those of SDL_GetKeyFromName, e.g. 'Space' or 'Left'.
+ *
+ * '--replay' loads an Input_Recording made with '--record FILE', and runs
+ * for as many frames as it holds unless '--frames' is also given.  It
+ * implies '--benchmark'.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_BENCHMARK_H
+#define ZENI_BENCHMARK_H
+
+#include <Zeni/Error.h>
+#include <Zeni/Input_Recording.h>
+#include <Zeni/String.h>
+
+#include <SDL/SDL.h>
+
+/* \cond */
+#include <iosfwd>
+#include <vector>
+/* \endcond */
+
+namespace Zeni {
+
+#ifndef ANDROID
+
+  class ZENI_REST_DLL Benchmark {
+  public:
+    struct ZENI_REST_DLL Statistics {
+      Statistics();
+      Statistics(std::vector<double> seconds); ///< Summarize a series of durations
+
+      double total;
+      double mean;
+      double min;
+      double p50;
+      double p90;
+      double p99;
+      double max;
+    };
+
+    Benchmark(const size_t &frames = 600u, const double &time_step = 1.0 / 60.0);
+
+    // Accessors
+    const size_t & get_frames() const {return m_frames;}
+    const double & get_time_step() const {return m_time_step;}
+    bool is_rendering() const {return m_render;}
+
+    // Modifiers
+    void set_frames(const size_t &frames) {m_frames = frames;}
+    void set_time_step(const double &time_step) {m_time_step = time_step;}
+    void set_render(const bool &render = true) {m_render = render;} ///< Also call prerender and render each frame; Requires the Window
+
+    // Script
+    void add_event(const size_t &frame, const SDL_Event &event); ///< Deliver an event just before the logic of the given frame
+    void load_script(const String &filename); ///< Add every event in a script file; Throws Benchmark_Script_Error
+    void load_recording(const String &filename); ///< Add every event in an Input_Recording and use its time steps and frame count; Throws Input_Recording_Error
+
+    void run(); ///< Run the Gamestate on top of the Game, stopping early on a Quit_Event
+
+    // Results
+    size_t get_frames_run() const {return m_frame_times.size();}
+    const std::vector<double> & get_frame_times() const {return m_frame_times;} ///< Get the wall-clock seconds each frame took
+    Statistics get_frame_statistics() const {return Statistics(m_frame_times);}
+    Statistics get_logic_statistics() const {return Statistics(m_logic_times);}
+    Statistics get_render_statistics() const {return Statistics(m_render_times);}
+
+    void write_json(std::ostream &os) const; ///< Write the settings, Statistics and every frame time as JSON
+
+  private:
+    size_t m_frames;
+    double m_time_step;
+    bool m_render;
+    Input_Recording m_input;
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::vector<double> m_frame_times;
+    std::vector<double> m_logic_times;
+    std::vector<double> m_render_times;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  };
+
+  struct ZENI_REST_DLL Benchmark_Script_Error : public Error {
+    Benchmark_Script_Error(const String &msg_) : Error(msg_) {}
+  };
+
+#endif
+
+}
+
+#endif
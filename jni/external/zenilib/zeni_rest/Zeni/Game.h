@@ -26,6 +26,22 @@
  * continually refers to the Game singleton to get the current 
  * Gamestate.
  *
+ * By default, perform_logic is called once per frame.  After a call to
+ * set_fixed_timestep, it is instead called as many times per frame as it
+ * takes to keep up with a fixed rate, and render can use
+ * get_interpolation() to blend between the last two logic steps.
+ *
+ * set_target_fps limits the frame rate, and the frame rate is throttled to
+ * get_background_fps() while the Window is minimized or unfocused, so an
+ * idle game does not keep a core busy.
+ *
+ * While the Render_Thread exists and the Gamestate being rendered
+ * records_render_commands(), prerender and render record a frame of
+ * Render_Commands, which the render thread replays while the next frame's
+ * logic runs.  Otherwise (e.g. while the Console_State or a popup is up),
+ * the render thread lends the context back and the frame is drawn
+ * directly.
+ *
  * \author bazald
  *
  * Contact: bazald@zenipex.com
@@ -36,6 +52,7 @@
 
 #include <Zeni/Gamestate.h>
 #include <Zeni/Hash_Map.h>
+#include <Zeni/Key_Table.h>
 #include <Zeni/Singleton.h>
 #include <Zeni/String.h>
 #include <Zeni/Timer.h>
@@ -43,12 +60,14 @@
 #include <SDL/SDL_gamecontroller.h>
 
 /* \cond */
+#include <iosfwd>
 #include <stack>
 #include <vector>
 /* \endcond */
 
 namespace Zeni {
 
+  class Benchmark;
   class Console_State;
   class Game;
   class Popup_Menu_State_Factory;
@@ -70,6 +89,9 @@ namespace Zeni {
 
   class ZENI_REST_DLL Game : public Singleton<Game> {
     friend class Singleton<Game>;
+#ifndef ANDROID
+    friend class Benchmark;
+#endif
 
     static Game * create();
 
@@ -102,13 +124,43 @@ namespace Zeni {
     void render(); ///< Called in main, calls the function by the same name in the current Gamestate.
 
     inline size_t get_fps() const; ///< Get the current approximation of the frames displayed per second.
+    inline double get_frame_time() const; ///< Get the number of seconds the most recent frame took.
+    inline double get_frame_time_p50() const; ///< Get the median frame time, in seconds, over the last second.
+    inline double get_frame_time_p99() const; ///< Get the 99th percentile frame time, in seconds, over the last second.
+    inline double get_frame_time_max() const; ///< Get the longest frame time, in seconds, over the last second.
+
+    // Timestep
+    void set_fixed_timestep(const float &logic_hz = 60.0f, const size_t &max_logic_steps = 5u); ///< Call perform_logic 'logic_hz' times per second, at most 'max_logic_steps' times per frame; Any further backlog is dropped
+    void set_variable_timestep(); ///< Call perform_logic exactly once per frame (the default)
+    inline bool is_fixed_timestep() const; ///< Check to see if perform_logic is called at a fixed rate
+    inline double get_time_step() const; ///< Get the number of seconds the current call to perform_logic should simulate
+    inline float get_interpolation() const; ///< Get how far the current frame lies between the last logic step and the next, [0, 1); Always 1 with a variable timestep
+    inline size_t get_logic_steps() const; ///< Get the number of times perform_logic was called in the most recent frame
+
+    // Frame Pacing
+    inline const double & get_target_fps() const; ///< Get the frame rate limit; 0 if unlimited
+    inline const double & get_background_fps() const; ///< Get the frame rate limit while the Window is minimized or unfocused; 0 if unthrottled
+    inline void set_target_fps(const double &target_fps = 0.0); ///< Limit the frame rate, sleeping between frames; 0 for unlimited
+    inline void set_background_fps(const double &background_fps = 30.0); ///< Limit the frame rate while the Window is minimized or unfocused; 0 for no throttling
+    inline Frame_Limiter & get_Frame_Limiter(); ///< Get the Frame_Limiter, e.g. to read its pacing jitter
     bool get_key_state(const int &key) const; ///< Get the state of a key.
     bool get_mouse_button_state(const int &button) const; ///< Get the state of a mouse button.
+    bool was_key_pressed(const int &key) const; ///< Check to see if a key went down during the current frame.
+    bool was_key_released(const int &key) const; ///< Check to see if a key went up during the current frame.
+    bool was_mouse_button_pressed(const int &button) const; ///< Check to see if a mouse button went down during the current frame.
+    bool was_mouse_button_released(const int &button) const; ///< Check to see if a mouse button went up during the current frame.
     Sint16 get_controller_axis_state(const int &which, const SDL_GameControllerAxis &axis) const; ///< Get the state of a joystick axis.
     bool get_controller_button_state(const int &which, const SDL_GameControllerButton &button) const; ///< Get the state of a joystick button.
 
     void run();
 
+#ifndef ANDROID
+    // Input Recording
+    void start_recording(const String &filename); ///< Write every event reaching on_event, and every frame's time step, to an Input_Recording file; Throws Input_Recording_Error
+    void stop_recording(); ///< Close the Input_Recording file
+    bool is_recording() const {return m_recording != 0;}
+#endif
+
     void push_Popup_Menu_State();
     void push_Popup_Pause_State();
     void replace_Popup_Menu_State_Factory(Popup_Menu_State_Factory * const popup_menu_state_factory);
@@ -144,26 +196,66 @@ namespace Zeni {
 
   private:
     void calculate_fps();
+    double get_fps_limit() const;
+    void step_logic(const double &time_step); ///< Call perform_logic for 'time_step' seconds, honoring the fixed timestep if set
+    bool records_render_commands(); ///< Check whether the Gamestate to be rendered records for the Render_Thread
+    void render_frame(); ///< Prerender and render, or record for the Render_Thread
+    void render_directly(); ///< Prerender and render between Video::begin_render and Video::end_render
+    void end_frame(); ///< Reset this frame's key and button edges, and close out per-frame statistics
 
 #ifdef _WINDOWS
 #pragma warning( push )
 #pragma warning( disable : 4251 )
 #endif
     std::stack<Gamestate> m_states;
-    Unordered_Map<int, bool> m_keys;
-    Unordered_Map<int, bool> m_mouse_buttons;
     Unordered_Map<int, Unordered_Map<int, Sint16> > m_controller_axes;
     Unordered_Map<int, Unordered_Map<int, bool> > m_controller_buttons;
 #ifdef _WINDOWS
 #pragma warning( pop )
 #endif
 
+    Key_Table m_keys;
+    Key_Table m_keys_pressed;
+    Key_Table m_keys_released;
+    Key_Table m_mouse_buttons;
+    Key_Table m_mouse_buttons_pressed;
+    Key_Table m_mouse_buttons_released;
+
     Time time;
-    Time::Tick_Type ticks_passed, fps, fps_next;
+    Time::Tick_Type fps;
+
+    Time m_frame_end;
+    double m_frame_time;
+    double m_frame_time_p50;
+    double m_frame_time_p99;
+    double m_frame_time_max;
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::vector<double> m_frame_times;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+
+    double m_target_fps;
+    double m_background_fps;
+    Frame_Limiter m_frame_limiter;
+
+    double m_fixed_time_step;
+    size_t m_max_logic_steps;
+    double m_time_accumulated;
+    double m_time_step;
+    float m_interpolation;
+    size_t m_logic_steps;
     
     Popup_Menu_State_Factory * m_popup_menu_state_factory;
     Popup_Pause_State_Factory * m_popup_pause_state_factory;
 
+#ifndef ANDROID
+    std::ostream * m_recording;
+#endif
+
 #if !defined(ANDROID) && !defined(NDEBUG)
     void activate_console();
     void deactivate_console();
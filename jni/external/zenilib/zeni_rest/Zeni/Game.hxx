@@ -42,6 +42,58 @@ namespace Zeni {
     return fps;
   }
 
+  double Game::get_frame_time() const {
+    return m_frame_time;
+  }
+
+  double Game::get_frame_time_p50() const {
+    return m_frame_time_p50;
+  }
+
+  double Game::get_frame_time_p99() const {
+    return m_frame_time_p99;
+  }
+
+  double Game::get_frame_time_max() const {
+    return m_frame_time_max;
+  }
+
+  bool Game::is_fixed_timestep() const {
+    return m_fixed_time_step > 0.0;
+  }
+
+  double Game::get_time_step() const {
+    return m_time_step;
+  }
+
+  float Game::get_interpolation() const {
+    return m_interpolation;
+  }
+
+  size_t Game::get_logic_steps() const {
+    return m_logic_steps;
+  }
+
+  const double & Game::get_target_fps() const {
+    return m_target_fps;
+  }
+
+  const double & Game::get_background_fps() const {
+    return m_background_fps;
+  }
+
+  void Game::set_target_fps(const double &target_fps) {
+    m_target_fps = target_fps;
+  }
+
+  void Game::set_background_fps(const double &background_fps) {
+    m_background_fps = background_fps;
+  }
+
+  Frame_Limiter & Game::get_Frame_Limiter() {
+    return m_frame_limiter;
+  }
+
 }
 
 #include <Zeni/Gamestate.hxx>
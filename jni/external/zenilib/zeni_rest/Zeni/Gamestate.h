@@ -103,6 +103,8 @@ namespace Zeni {
     virtual void prerender() {}
     /// Then render.  Called by Game as part of the main gameloop.
     virtual void render();
+    /// Return true if render() gives Render_Commands to the Render_Thread rather than drawing
+    virtual bool records_render_commands() const {return false;}
 
     /// Called when the Gamestate is pushed onto the stack in Game
     virtual void on_push();
@@ -183,6 +185,7 @@ namespace Zeni {
     inline void perform_logic();
     inline void prerender();
     inline void render();
+    inline bool records_render_commands() const;
 
     inline void on_push();
     inline void on_cover();
@@ -94,6 +94,10 @@ namespace Zeni {
     m_state->render();
   }
 
+  bool Gamestate::records_render_commands() const {
+    return m_state->records_render_commands();
+  }
+
   void Gamestate::on_push() {
     m_state->on_push();
   }
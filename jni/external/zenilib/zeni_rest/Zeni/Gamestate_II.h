@@ -30,6 +30,9 @@
  * use different control schemes.  If no action id has been specified for a given input, it will report an
  * action id of 0.  It is then possible to tie an action to the input or to ignore it.
  *
+ * Keys, mouse buttons and mouse axes, and the buttons and axes of the first few
+ * controllers, look up their actions in a flat table; Any other input falls back on a map.
+ *
  * \author bazald
  *
  * Contact: bazald@zenipex.com
@@ -40,6 +43,10 @@
 
 #include <Zeni/Gamestate.h>
 
+/* \cond */
+#include <vector>
+/* \endcond */
+
 namespace Zeni {
 
   struct ZENI_REST_DLL Zeni_Input_ID {
@@ -95,6 +102,14 @@ namespace Zeni {
     void fire_missed_events();
 
   private:
+    struct Binding {
+      Zeni_Input_ID id;
+      int action;
+    };
+
+    static size_t get_slot(const Zeni_Input_ID &id); ///< Get the index of an input in m_slots, or m_slots.size() if it has none
+    Binding * find_binding(const Zeni_Input_ID &id);
+
     void fire_event(const Zeni_Input_ID &id, const float &confidence);
 
     int m_joyball_min;
@@ -108,7 +123,9 @@ namespace Zeni {
 #pragma warning( push )
 #pragma warning( disable : 4251 )
 #endif
-    std::map<Zeni_Input_ID, int> m_ii;
+    std::vector<Binding> m_bindings;
+    std::vector<size_t> m_slots; ///< One past the index of each input's Binding, or 0
+    std::map<Zeni_Input_ID, size_t> m_unslotted; ///< The index of the Binding of each input without a slot
     std::map<int, Zeni_Input_ID> m_rii;
 #ifdef _WINDOWS
 #pragma warning( pop )
@@ -0,0 +1,112 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Input_Recording
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Recorded Session of Events and Time Steps
+ *
+ * Game::start_recording() streams every SDL_Event that reaches
+ * Game::on_event, along with each frame's time step, to a file as the
+ * game runs.  Benchmark::load_recording() (or '--replay FILE')
+ * plays the session back through Game::on_event with the recorded time
+ * steps in place of the clock, so the same session can be timed across
+ * builds.
+ *
+ * The file starts with "ZREC" and a version.  Each frame is then a 'F'
+ * and its time step in microseconds, followed by an 'E' and the fields
+ * that matter for each event delivered during that frame.  Events of
+ * other types, such as SDL_USEREVENT and SDL_SYSWMEVENT, carry pointers
+ * that mean nothing in another run and are left out.
+ *
+ * \note Replay is only as deterministic as the Gamestate; Anything it
+ * draws from Random or the wall clock will differ.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_INPUT_RECORDING_H
+#define ZENI_INPUT_RECORDING_H
+
+#include <Zeni/Error.h>
+#include <Zeni/String.h>
+
+#include <SDL/SDL.h>
+
+/* \cond */
+#include <iosfwd>
+#include <vector>
+/* \endcond */
+
+namespace Zeni {
+
+#ifndef ANDROID
+
+  class ZENI_REST_DLL Input_Recording {
+  public:
+    struct ZENI_REST_DLL Recorded_Event {
+      size_t frame;
+      SDL_Event event;
+    };
+
+    // Accessors
+    size_t get_num_frames() const {return m_time_steps.size();}
+    const double & get_time_step(const size_t &frame) const {return m_time_steps[frame];} ///< Get the number of seconds a frame took when it was recorded
+    const std::vector<Recorded_Event> & get_events() const {return m_events;} ///< Get every event, in order of frame, then of addition
+
+    // Modifiers
+    void add_frame(const double &time_step); ///< Start a new frame
+    void add_event(const size_t &frame, const SDL_Event &event); ///< Add an event to be delivered during the given frame, after any already added to it
+    void clear();
+
+    // Serialization
+    std::ostream & serialize(std::ostream &os) const;
+    std::istream & unserialize(std::istream &is); ///< Replace the contents with a recording; Fails the stream if it is not one
+
+    void load(const String &filename); ///< Throws Input_Recording_Error
+    void save(const String &filename) const; ///< Throws Input_Recording_Error
+
+    // Streaming, as Game records
+    static std::ostream & serialize_header(std::ostream &os);
+    static std::ostream & serialize_frame(std::ostream &os, const double &time_step);
+    static std::ostream & serialize_event(std::ostream &os, const SDL_Event &event);
+
+  private:
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::vector<double> m_time_steps;
+    std::vector<Recorded_Event> m_events;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  };
+
+  struct ZENI_REST_DLL Input_Recording_Error : public Error {
+    Input_Recording_Error(const String &msg_) : Error(msg_) {}
+  };
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+/* This file is part of the Zenipex Library (zenilib).
+ * Copyright (C) 2011 Mitchell Keith Bloch (bazald).
+ *
+ * zenilib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * zenilib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with zenilib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \class Zeni::Key_Table
+ *
+ * \ingroup zenilib
+ *
+ * \brief A Dense Set of Pressed Keys or Buttons
+ *
+ * Character keycodes and mouse buttons index a bit array directly, as do
+ * keycodes derived from scancodes (SDLK_LALT, SDLK_F1, ...) by way of
+ * their scancode.  Only keycodes for characters outside of ASCII fall
+ * back on a short list, so get() and set() are O(1) for nearly every key.
+ *
+ * Game keeps one for the current state of the keyboard and the mouse
+ * buttons, and others for the presses and releases of the current frame.
+ *
+ * \author bazald
+ *
+ * Contact: bazald@zenipex.com
+ */
+
+#ifndef ZENI_KEY_TABLE_H
+#define ZENI_KEY_TABLE_H
+
+#include <SDL/SDL_keyboard.h>
+
+/* \cond */
+#include <algorithm>
+#include <cstring>
+#include <vector>
+/* \endcond */
+
+namespace Zeni {
+
+  class ZENI_REST_DLL Key_Table {
+  public:
+    enum {DENSE_CHARACTERS = 0x80, DENSE_SIZE = DENSE_CHARACTERS + SDL_NUM_SCANCODES};
+
+    Key_Table() {
+      clear();
+    }
+
+    /// Get the dense index of a keycode or mouse button, or DENSE_SIZE if it has none
+    static int index(const int &key) {
+      if(key >= 0 && key < DENSE_CHARACTERS)
+        return key;
+      if(key & SDLK_SCANCODE_MASK) {
+        const int scancode = key & ~SDLK_SCANCODE_MASK;
+        if(scancode >= 0 && scancode < SDL_NUM_SCANCODES)
+          return DENSE_CHARACTERS + scancode;
+      }
+      return DENSE_SIZE;
+    }
+
+    bool get(const int &key) const {
+      const int i = index(key);
+      if(i != DENSE_SIZE)
+        return (m_bits[i >> 5] >> (i & 31)) & 1u;
+      return std::find(m_others.begin(), m_others.end(), key) != m_others.end();
+    }
+
+    void set(const int &key, const bool &state) {
+      const int i = index(key);
+      if(i != DENSE_SIZE) {
+        if(state)
+          m_bits[i >> 5] |= 1u << (i & 31);
+        else
+          m_bits[i >> 5] &= ~(1u << (i & 31));
+        return;
+      }
+
+      const std::vector<int>::iterator it = std::find(m_others.begin(), m_others.end(), key);
+      if(state && it == m_others.end())
+        m_others.push_back(key);
+      else if(!state && it != m_others.end())
+        m_others.erase(it);
+    }
+
+    void clear() {
+      memset(m_bits, 0, sizeof(m_bits));
+      m_others.clear();
+    }
+
+  private:
+    Uint32 m_bits[(DENSE_SIZE + 31) / 32];
+
+#ifdef _WINDOWS
+#pragma warning( push )
+#pragma warning( disable : 4251 )
+#endif
+    std::vector<int> m_others;
+#ifdef _WINDOWS
+#pragma warning( pop )
+#endif
+  };
+
+}
+
+#endif
@@ -18,6 +18,7 @@
 #include <zeni_rest.h>
 
 #include <cassert>
+#include <cstdlib>
 #include <ctime>
 #include <fstream>
 #include <iostream>
@@ -170,6 +171,50 @@ static void print_errors() {
 #endif
 }
 
+#ifndef ANDROID
+// '--benchmark' runs Gamestate Zero headless; See Zeni::Benchmark
+// '--record FILE' saves the input of a normal run for '--replay FILE', which implies '--benchmark'; See Zeni::Input_Recording
+static bool parse_benchmark(const int argc, const char * const * const argv, Zeni::Benchmark &benchmark, Zeni::String &output, Zeni::String &record) {
+  bool enabled = false;
+  Zeni::String script;
+  Zeni::String replay;
+  const char * frames = 0;
+
+  for(int i = 1; i < argc; ++i) {
+    const Zeni::String arg = argv[i];
+    const bool has_value = i + 1 < argc;
+
+    if(arg == "--benchmark")
+      enabled = true;
+    else if(arg == "--render")
+      benchmark.set_render(true);
+    else if(arg == "--frames" && has_value)
+      frames = argv[++i];
+    else if(arg == "--dt" && has_value)
+      benchmark.set_time_step(atof(argv[++i]));
+    else if(arg == "--script" && has_value)
+      script = argv[++i];
+    else if(arg == "--output" && has_value)
+      output = argv[++i];
+    else if(arg == "--record" && has_value)
+      record = argv[++i];
+    else if(arg == "--replay" && has_value) {
+      enabled = true;
+      replay = argv[++i];
+    }
+  }
+
+  if(!replay.empty())
+    benchmark.load_recording(replay);
+  if(enabled && !script.empty())
+    benchmark.load_script(script);
+  if(frames)
+    benchmark.set_frames(size_t(atol(frames)));
+
+  return enabled;
+}
+#endif
+
 inline int main2(const int argc, const char * const * const argv) {
   std::srand(static_cast<unsigned int>(std::time(0)));
 
@@ -180,6 +225,15 @@ inline int main2(const int argc, const char * const * const argv) {
     // Load config
     const bool user_config = load_config();
 
+#ifndef ANDROID
+    Zeni::Benchmark benchmark;
+    Zeni::String benchmark_output;
+    Zeni::String record;
+    const bool benchmarking = parse_benchmark(argc, argv, benchmark, benchmark_output, record);
+    if(benchmarking && !benchmark.is_rendering())
+      Zeni::Window::set_enabled(false);
+#endif
+
     // Initialize Game
     Zeni::Game &gr = Zeni::get_Game();
 
@@ -188,6 +242,24 @@ inline int main2(const int argc, const char * const * const argv) {
       if(Zeni::g_gzi)
         gr.push_state((*Zeni::g_gzi)());
 
+#ifndef ANDROID
+      if(benchmarking) {
+        benchmark.run();
+
+        if(benchmark_output.empty())
+          benchmark.write_json(std::cout);
+        else {
+          std::ofstream json(benchmark_output.c_str());
+          benchmark.write_json(json);
+        }
+
+        throw Zeni::Quit_Event();
+      }
+
+      if(!record.empty())
+        gr.start_recording(record);
+#endif
+
 #ifndef ANDROID
       // Check Rendering Options on Firstrun
       if(Zeni::Window::is_enabled()) {
@@ -17,11 +17,13 @@
 
 #include <zeni_rest.h>
 
+#include "Zeni/Benchmark.cpp"
 #include "Zeni/Configurator_Video.cpp"
 #include "Zeni/Console_State.cpp"
 #include "Zeni/Game.cpp"
 #include "Zeni/Gamestate.cpp"
 #include "Zeni/Gamestate_II.cpp"
+#include "Zeni/Input_Recording.cpp"
 #include "Zeni/Logo.cpp"
 #include "Zeni/main.cpp"
 #include "Zeni/Widget.cpp"
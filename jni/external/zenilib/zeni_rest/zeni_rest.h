@@ -29,11 +29,14 @@
 #include <zeni_audio.h>
 #include <zeni_graphics.h>
 
+#include <Zeni/Benchmark.h>
 #include <Zeni/Configurator_Video.h>
 #include <Zeni/Console_State.h>
 #include <Zeni/Game.h>
 #include <Zeni/Gamestate.h>
 #include <Zeni/Gamestate_II.h>
+#include <Zeni/Input_Recording.h>
+#include <Zeni/Key_Table.h>
 #include <Zeni/Logo.h>
 #include <Zeni/Popup_State.h>
 #include <Zeni/Title_State.h>